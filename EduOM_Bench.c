@@ -0,0 +1,2254 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_Bench.c
+ *
+ * Description :
+ *  Benchmarks of EduOM. A volume is formatted and mounted, the benchmarks
+ *  are run, and the result of each run is printed as a line of JSON.
+ *
+ *  The benchmarks are grouped as follows.
+ *   suite           : microbenchmarks of the single object operations; the
+ *                     create (near/NULL), read (partial/REMAINDER), destroy
+ *                     (middle/last slot), next/prev, and compaction are run
+ *                     on files of several object sizes, fill levels, and
+ *                     fragmentation ratios, with a cold and a warm buffer
+ *                     pool. With -o, the same runs are made with the OM_*
+ *                     functions of the storage library as a baseline.
+ *   parallel_scan   : EduOM_ParallelScan() with 1, 2, 4, ... threads
+ *   concurrent_read : random reads through the buffer front end with 1, 2,
+ *                     4, ... threads
+ *   mapped_scan     : a scan reading every object through the buffer, and
+ *                     the same scan on the volume mapped into memory
+ *   size_class      : creates and destroys of objects of mixed sizes at
+ *                     random, under PLACEMENT_DEFAULT and under
+ *                     PLACEMENT_SIZECLASS; the compactions and the unused
+ *                     bytes of the pages left are reported
+ *   compaction      : the same creates and destroys with the compactions
+ *                     done eagerly, limited by the compaction policy, and
+ *                     limited and deferred to the idle time; the latencies
+ *                     of the creates are reported
+ *   append          : creates of objects appended to an empty file with and
+ *                     without the append page of the free space map
+ *   page_format     : the same small objects with similar keys put into a
+ *                     file of each page format, v1, v2, and with a prefix;
+ *                     the pages of the files and the throughput of the
+ *                     scans and the reads are reported
+ *   fixed_length    : objects of a few fixed lengths put into a file of the
+ *                     format v1 and into a file of fixed-length objects;
+ *                     the pages and the throughput of the creates, the
+ *                     scans, and the reads are reported
+ *   update          : updates of the objects of a file keeping their length,
+ *                     and updates growing them beyond the room of their
+ *                     pages so that they are moved and left stubs; the
+ *                     throughput of the updates, of the same growth done by
+ *                     a destroy and a create, and of the reads before and
+ *                     after the moves are reported
+ *
+ *  usage: EduOM_Bench [-p #pages of volume] [-b benchmark group]
+ *                     [-m #objects of a file of the suite]
+ *                     [-k #operations of a run of the suite]
+ *                     [-s object sizes] [-f fill levels(%)]
+ *                     [-g fragmentation ratios(%)] [-o]
+ *                     [-n #objects of the parallel scan, the size
+ *                        classes, the compaction, the append, the page
+ *                        format, the fixed length, and the update]
+ *                     [-t max #threads]
+ *                     [-c max #threads of the concurrent reads]
+ *  The lists of -s, -f, and -g are separated by commas, e.g., -s 16,100.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+#include "EduOM_TestModule.h"
+
+
+/*@
+ * Constant Definitions
+ */
+#define BENCH_VOLNAME       "bench.vol"
+#define BENCH_VOLID         2000
+#define BENCH_EXTSIZE       16
+#define BENCH_NUMPAGES      20000
+#define BENCH_NUMOBJECTS    100000
+#define BENCH_MAXTHREADS    8
+#define BENCH_BATCHSIZE     256     /* # of objects created by a call */
+#define BENCH_OBJSIZE       100     /* size of the objects */
+#define BENCH_SCANWORK      20      /* passes over the data of an object in a scan */
+#define BENCH_MAXREADERS    64      /* max # of threads of the concurrent reads */
+#define BENCH_HOTOBJECTS    2048    /* # of objects read by the concurrent reads */
+#define BENCH_FRONTPAGES    128     /* # of pages of the buffer front end */
+#define BENCH_READSPERTHREAD 200000 /* # of reads of a thread */
+#define BENCH_SUITEOBJECTS  10000   /* # of objects of a file of the suite */
+#define BENCH_SUITEOPS      1000    /* # of operations of a run of the suite */
+#define BENCH_MAXPARAMS     8       /* max # of values of a parameter list */
+#define BENCH_MAXOBJSIZE    2000    /* max size of the objects of the suite */
+#define BENCH_CHURNROUNDS   4       /* # of operations per object of the size classes */
+#define BENCH_SMALLMAX      64      /* max size of the small objects of the size classes */
+#define BENCH_LARGEMIN      300     /* min size of the large objects of the size classes */
+#define BENCH_LARGEMAX      1000    /* max size of the large objects of the size classes */
+#define BENCH_COMPACTBUDGET 1024    /* bytes moved by the compactions of a create */
+#define BENCH_COMPACTCOST   200     /* max % of the bytes moved to the bytes gained */
+#define BENCH_DEFERTHRESHOLD 50     /* % of unused bytes queueing a page */
+#define BENCH_IDLEPERIOD    100     /* # of operations between the idle times */
+#define BENCH_IDLEBUDGET    16384   /* bytes moved by the compactions of an idle time */
+#define BENCH_APPENDLEN     100     /* size of the objects appended */
+#define BENCH_APPENDROUNDS  5       /* # of runs of each variant of the appends */
+#define BENCH_NUMFORMATS    3       /* # of the page formats */
+#define BENCH_FORMATKEYLEN  40      /* max size of the keys of the objects of the page formats */
+#define BENCH_FORMATTAIL    30      /* max # of the bytes after the key of an object */
+#define BENCH_FORMATSCANS   5       /* # of scans of each file of the page formats */
+#define BENCH_NUMFIXEDSIZES 3       /* # of the lengths of the fixed-length objects */
+#define BENCH_GROWNSIZE     300     /* size of the objects grown by the updates */
+
+/* benchmark groups */
+#define BENCH_SUITE         0x1
+#define BENCH_PARALLELSCAN  0x2
+#define BENCH_CONCURRENTREAD 0x4
+#define BENCH_MAPPEDSCAN    0x8
+#define BENCH_SIZECLASS     0x10
+#define BENCH_COMPACTION    0x20
+#define BENCH_APPEND        0x40
+#define BENCH_PAGEFORMAT    0x80
+#define BENCH_FIXEDLENGTH   0x100
+#define BENCH_UPDATE        0x200
+#define BENCH_ALL           (BENCH_SUITE | BENCH_PARALLELSCAN | BENCH_CONCURRENTREAD | BENCH_MAPPEDSCAN | \
+                             BENCH_SIZECLASS | BENCH_COMPACTION | BENCH_APPEND | BENCH_PAGEFORMAT | \
+                             BENCH_FIXEDLENGTH | BENCH_UPDATE)
+
+
+/*
+ * Typedef for the state of a scanning thread
+ */
+typedef struct {
+    Four        nObjs;		/* # of objects scanned */
+    UFour       sum;		/* checksum of the data scanned */
+} BenchScanState;
+
+
+/*
+ * Typedef for a thread of the concurrent reads
+ */
+typedef struct {
+    pthread_t   thread;		/* the thread */
+    ObjectID    *oids;		/* objects to read */
+    Four        nObjs;		/* # of objects to read */
+    UFour       seed;		/* seed of the random numbers */
+    Four        nReads;		/* # of reads done */
+    Four        e;		/* error of the thread */
+} BenchReader;
+
+
+/*
+ * Typedef for the object manager measured by the suite
+ * The suite runs the same operations through EduOM and through the OM_*
+ * functions of the storage library.
+ */
+typedef struct {
+    char        *name;		/* name printed in the results */
+    Four        (*createObject)(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, ObjectID*);
+    Four        (*destroyObject)(ObjectID*, ObjectID*, Pool*, DeallocListElem*);
+    Four        (*readObject)(ObjectID*, Four, Four, void*);
+    Four        (*nextObject)(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
+    Four        (*prevObject)(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
+    Four        (*compactPage)(SlottedPage*, Two);
+} BenchImpl;
+
+
+/*
+ * Typedef for the parameters of the suite
+ */
+typedef struct {
+    Four        nObjs;		/* # of objects of a file */
+    Four        nOps;		/* # of operations of a run */
+    Four        nSizes;		/* # of object sizes */
+    Four        sizes[BENCH_MAXPARAMS];	/* object sizes */
+    Four        nFills;		/* # of fill levels */
+    Four        fills[BENCH_MAXPARAMS];	/* % of the objects kept in the file */
+    Four        nFrags;		/* # of fragmentation ratios */
+    Four        frags[BENCH_MAXPARAMS];	/* % of the removed objects taken from the middle of the pages */
+    Boolean     baseline;	/* TRUE if the OM_* functions are also measured */
+} BenchSuiteParams;
+
+
+/*
+ * Typedef for an object of a file of the suite
+ */
+typedef struct {
+    ObjectID    oid;		/* ID of the object */
+    Four        page;		/* index of the page group of the object */
+    Boolean     alive;		/* FALSE if the object has been destroyed */
+} BenchObject;
+
+
+/*
+ * Typedef for a file of the suite
+ * The objects created when the file is built are kept in the order of
+ * (page, slot); the page group of an object is the range of the objects of
+ * its page.
+ */
+typedef struct {
+    FileID      fid;		/* ID of the file */
+    ObjectID    catObjForFile;	/* catalog object of the file */
+    Four        size;		/* size of the objects */
+    Four        nObjs;		/* # of objects built */
+    BenchObject *objs;		/* objects built */
+    Four        nPages;		/* # of page groups */
+    Four        *pageStart;	/* first object of each page group */
+    Four        *pageEnd;	/* object after the last one of each page group */
+} BenchFile;
+
+
+/*@
+ * Function Prototypes
+ */
+Four SM_CreateFile(Four, FileID*, Boolean, void*);
+Four SM_DestroyFile(FileID*, void*);
+Four sm_GetCatalogEntryFromDataFileId(Four, FileID*, ObjectID*);
+Four BfM_FlushAll(void);
+Four BfM_DiscardAll(void);
+
+/* the object manager of the storage library, as the baseline */
+Four OM_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, ObjectID*);
+Four OM_DestroyObject(ObjectID*, ObjectID*, Pool*, DeallocListElem*);
+Four OM_ReadObject(ObjectID*, Four, Four, void*);
+Four OM_NextObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
+Four OM_PrevObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
+Four OM_CompactPage(SlottedPage*, Two);
+
+static double bench_Now(void);
+static Four bench_CreateFile(Four, Four, FileID*, ObjectID*, ObjectID*);
+static Four bench_ScanCallback(Four, ObjectID*, ObjectHdr*, const char*, void*);
+static Four bench_ParallelScan(Four, Four, Four);
+static void *bench_ReaderMain(void*);
+static Four bench_ConcurrentRead(Four, Four);
+static Four bench_MappedScan(Four, Four);
+static Four bench_ScanFile(ObjectID*, Four*, UFour*);
+static Four bench_SizeClass(Four, Four);
+static Four bench_Compaction(Four, Four);
+static Four bench_Append(Four, Four);
+static Four bench_PageFormat(Four, Four);
+static Four bench_FixedLength(Four, Four);
+static Four bench_Update(Four, Four);
+static Four bench_Churn(ObjectID*, Four, double*, Four*, Four*);
+static Four bench_FileSpace(ObjectID*, Four*, long*);
+static Four bench_ParseList(char*, Four*);
+static Four bench_Suite(Four, BenchSuiteParams*);
+static Four bench_SuiteFile(Four, BenchImpl*, BenchSuiteParams*, Four, Four, Four);
+static Four bench_BuildFile(Four, BenchImpl*, Four, Four, Four, Four, BenchFile*);
+static Four bench_DropFile(BenchFile*);
+static Four bench_EmptyBufferPool(void);
+static Four bench_LastAlive(BenchFile*, Four);
+static Four bench_RunOperation(BenchImpl*, BenchFile*, Four, Four, Boolean, Four*, double*, double*);
+static int bench_CompareObjects(const void*, const void*);
+static int bench_CompareLatencies(const void*, const void*);
+static void bench_Report(char*, BenchImpl*, BenchFile*, Four, Four, Boolean, Four, double, double*);
+
+
+/*@
+ * Global variables
+ */
+/* object managers measured by the suite */
+static BenchImpl bench_impls[] = {
+    { "EduOM", EduOM_CreateObject, EduOM_DestroyObject, EduOM_ReadObject,
+      EduOM_NextObject, EduOM_PrevObject, EduOM_CompactPage },
+    { "OM", OM_CreateObject, OM_DestroyObject, OM_ReadObject,
+      OM_NextObject, OM_PrevObject, OM_CompactPage }
+};
+
+/* operations of the suite; they run in this order on a file */
+#define BENCH_READPARTIAL   0
+#define BENCH_READREMAINDER 1
+#define BENCH_NEXTSCAN      2
+#define BENCH_PREVSCAN      3
+#define BENCH_DESTROYMIDDLE 4
+#define BENCH_DESTROYLAST   5
+#define BENCH_CREATENEAR    6
+#define BENCH_CREATENULL    7
+#define BENCH_COMPACT       8
+#define BENCH_NUMOPERATIONS 9
+
+static char *bench_opNames[BENCH_NUMOPERATIONS] = {
+    "read_partial", "read_remainder", "next_scan", "prev_scan",
+    "destroy_middle", "destroy_last", "create_near", "create_null", "compact"
+};
+
+/* page formats compared by the page_format group */
+static Four bench_formats[BENCH_NUMFORMATS] = { PAGE_FORMAT_V1, PAGE_FORMAT_V2, PAGE_FORMAT_PREFIX };
+static char *bench_formatNames[BENCH_NUMFORMATS] = { "v1", "v2", "prefix" };
+
+/* lengths of the objects of the fixed_length group */
+static Four bench_fixedSizes[BENCH_NUMFIXEDSIZES] = { 8, 32, 100 };
+
+
+
+/*@================================
+ * main()
+ *================================*/
+int main(int argc, char *argv[])
+{
+    Four    e;			/* error */
+    Four    opt;		/* command line option */
+    Four    handle;		/* system handle */
+    char    *devNames[1];	/* device name */
+    Four    numPages[1];	/* # of pages of the device */
+    Four    volId;		/* volume identifier */
+    Four    nObjs;		/* # of objects of the benchmarks */
+    Four    maxThreads;		/* max # of threads of the parallel benchmarks */
+    Four    maxReaders;		/* max # of threads of the concurrent reads */
+    Four    groups;		/* benchmark groups to run */
+    Four    i;			/* index variable */
+    BenchSuiteParams params;	/* parameters of the suite */
+    XactID  xactId;		/* transaction identifier */
+
+
+    numPages[0] = BENCH_NUMPAGES;
+    nObjs = BENCH_NUMOBJECTS;
+    maxThreads = BENCH_MAXTHREADS;
+    maxReaders = BENCH_MAXREADERS;
+    groups = BENCH_ALL;
+
+    params.nObjs = BENCH_SUITEOBJECTS;
+    params.nOps = BENCH_SUITEOPS;
+    params.nSizes = bench_ParseList("16,100,1000", params.sizes);
+    params.nFills = bench_ParseList("100,50", params.fills);
+    params.nFrags = bench_ParseList("0,50", params.frags);
+    params.baseline = FALSE;
+
+    while ((opt = getopt(argc, argv, "p:b:m:k:s:f:g:on:t:c:")) != -1) {
+        switch (opt) {
+          case 'p': numPages[0] = atoi(optarg); break;
+          case 'b':
+            if (strcmp(optarg, "suite") == 0) groups = BENCH_SUITE;
+            else if (strcmp(optarg, "parallel_scan") == 0) groups = BENCH_PARALLELSCAN;
+            else if (strcmp(optarg, "concurrent_read") == 0) groups = BENCH_CONCURRENTREAD;
+            else if (strcmp(optarg, "mapped_scan") == 0) groups = BENCH_MAPPEDSCAN;
+            else if (strcmp(optarg, "size_class") == 0) groups = BENCH_SIZECLASS;
+            else if (strcmp(optarg, "compaction") == 0) groups = BENCH_COMPACTION;
+            else if (strcmp(optarg, "append") == 0) groups = BENCH_APPEND;
+            else if (strcmp(optarg, "page_format") == 0) groups = BENCH_PAGEFORMAT;
+            else if (strcmp(optarg, "fixed_length") == 0) groups = BENCH_FIXEDLENGTH;
+            else if (strcmp(optarg, "update") == 0) groups = BENCH_UPDATE;
+            else groups = 0;
+            break;
+          case 'm': params.nObjs = atoi(optarg); break;
+          case 'k': params.nOps = atoi(optarg); break;
+          case 's': params.nSizes = bench_ParseList(optarg, params.sizes); break;
+          case 'f': params.nFills = bench_ParseList(optarg, params.fills); break;
+          case 'g': params.nFrags = bench_ParseList(optarg, params.frags); break;
+          case 'o': params.baseline = TRUE; break;
+          case 'n': nObjs = atoi(optarg); break;
+          case 't': maxThreads = atoi(optarg); break;
+          case 'c': maxReaders = atoi(optarg); break;
+          default: groups = 0; break;
+        }
+    }
+
+    for (i = 0; i < params.nSizes; i++)
+        if (params.sizes[i] < 1 || params.sizes[i] > BENCH_MAXOBJSIZE) groups = 0;
+    for (i = 0; i < params.nFills; i++)
+        if (params.fills[i] < 1 || params.fills[i] > 100) groups = 0;
+    for (i = 0; i < params.nFrags; i++)
+        if (params.frags[i] < 0 || params.frags[i] > 100) groups = 0;
+    if (params.nObjs < 1 || params.nOps < 1 || params.nSizes < 1 ||
+        params.nFills < 1 || params.nFrags < 1) groups = 0;
+
+    if (groups == 0) {
+        fprintf(stderr, "usage: %s [-p #pages] [-b suite|parallel_scan|concurrent_read|mapped_scan|size_class|compaction|append|page_format|fixed_length|update]\n"
+                "\t[-m #objects of a file] [-k #operations of a run] [-s sizes] [-f fill levels]\n"
+                "\t[-g fragmentation ratios] [-o] [-n #objects] [-t max #threads] [-c max #readers]\n", argv[0]);
+        exit(1);
+    }
+
+    if (maxThreads < 1 || maxThreads > PSCAN_MAXTHREADS) maxThreads = BENCH_MAXTHREADS;
+    if (maxReaders < 1 || maxReaders > BENCH_MAXREADERS) maxReaders = BENCH_MAXREADERS;
+
+    e = LRDS_Init();
+    if (e < eNOERROR) {
+        printf("LRDS_Init failed!!!\n");
+        exit(1);
+    }
+
+    e = LRDS_AllocHandle(&handle);
+    if (e < eNOERROR) {
+        printf("LRDS_AllocHandle failed!!!\n");
+        LRDS_Final();
+        exit(1);
+    }
+
+    devNames[0] = BENCH_VOLNAME;
+    volId = BENCH_VOLID;
+
+    e = LRDS_FormatDataVolume(1, devNames, "bench", volId, BENCH_EXTSIZE, numPages, BENCH_EXTSIZE);
+    if (e < eNOERROR) {
+        printf("LRDS_FormatDataVolume failed!!!\n");
+        LRDS_FreeHandle(handle);
+        LRDS_Final();
+        exit(1);
+    }
+
+    e = LRDS_Mount(1, devNames, &volId);
+    if (e < eNOERROR) {
+        printf("LRDS_Mount failed!!!\n");
+        LRDS_FreeHandle(handle);
+        LRDS_Final();
+        exit(1);
+    }
+
+    /*@ run the benchmarks */
+    e = eNOERROR;
+
+    /* the suite runs each file in a transaction of its own */
+    if (groups & BENCH_SUITE) e = bench_Suite(volId, &params);
+
+    if (e >= eNOERROR && (groups & (BENCH_PARALLELSCAN | BENCH_CONCURRENTREAD | BENCH_MAPPEDSCAN | BENCH_SIZECLASS | BENCH_COMPACTION | BENCH_APPEND | BENCH_PAGEFORMAT | BENCH_FIXEDLENGTH | BENCH_UPDATE))) {
+        e = LRDS_BeginTransaction(&xactId, X_RR_RR);
+        if (e >= eNOERROR) {
+            if (groups & BENCH_PARALLELSCAN) e = bench_ParallelScan(volId, nObjs, maxThreads);
+            if (e >= eNOERROR && (groups & BENCH_CONCURRENTREAD)) e = bench_ConcurrentRead(volId, maxReaders);
+            if (e >= eNOERROR && (groups & BENCH_MAPPEDSCAN)) e = bench_MappedScan(volId, nObjs);
+            if (e >= eNOERROR && (groups & BENCH_SIZECLASS)) e = bench_SizeClass(volId, nObjs);
+            if (e >= eNOERROR && (groups & BENCH_COMPACTION)) e = bench_Compaction(volId, nObjs);
+            if (e >= eNOERROR && (groups & BENCH_APPEND)) e = bench_Append(volId, nObjs);
+            if (e >= eNOERROR && (groups & BENCH_PAGEFORMAT)) e = bench_PageFormat(volId, nObjs);
+            if (e >= eNOERROR && (groups & BENCH_FIXEDLENGTH)) e = bench_FixedLength(volId, nObjs);
+            if (e >= eNOERROR && (groups & BENCH_UPDATE)) e = bench_Update(volId, nObjs);
+
+            if (e < eNOERROR)
+                LRDS_AbortTransaction(&xactId);
+            else
+                LRDS_CommitTransaction(&xactId);
+        }
+    }
+
+    if (e < eNOERROR) printf("EduOM_Bench failed!!!\n");
+
+    LRDS_Dismount(volId);
+    LRDS_FreeHandle(handle);
+    LRDS_Final();
+
+    return (e < eNOERROR) ? 1 : 0;
+
+} /* main() */
+
+
+
+/*@================================
+ * bench_Now()
+ *================================*/
+/*
+ * Function: double bench_Now(void)
+ *
+ * Description :
+ *  Return the time of the monotonic clock in seconds.
+ */
+static double bench_Now(void)
+{
+    struct timespec ts;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (ts.tv_sec + ts.tv_nsec/1e9);
+
+} /* bench_Now() */
+
+
+
+/*@================================
+ * bench_CreateFile()
+ *================================*/
+/*
+ * Function: Four bench_CreateFile(Four, Four, FileID*, ObjectID*, ObjectID*)
+ *
+ * Description :
+ *  Create a data file holding 'nObjs' objects of BENCH_OBJSIZE bytes. If
+ *  'allOids' is not NULL, the IDs of the objects are returned in it.
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_CreateFile(
+    Four        volId,		/* IN volume of the file */
+    Four        nObjs,		/* IN # of objects */
+    FileID      *fid,		/* OUT ID of the file */
+    ObjectID    *catObjForFile,	/* OUT catalog object of the file */
+    ObjectID    *allOids)	/* OUT IDs of the objects; may be NULL */
+{
+    Four        e;		/* error */
+    Four        i;		/* index variable */
+    Four        n;		/* # of objects created by a call */
+    static char data[BENCH_BATCHSIZE][BENCH_OBJSIZE];
+    static char *datas[BENCH_BATCHSIZE];
+    static Four lengths[BENCH_BATCHSIZE];
+    static ObjectID oids[BENCH_BATCHSIZE];
+
+
+    e = SM_CreateFile(volId, fid, FALSE, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, fid, catObjForFile);
+    if (e < eNOERROR) ERR(e);
+
+    for (i = 0; i < BENCH_BATCHSIZE; i++) {
+        memset(data[i], 'a' + i%26, BENCH_OBJSIZE);
+        datas[i] = data[i];
+        lengths[i] = BENCH_OBJSIZE;
+    }
+
+    for (i = 0; i < nObjs; i += n) {
+        n = MIN(BENCH_BATCHSIZE, nObjs - i);
+
+        e = EduOM_CreateObjects(catObjForFile, NULL, n, NULL, lengths, datas,
+                                (allOids != NULL) ? &allOids[i] : oids);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* bench_CreateFile() */
+
+
+
+/*@================================
+ * bench_ScanCallback()
+ *================================*/
+/*
+ * Function: Four bench_ScanCallback(Four, ObjectID*, ObjectHdr*, const char*, void*)
+ *
+ * Description :
+ *  Count the object and fold its data into the checksum of the thread; the
+ *  data is read BENCH_SCANWORK times to simulate the processing of the object.
+ *
+ * Returns:
+ *  eNOERROR
+ */
+static Four bench_ScanCallback(
+    Four        threadNo,	/* IN number of the thread */
+    ObjectID    *oid,		/* IN the object */
+    ObjectHdr   *objHdr,	/* IN header of the object */
+    const char  *data,		/* IN data of the object */
+    void        *arg)		/* INOUT state of the thread */
+{
+    BenchScanState *state = (BenchScanState*)arg;
+    Four        i, k;
+
+
+    state->nObjs++;
+    for (k = 0; k < BENCH_SCANWORK; k++)
+        for (i = 0; i < objHdr->length; i++)
+            state->sum = state->sum*31 + (UOne)data[i];
+
+    return(eNOERROR);
+
+} /* bench_ScanCallback() */
+
+
+
+/*@================================
+ * bench_ParallelScan()
+ *================================*/
+/*
+ * Function: Four bench_ParallelScan(Four, Four, Four)
+ *
+ * Description :
+ *  Scan a file with EduOM_ParallelScan() using 1, 2, 4, ... 'maxThreads'
+ *  threads, and print the throughput of each run.
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_ParallelScan(
+    Four        volId,		/* IN volume of the file */
+    Four        nObjs,		/* IN # of objects of the file */
+    Four        maxThreads)	/* IN max # of threads */
+{
+    Four        e;		/* error */
+    Four        t;		/* # of threads */
+    Four        i;		/* index variable */
+    FileID      fid;		/* ID of the file */
+    ObjectID    catObjForFile;	/* catalog object of the file */
+    BenchScanState states[PSCAN_MAXTHREADS]; /* state of each thread */
+    Four        nScanned;	/* # of objects scanned by all the threads */
+    void        *args[PSCAN_MAXTHREADS]; /* arguments of the callback */
+    double      start;		/* start time of a run */
+    double      elapsed;	/* elapsed time of a run */
+
+
+    e = bench_CreateFile(volId, nObjs, &fid, &catObjForFile, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    for (t = 1; ; t = MIN(2*t, maxThreads)) {
+        for (i = 0; i < t; i++) {
+            states[i].nObjs = 0;
+            states[i].sum = 0;
+            args[i] = &states[i];
+        }
+
+        start = bench_Now();
+
+        e = EduOM_ParallelScan(&catObjForFile, t, 4*PSCAN_MAXTHREADS, bench_ScanCallback, args);
+        if (e < eNOERROR) ERR(e);
+
+        elapsed = bench_Now() - start;
+
+        for (i = 0, nScanned = 0; i < t; i++) nScanned += states[i].nObjs;
+
+        printf("{\"bench\": \"parallel_scan\", \"threads\": %ld, \"objects\": %ld, \"seconds\": %.6f, \"ops_per_sec\": %.0f}\n",
+               (long)t, (long)nScanned, elapsed, nScanned/elapsed);
+
+        if (t == maxThreads) break;
+    }
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    (Four) EduOM_InvalidateCatalogCache(&catObjForFile);
+
+    return(eNOERROR);
+
+} /* bench_ParallelScan() */
+
+
+
+/*@================================
+ * bench_ReaderMain()
+ *================================*/
+/*
+ * Function: void *bench_ReaderMain(void*)
+ *
+ * Description :
+ *  Main function of a thread of the concurrent reads; the thread reads
+ *  objects chosen at random with EduOM_ReadObject().
+ *
+ * Returns:
+ *  NULL
+ */
+static void *bench_ReaderMain(
+    void        *arg)		/* INOUT the reader */
+{
+    BenchReader *reader = (BenchReader*)arg;
+    Four        i;		/* index variable */
+    Four        e;		/* error */
+    char        buf[BENCH_OBJSIZE]; /* buffer for the data read */
+
+
+    reader->e = eNOERROR;
+    for (i = 0; i < BENCH_READSPERTHREAD; i++) {
+        e = EduOM_ReadObject(&reader->oids[rand_r(&reader->seed) % reader->nObjs], 0, REMAINDER, buf);
+        if (e < eNOERROR) {
+            reader->e = e;
+            break;
+        }
+        reader->nReads++;
+    }
+
+    return(NULL);
+
+} /* bench_ReaderMain() */
+
+
+
+/*@================================
+ * bench_ConcurrentRead()
+ *================================*/
+/*
+ * Function: Four bench_ConcurrentRead(Four, Four)
+ *
+ * Description :
+ *  Read a hot set of objects at random with 1, 2, 4, ... 'maxReaders'
+ *  threads through the buffer front end, and print the throughput of each
+ *  run.
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_ConcurrentRead(
+    Four        volId,		/* IN volume of the file */
+    Four        maxReaders)	/* IN max # of threads */
+{
+    Four        e;		/* error */
+    Four        t;		/* # of threads */
+    Four        i;		/* index variable */
+    FileID      fid;		/* ID of the file */
+    ObjectID    catObjForFile;	/* catalog object of the file */
+    BenchReader readers[BENCH_MAXREADERS]; /* the threads */
+    Four        nReads;		/* # of reads done by all the threads */
+    double      start;		/* start time of a run */
+    double      elapsed;	/* elapsed time of a run */
+    static ObjectID oids[BENCH_HOTOBJECTS];
+
+
+    e = bench_CreateFile(volId, BENCH_HOTOBJECTS, &fid, &catObjForFile, oids);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduOM_EnableBufferFront(BENCH_FRONTPAGES);
+    if (e < eNOERROR) ERR(e);
+
+    for (t = 1; ; t = MIN(2*t, maxReaders)) {
+        for (i = 0; i < t; i++) {
+            readers[i].oids = oids;
+            readers[i].nObjs = BENCH_HOTOBJECTS;
+            readers[i].seed = i + 1;
+            readers[i].nReads = 0;
+            readers[i].e = eNOERROR;
+        }
+
+        start = bench_Now();
+
+        for (i = 1; i < t; i++)
+            if (pthread_create(&readers[i].thread, NULL, bench_ReaderMain, &readers[i]) != 0) break;
+
+        (void) bench_ReaderMain(&readers[0]);
+
+        for (t = i, i = 1; i < t; i++)
+            (void) pthread_join(readers[i].thread, NULL);
+
+        elapsed = bench_Now() - start;
+
+        for (i = 0, nReads = 0; i < t; i++) {
+            if (readers[i].e < eNOERROR) {
+                (Four) EduOM_DisableBufferFront();
+                ERR(readers[i].e);
+            }
+            nReads += readers[i].nReads;
+        }
+
+        printf("{\"bench\": \"concurrent_read\", \"threads\": %ld, \"reads\": %ld, \"seconds\": %.6f, \"ops_per_sec\": %.0f}\n",
+               (long)t, (long)nReads, elapsed, nReads/elapsed);
+
+        if (t >= maxReaders) break;
+    }
+
+    e = EduOM_DisableBufferFront();
+    if (e < eNOERROR) ERR(e);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    (Four) EduOM_InvalidateCatalogCache(&catObjForFile);
+
+    return(eNOERROR);
+
+} /* bench_ConcurrentRead() */
+
+
+
+/*@================================
+ * bench_MappedScan()
+ *================================*/
+/*
+ * Function: Four bench_MappedScan(Four, Four)
+ *
+ * Description :
+ *  Scan a file reading every object, first through the buffer and then on
+ *  the volume mapped into memory, and print the throughput of each. Each
+ *  scan is run once before it is measured, so that the pages are in the
+ *  buffer or in the page cache of the kernel.
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_MappedScan(
+    Four        volId,		/* IN volume of the file */
+    Four        nObjs)		/* IN # of objects of the file */
+{
+    Four        e;		/* error */
+    Four        mapped;		/* 1 if the volume is mapped */
+    Four        mappedVolId;	/* volume number of the mapped volume */
+    Four        nScanned;	/* # of objects scanned */
+    UFour       sum;		/* checksum of the data scanned */
+    FileID      fid;		/* ID of the file */
+    ObjectID    catObjForFile;	/* catalog object of the file */
+    char        *devNames[1];	/* device name */
+    double      start;		/* start time of a run */
+    double      elapsed;	/* elapsed time of a run */
+
+
+    e = bench_CreateFile(volId, nObjs, &fid, &catObjForFile, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    /* the mapping shows the pages written to the device only */
+    e = BfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+
+    devNames[0] = BENCH_VOLNAME;
+
+    for (mapped = 0; mapped <= 1; mapped++) {
+        if (mapped) {
+            e = EduOM_MapVolume(1, devNames, MAPPED_SEQUENTIAL, &mappedVolId);
+            if (e < eNOERROR) ERR(e);
+        }
+
+        e = bench_ScanFile(&catObjForFile, &nScanned, &sum);
+
+        if (e >= eNOERROR) {
+            start = bench_Now();
+            e = bench_ScanFile(&catObjForFile, &nScanned, &sum);
+            elapsed = bench_Now() - start;
+        }
+
+        if (mapped) (Four) EduOM_UnmapVolume(mappedVolId);
+        if (e < eNOERROR) ERR(e);
+
+        printf("{\"bench\": \"mapped_scan\", \"access\": \"%s\", \"objects\": %ld, \"seconds\": %.6f, \"ops_per_sec\": %.0f, \"mb_per_sec\": %.1f}\n",
+               mapped ? "mapped" : "buffer", (long)nScanned, elapsed, nScanned/elapsed,
+               (double)nScanned*BENCH_OBJSIZE/elapsed/1e6);
+    }
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    (Four) EduOM_InvalidateCatalogCache(&catObjForFile);
+
+    return(eNOERROR);
+
+} /* bench_MappedScan() */
+
+
+
+/*@================================
+ * bench_ScanFile()
+ *================================*/
+/*
+ * Function: Four bench_ScanFile(ObjectID*, Four*, UFour*)
+ *
+ * Description :
+ *  Scan the file with a scan cursor, pinning every object returned and
+ *  folding its data into the checksum.
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_ScanFile(
+    ObjectID    *catObjForFile,	/* IN catalog object of the file */
+    Four        *nScanned,	/* OUT # of objects scanned */
+    UFour       *sum)		/* OUT checksum of the data scanned */
+{
+    Four        e;		/* error */
+    Four        n;		/* # of objects returned by a fetch */
+    Four        i, k;		/* index variable */
+    Four        length;		/* length of an object */
+    const char  *data;		/* data of an object */
+    EduOM_ScanCursor cursor;	/* the scan cursor */
+    EduOM_PinHandle handle;	/* handle of the pinned object */
+    static ObjectID oids[BENCH_BATCHSIZE];
+
+
+    *nScanned = 0;
+    *sum = 0;
+
+    e = EduOM_OpenScan(catObjForFile, NULL, FORWARD, &cursor);
+    if (e < eNOERROR) ERR(e);
+
+    while ((n = EduOM_FetchBatch(&cursor, BENCH_BATCHSIZE, oids, NULL)) > 0) {
+        for (i = 0; i < n; i++) {
+            e = EduOM_PinObject(&oids[i], &data, &length, &handle);
+            if (e < eNOERROR) break;
+
+            for (k = 0; k < length; k++) *sum = *sum*31 + (UOne)data[k];
+
+            e = EduOM_UnpinObject(&handle);
+            if (e < eNOERROR) break;
+        }
+        if (e < eNOERROR) break;
+
+        *nScanned += n;
+    }
+    if (n < 0) e = n;
+
+    (Four) EduOM_CloseScan(&cursor);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_ScanFile() */
+
+
+
+/*@================================
+ * bench_SizeClass()
+ *================================*/
+/*
+ * Function: Four bench_SizeClass(Four, Four)
+ *
+ * Description :
+ *  Run the same random sequence of creates and destroys on a file under
+ *  PLACEMENT_DEFAULT and on another under PLACEMENT_SIZECLASS, and print
+ *  the compactions done and the pages and unused bytes of the file left.
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_SizeClass(
+    Four        volId,		/* IN volume of the files */
+    Four        nObjs)		/* IN # of objects of a file */
+{
+    Four        e;		/* error */
+    Four        policy;		/* placement policy of the file */
+    Four        nAlive;		/* # of objects in the file */
+    Four        nPages;		/* # of pages of the file */
+    long        unused;		/* unused bytes of the pages of the file */
+    FileID      fid;		/* ID of the file */
+    ObjectID    catObjForFile;	/* catalog object of the file */
+    EduOM_Stats before;		/* counters before the run */
+    EduOM_Stats after;		/* counters after the run */
+    double      start;		/* start time of a run */
+    double      elapsed;	/* elapsed time of a run */
+
+
+    for (policy = PLACEMENT_DEFAULT; policy <= PLACEMENT_SIZECLASS; policy++) {
+        e = SM_CreateFile(volId, &fid, FALSE, NULL);
+        if (e >= eNOERROR) e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catObjForFile);
+        if (e >= eNOERROR) e = EduOM_SetPlacementPolicy(&catObjForFile, policy);
+        if (e < eNOERROR) ERR(e);
+
+        (Four) EduOM_GetStats(&before);
+        start = bench_Now();
+
+        e = bench_Churn(&catObjForFile, nObjs, NULL, NULL, &nAlive);
+
+        elapsed = bench_Now() - start;
+        (Four) EduOM_GetStats(&after);
+
+        if (e >= eNOERROR) e = bench_FileSpace(&catObjForFile, &nPages, &unused);
+        if (e < eNOERROR) ERR(e);
+
+        printf("{\"bench\": \"size_class\", \"policy\": \"%s\", \"operations\": %ld, \"objects\": %ld, \"seconds\": %.6f, "
+               "\"ops_per_sec\": %.0f, \"compactions\": %lu, \"compact_bytes\": %lu, \"pages\": %ld, \"unused_bytes\": %ld}\n",
+               (policy == PLACEMENT_SIZECLASS) ? "size_class" : "default", (long)BENCH_CHURNROUNDS * nObjs, (long)nAlive,
+               elapsed, BENCH_CHURNROUNDS * nObjs / elapsed,
+               after.compactions - before.compactions, after.compactBytes - before.compactBytes, (long)nPages, unused);
+
+        (Four) EduOM_SetPlacementPolicy(&catObjForFile, PLACEMENT_DEFAULT);
+
+        e = SM_DestroyFile(&fid, NULL);
+        if (e < eNOERROR) ERR(e);
+
+        (Four) EduOM_InvalidateCatalogCache(&catObjForFile);
+    }
+
+    return(eNOERROR);
+
+} /* bench_SizeClass() */
+
+
+
+/*@================================
+ * bench_Compaction()
+ *================================*/
+/*
+ * Function: Four bench_Compaction(Four, Four)
+ *
+ * Description :
+ *  Run the same random sequence of creates and destroys on a file with the
+ *  compactions done eagerly, limited by a budget and a cost, and limited and
+ *  deferred to the idle time, and print the latencies of the creates and
+ *  the compactions done in the creates and in the idle time.
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_Compaction(
+    Four        volId,		/* IN volume of the files */
+    Four        nObjs)		/* IN # of objects of a file */
+{
+    Four        e;		/* error */
+    Four        run;		/* index of the policy */
+    Four        nAlive;		/* # of objects in the file */
+    Four        nCreates;	/* # of creates done */
+    Four        nPages;		/* # of pages of the file */
+    long        unused;		/* unused bytes of the pages of the file */
+    FileID      fid;		/* ID of the file */
+    ObjectID    catObjForFile;	/* catalog object of the file */
+    EduOM_Stats before;		/* counters before the run */
+    EduOM_Stats after;		/* counters after the run */
+    double      *latencies;	/* latency of each create */
+    double      p50, p99, p999;	/* percentiles of the latencies */
+    static char *names[] = { "eager", "budgeted", "deferred" };
+    static Four budgets[] = { COMPACT_NOLIMIT, BENCH_COMPACTBUDGET, BENCH_COMPACTBUDGET };
+    static Four maxCosts[] = { COMPACT_NOLIMIT, BENCH_COMPACTCOST, BENCH_COMPACTCOST };
+    static Four thresholds[] = { 0, 0, BENCH_DEFERTHRESHOLD };
+
+
+    latencies = (double*)malloc(BENCH_CHURNROUNDS * nObjs * sizeof(double));
+    if (latencies == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+    for (run = 0; run < 3; run++) {
+        e = EduOM_SetCompactionPolicy(budgets[run], maxCosts[run], thresholds[run]);
+        if (e >= eNOERROR) e = SM_CreateFile(volId, &fid, FALSE, NULL);
+        if (e >= eNOERROR) e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catObjForFile);
+        if (e < eNOERROR) break;
+
+        (Four) EduOM_GetStats(&before);
+
+        e = bench_Churn(&catObjForFile, nObjs, latencies, &nCreates, &nAlive);
+
+        (Four) EduOM_GetStats(&after);
+
+        if (e >= eNOERROR) e = bench_FileSpace(&catObjForFile, &nPages, &unused);
+        if (e < eNOERROR) break;
+
+        p50 = p99 = p999 = 0;
+        if (nCreates > 0) {
+            qsort(latencies, nCreates, sizeof(double), bench_CompareLatencies);
+            p50 = latencies[(nCreates - 1) * 50 / 100];
+            p99 = latencies[(nCreates - 1) * 99 / 100];
+            p999 = latencies[(nCreates - 1) * 999 / 1000];
+        }
+
+        printf("{\"bench\": \"compaction\", \"policy\": \"%s\", \"creates\": %ld, \"objects\": %ld, "
+               "\"p50_us\": %.3f, \"p99_us\": %.3f, \"p999_us\": %.3f, \"max_us\": %.3f, "
+               "\"foreground_compactions\": %lu, \"deferred_compactions\": %lu, \"refusals\": %lu, "
+               "\"pages\": %ld, \"unused_bytes\": %ld}\n",
+               names[run], (long)nCreates, (long)nAlive, p50*1e6, p99*1e6, p999*1e6,
+               (nCreates > 0) ? latencies[nCreates - 1]*1e6 : 0.0,
+               (after.compactions - before.compactions) - (after.deferredCompactions - before.deferredCompactions),
+               after.deferredCompactions - before.deferredCompactions,
+               after.compactRefusals - before.compactRefusals, (long)nPages, unused);
+
+        e = SM_DestroyFile(&fid, NULL);
+        if (e < eNOERROR) break;
+
+        (Four) EduOM_InvalidateCatalogCache(&catObjForFile);
+    }
+
+    free(latencies);
+    (Four) EduOM_SetCompactionPolicy(COMPACT_NOLIMIT, COMPACT_NOLIMIT, 0);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_Compaction() */
+
+
+
+/*@================================
+ * bench_Append()
+ *================================*/
+/*
+ * Function: Four bench_Append(Four, Four)
+ *
+ * Description :
+ *  Append objects of BENCH_APPENDLEN bytes to an empty file, without and
+ *  with the append page of the free space map. The two are run by turns
+ *  BENCH_APPENDROUNDS times each, and the best time of each is printed with
+ *  the pins per create.
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_Append(
+    Four        volId,		/* IN volume of the files */
+    Four        nObjs)		/* IN # of objects appended */
+{
+    Four        e;		/* error */
+    Four        run;		/* index of the run; odd if the append page is used */
+    Four        i;		/* index variable */
+    FileID      fid;		/* ID of the file */
+    ObjectID    catObjForFile;	/* catalog object of the file */
+    ObjectID    oid;		/* object created */
+    EduOM_Stats before;		/* counters before the run */
+    EduOM_Stats after;		/* counters after the run */
+    double      start;		/* start time of a run */
+    double      elapsed;	/* elapsed time of a run */
+    double      best[2];	/* best time without and with the append page */
+    unsigned long pins[2];	/* pins done by the creates of a run */
+    unsigned long hits[2];	/* creates put into the append page in a run */
+    char        buf[BENCH_APPENDLEN];
+
+
+    memset(buf, 'x', BENCH_APPENDLEN);
+    best[0] = best[1] = 0;
+    e = eNOERROR;
+
+    for (run = 0; run < 2 * BENCH_APPENDROUNDS; run++) {
+        eduom_useAppendPage = (run % 2 == 1);
+
+        e = SM_CreateFile(volId, &fid, FALSE, NULL);
+        if (e >= eNOERROR) e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catObjForFile);
+        if (e < eNOERROR) break;
+
+        (Four) EduOM_GetStats(&before);
+        start = bench_Now();
+
+        for (i = 0; i < nObjs; i++) {
+            e = EduOM_CreateObject(&catObjForFile, NULL, NULL, BENCH_APPENDLEN, buf, &oid);
+            if (e < eNOERROR) break;
+        }
+
+        elapsed = bench_Now() - start;
+        (Four) EduOM_GetStats(&after);
+        if (e < eNOERROR) break;
+
+        if (best[run % 2] == 0 || elapsed < best[run % 2]) best[run % 2] = elapsed;
+        pins[run % 2] = after.pins[STAT_OP_CREATE] - before.pins[STAT_OP_CREATE];
+        hits[run % 2] = after.appendHits - before.appendHits;
+
+        e = SM_DestroyFile(&fid, NULL);
+        if (e < eNOERROR) break;
+
+        (Four) EduOM_InvalidateCatalogCache(&catObjForFile);
+    }
+
+    eduom_useAppendPage = TRUE;
+    if (e < eNOERROR) ERR(e);
+
+    for (run = 0; run < 2; run++)
+        printf("{\"bench\": \"append\", \"append_page\": %s, \"objects\": %ld, \"seconds\": %.6f, \"ops_per_sec\": %.0f, "
+               "\"pins_per_op\": %.3f, \"append_hits\": %lu}\n",
+               (run == 1) ? "true" : "false", (long)nObjs, best[run], nObjs / best[run],
+               (double)pins[run] / nObjs, hits[run]);
+
+    return(eNOERROR);
+
+} /* bench_Append() */
+
+
+
+/*@================================
+ * bench_PageFormat()
+ *================================*/
+/*
+ * Function: Four bench_PageFormat(Four, Four)
+ *
+ * Description :
+ *  Create a file of each page format and put the same objects into them;
+ *  an object is a key like "EduOM_TestModule_OBJECT_NUM_<n>" followed by
+ *  up to BENCH_FORMATTAIL random bytes. The files are scanned, and all their
+ *  objects are read with EduOM_ReadObject(), by turns BENCH_FORMATSCANS
+ *  times each, and the pages per million objects and the best throughput
+ *  of each file are printed.
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_PageFormat(
+    Four        volId,		/* IN volume of the files */
+    Four        nObjs)		/* IN # of objects of a file */
+{
+    Four        e;		/* error */
+    Four        f;		/* index of the file, i.e., of the format */
+    Four        run;		/* index of the scan */
+    Four        i, k;		/* index variable */
+    Four        length;		/* length of an object */
+    Four        nScanned;	/* # of objects scanned */
+    Four        nPages[BENCH_NUMFORMATS]; /* # of pages of each file */
+    long        unused;		/* unused bytes of the pages of a file */
+    long        bytes;		/* bytes of the data of the objects of a file */
+    UFour       sum;		/* checksum of the data scanned */
+    FileID      fid[BENCH_NUMFORMATS]; /* IDs of the files */
+    ObjectID    catObjForFile[BENCH_NUMFORMATS]; /* catalog objects of the files */
+    ObjectID    *oids;		/* objects of the files */
+    double      start;		/* start time of a scan */
+    double      elapsed;	/* elapsed time of a scan */
+    double      bestScan[BENCH_NUMFORMATS]; /* best scan time of each file */
+    double      bestRead[BENCH_NUMFORMATS]; /* best time of the reads of each file */
+    char        buf[BENCH_FORMATKEYLEN + BENCH_FORMATTAIL];
+
+
+    oids = (ObjectID*)malloc(BENCH_NUMFORMATS * nObjs * sizeof(ObjectID));
+    if (oids == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+    for (f = 0; f < BENCH_NUMFORMATS; f++) bestScan[f] = bestRead[f] = 0;
+    bytes = 0;
+    e = eNOERROR;
+
+    for (f = 0; f < BENCH_NUMFORMATS && e >= eNOERROR; f++) {
+        e = SM_CreateFile(volId, &fid[f], FALSE, NULL);
+        if (e >= eNOERROR) e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid[f], &catObjForFile[f]);
+        if (e >= eNOERROR) e = EduOM_SetPageFormat(&catObjForFile[f], bench_formats[f]);
+
+        /* all the files get the same objects */
+        srand(1);
+        bytes = 0;
+        for (i = 0; i < nObjs && e >= eNOERROR; i++) {
+            length = sprintf(buf, "EduOM_TestModule_OBJECT_NUM_%ld", (long)i);
+            for (k = rand() % (BENCH_FORMATTAIL + 1); k > 0; k--) buf[length++] = 'a' + rand() % 26;
+
+            e = EduOM_CreateObject(&catObjForFile[f], NULL, NULL, length, buf, &oids[f*nObjs + i]);
+            bytes += length;
+        }
+
+        if (e >= eNOERROR) e = bench_FileSpace(&catObjForFile[f], &nPages[f], &unused);
+    }
+
+    for (run = 0; run < BENCH_NUMFORMATS * BENCH_FORMATSCANS && e >= eNOERROR; run++) {
+        f = run % BENCH_NUMFORMATS;
+
+        start = bench_Now();
+        e = bench_ScanFile(&catObjForFile[f], &nScanned, &sum);
+        elapsed = bench_Now() - start;
+        if (e < eNOERROR) break;
+
+        if (bestScan[f] == 0 || elapsed < bestScan[f]) bestScan[f] = elapsed;
+
+        start = bench_Now();
+        for (i = 0; i < nObjs; i++) {
+            e = EduOM_ReadObject(&oids[f*nObjs + i], 0, REMAINDER, buf);
+            if (e < eNOERROR) break;
+        }
+        elapsed = bench_Now() - start;
+        if (e < eNOERROR) break;
+
+        if (bestRead[f] == 0 || elapsed < bestRead[f]) bestRead[f] = elapsed;
+    }
+
+    free(oids);
+    if (e < eNOERROR) ERR(e);
+
+    for (f = 0; f < BENCH_NUMFORMATS; f++) {
+        printf("{\"bench\": \"page_format\", \"format\": \"%s\", \"objects\": %ld, \"pages\": %ld, "
+               "\"pages_per_million\": %.0f, \"scan_objects_per_sec\": %.0f, \"scan_mb_per_sec\": %.1f, "
+               "\"reads_per_sec\": %.0f}\n",
+               bench_formatNames[f], (long)nObjs, (long)nPages[f], nPages[f] * 1e6 / nObjs,
+               nObjs / bestScan[f], bytes / bestScan[f] / (1024 * 1024), nObjs / bestRead[f]);
+
+        e = SM_DestroyFile(&fid[f], NULL);
+        if (e < eNOERROR) ERR(e);
+
+        (Four) EduOM_InvalidateCatalogCache(&catObjForFile[f]);
+    }
+
+    return(eNOERROR);
+
+} /* bench_PageFormat() */
+
+
+
+/*@================================
+ * bench_FixedLength()
+ *================================*/
+/*
+ * Function: Four bench_FixedLength(Four, Four)
+ *
+ * Description :
+ *  For each length of bench_fixedSizes, create a file of the format v1 and
+ *  a file of fixed-length objects, and put the same objects of the length
+ *  into them. The files are scanned, and all their objects are read with
+ *  EduOM_ReadObject(), BENCH_FORMATSCANS times each, and the pages and the
+ *  throughput of the creates, the best scan, and the best reads of each
+ *  file are printed.
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_FixedLength(
+    Four        volId,		/* IN volume of the files */
+    Four        nObjs)		/* IN # of objects of a file */
+{
+    Four        e;		/* error */
+    Four        s;		/* index of the length */
+    Four        fixed;		/* TRUE for the file of fixed-length objects */
+    Four        run;		/* index of the scan */
+    Four        i;		/* index variable */
+    Four        nScanned;	/* # of objects scanned */
+    Four        nPages;		/* # of pages of the file */
+    long        unused;		/* unused bytes of the pages of the file */
+    UFour       sum;		/* checksum of the data scanned */
+    FileID      fid;		/* ID of the file */
+    ObjectID    catObjForFile;	/* catalog object of the file */
+    ObjectID    *oids;		/* objects of the file */
+    double      start;		/* start time of a measurement */
+    double      elapsed;	/* elapsed time of a measurement */
+    double      create;		/* time of the creates */
+    double      bestScan;	/* best scan time */
+    double      bestRead;	/* best time of the reads */
+    char        buf[BENCH_OBJSIZE];
+
+
+    oids = (ObjectID*)malloc(nObjs * sizeof(ObjectID));
+    if (oids == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+    e = eNOERROR;
+
+    for (s = 0; s < BENCH_NUMFIXEDSIZES && e >= eNOERROR; s++) {
+        for (fixed = FALSE; fixed <= TRUE && e >= eNOERROR; fixed++) {
+            e = SM_CreateFile(volId, &fid, FALSE, NULL);
+            if (e >= eNOERROR) e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catObjForFile);
+            if (e >= eNOERROR && fixed) e = EduOM_SetFixedLength(&catObjForFile, bench_fixedSizes[s]);
+
+            start = bench_Now();
+            for (i = 0; i < nObjs && e >= eNOERROR; i++) {
+                memset(buf, 'a' + i % 26, bench_fixedSizes[s]);
+                e = EduOM_CreateObject(&catObjForFile, NULL, NULL, bench_fixedSizes[s], buf, &oids[i]);
+            }
+            create = bench_Now() - start;
+
+            if (e >= eNOERROR) e = bench_FileSpace(&catObjForFile, &nPages, &unused);
+
+            bestScan = bestRead = 0;
+            for (run = 0; run < BENCH_FORMATSCANS && e >= eNOERROR; run++) {
+                start = bench_Now();
+                e = bench_ScanFile(&catObjForFile, &nScanned, &sum);
+                elapsed = bench_Now() - start;
+                if (e < eNOERROR) break;
+
+                if (bestScan == 0 || elapsed < bestScan) bestScan = elapsed;
+
+                start = bench_Now();
+                for (i = 0; i < nObjs; i++) {
+                    e = EduOM_ReadObject(&oids[i], 0, REMAINDER, buf);
+                    if (e < eNOERROR) break;
+                }
+                elapsed = bench_Now() - start;
+                if (e < eNOERROR) break;
+
+                if (bestRead == 0 || elapsed < bestRead) bestRead = elapsed;
+            }
+
+            if (e < eNOERROR) break;
+
+            printf("{\"bench\": \"fixed_length\", \"format\": \"%s\", \"length\": %ld, \"objects\": %ld, "
+                   "\"pages\": %ld, \"creates_per_sec\": %.0f, \"scan_objects_per_sec\": %.0f, "
+                   "\"reads_per_sec\": %.0f}\n",
+                   fixed ? "fixed" : "v1", (long)bench_fixedSizes[s], (long)nObjs, (long)nPages,
+                   nObjs / create, nObjs / bestScan, nObjs / bestRead);
+
+            e = SM_DestroyFile(&fid, NULL);
+
+            (Four) EduOM_InvalidateCatalogCache(&catObjForFile);
+        }
+    }
+
+    free(oids);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_FixedLength() */
+
+
+
+/*@================================
+ * bench_Update()
+ *================================*/
+/*
+ * Function: Four bench_Update(Four, Four)
+ *
+ * Description :
+ *  Create a file of objects of BENCH_OBJSIZE bytes, update every object
+ *  with new data of the same length, and then grow every object to
+ *  BENCH_GROWNSIZE bytes by an update; most of the grown objects are moved
+ *  to other pages and leave stubs. The same growth is also done in another
+ *  file by a destroy and a create, which changes the ObjectIDs. All the
+ *  objects are read with EduOM_ReadObject() before and after the growth.
+ *  The throughput of the updates, the destroys and creates, and the reads,
+ *  and the # of the objects moved are printed.
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_Update(
+    Four        volId,		/* IN volume of the files */
+    Four        nObjs)		/* IN # of objects of a file */
+{
+    Four        e;		/* error */
+    Four        i;		/* index variable */
+    FileID      fid;		/* ID of the file */
+    ObjectID    catObjForFile;	/* catalog object of the file */
+    ObjectID    *oids;		/* objects of the file */
+    EduOM_Stats before;		/* counters before the growth */
+    EduOM_Stats after;		/* counters after the growth */
+    double      start;		/* start time of a measurement */
+    double      inPlace;	/* time of the updates keeping the length */
+    double      grow;		/* time of the updates growing the objects */
+    double      recreate;	/* time of the destroys and creates growing the objects */
+    double      read;		/* time of the reads before the growth */
+    double      readMoved;	/* time of the reads after the growth */
+    char        buf[BENCH_GROWNSIZE];
+
+
+    oids = (ObjectID*)malloc(nObjs * sizeof(ObjectID));
+    if (oids == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+    /*@ the updates of a file */
+    e = SM_CreateFile(volId, &fid, FALSE, NULL);
+    if (e >= eNOERROR) e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catObjForFile);
+
+    for (i = 0; i < nObjs && e >= eNOERROR; i++) {
+        memset(buf, 'a' + i % 26, BENCH_OBJSIZE);
+        e = EduOM_CreateObject(&catObjForFile, NULL, NULL, BENCH_OBJSIZE, buf, &oids[i]);
+    }
+
+    start = bench_Now();
+    for (i = 0; i < nObjs && e >= eNOERROR; i++) {
+        memset(buf, 'A' + i % 26, BENCH_OBJSIZE);
+        e = EduOM_UpdateObject(&catObjForFile, &oids[i], NULL, BENCH_OBJSIZE, buf, &dlPool, &dlHead);
+    }
+    inPlace = bench_Now() - start;
+
+    start = bench_Now();
+    for (i = 0; i < nObjs && e >= eNOERROR; i++)
+        e = EduOM_ReadObject(&oids[i], 0, REMAINDER, buf);
+    read = bench_Now() - start;
+
+    (Four) EduOM_GetStats(&before);
+
+    start = bench_Now();
+    for (i = 0; i < nObjs && e >= eNOERROR; i++) {
+        memset(buf, 'a' + i % 26, BENCH_GROWNSIZE);
+        e = EduOM_UpdateObject(&catObjForFile, &oids[i], NULL, BENCH_GROWNSIZE, buf, &dlPool, &dlHead);
+    }
+    grow = bench_Now() - start;
+
+    (Four) EduOM_GetStats(&after);
+
+    start = bench_Now();
+    for (i = 0; i < nObjs && e >= eNOERROR; i++)
+        e = EduOM_ReadObject(&oids[i], 0, REMAINDER, buf);
+    readMoved = bench_Now() - start;
+
+    if (e >= eNOERROR) e = SM_DestroyFile(&fid, NULL);
+    (Four) EduOM_InvalidateCatalogCache(&catObjForFile);
+
+    /*@ the same growth by a destroy and a create */
+    if (e >= eNOERROR) e = SM_CreateFile(volId, &fid, FALSE, NULL);
+    if (e >= eNOERROR) e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catObjForFile);
+
+    for (i = 0; i < nObjs && e >= eNOERROR; i++) {
+        memset(buf, 'a' + i % 26, BENCH_OBJSIZE);
+        e = EduOM_CreateObject(&catObjForFile, NULL, NULL, BENCH_OBJSIZE, buf, &oids[i]);
+    }
+
+    start = bench_Now();
+    for (i = 0; i < nObjs && e >= eNOERROR; i++) {
+        memset(buf, 'a' + i % 26, BENCH_GROWNSIZE);
+        e = EduOM_DestroyObject(&catObjForFile, &oids[i], &dlPool, &dlHead);
+        if (e >= eNOERROR) e = EduOM_CreateObject(&catObjForFile, NULL, NULL, BENCH_GROWNSIZE, buf, &oids[i]);
+    }
+    recreate = bench_Now() - start;
+
+    if (e >= eNOERROR) e = SM_DestroyFile(&fid, NULL);
+    (Four) EduOM_InvalidateCatalogCache(&catObjForFile);
+
+    free(oids);
+    if (e < eNOERROR) ERR(e);
+
+    printf("{\"bench\": \"update\", \"objects\": %ld, \"size\": %ld, \"grown_size\": %ld, "
+           "\"in_place_updates_per_sec\": %.0f, \"grow_updates_per_sec\": %.0f, "
+           "\"destroy_create_per_sec\": %.0f, \"moved\": %lu, "
+           "\"reads_per_sec\": %.0f, \"moved_reads_per_sec\": %.0f}\n",
+           (long)nObjs, (long)BENCH_OBJSIZE, (long)BENCH_GROWNSIZE,
+           nObjs / inPlace, nObjs / grow, nObjs / recreate, after.forwards - before.forwards,
+           nObjs / read, nObjs / readMoved);
+
+    return(eNOERROR);
+
+} /* bench_Update() */
+
+
+
+/*@================================
+ * bench_Churn()
+ *================================*/
+/*
+ * Function: Four bench_Churn(ObjectID*, Four, double*, Four*, Four*)
+ *
+ * Description :
+ *  Run BENCH_CHURNROUNDS * 'nObjs' operations on the file; each of 'nObjs'
+ *  objects is created if it does not exist and destroyed otherwise. Two
+ *  thirds of the objects are small and the others are large. The sequence
+ *  is the same for every run. Every BENCH_IDLEPERIOD operations, the
+ *  deferred compaction is run as if the application were idle; its time is
+ *  not counted in the latencies.
+ *
+ * Returns:
+ *  error code
+ *
+ * Side effect:
+ *  1) parameter latencies
+ *     if not NULL, latencies[i] is set to the latency of the i-th create
+ *  2) parameter nCreates
+ *     if not NULL, nCreates is set to the # of creates done
+ */
+static Four bench_Churn(
+    ObjectID    *catObjForFile,	/* IN catalog object of the file */
+    Four        nObjs,		/* IN # of objects of the file */
+    double      *latencies,	/* OUT latency of each create */
+    Four        *nCreates,	/* OUT # of creates done */
+    Four        *nAlive)	/* OUT # of objects left in the file */
+{
+    Four        e;		/* error */
+    Four        n;		/* # of operations done */
+    Four        i;		/* index of an object */
+    Four        length;		/* length of an object */
+    Four        nCompacted;	/* # of pages compacted in the idle time */
+    Four        creates;	/* # of creates done */
+    ObjectID    *oids;		/* objects of the file */
+    Boolean     *alive;		/* TRUE if the object exists */
+    double      t0;		/* start time of a create */
+    static char buf[BENCH_LARGEMAX];
+
+
+    oids = (ObjectID*)malloc(nObjs * sizeof(ObjectID));
+    alive = (Boolean*)malloc(nObjs * sizeof(Boolean));
+    if (oids == NULL || alive == NULL) {
+        free(oids);
+        free(alive);
+        ERR(eMEMORYALLOCERR_EDUOM);
+    }
+
+    memset(buf, 'x', BENCH_LARGEMAX);
+    for (i = 0; i < nObjs; i++) alive[i] = FALSE;
+    *nAlive = 0;
+    creates = 0;
+    e = eNOERROR;
+
+    srand(1);
+
+    for (n = 0; n < BENCH_CHURNROUNDS * nObjs; n++) {
+        i = rand() % nObjs;
+
+        if (alive[i]) {
+            e = EduOM_DestroyObject(catObjForFile, &oids[i], &dlPool, &dlHead);
+            alive[i] = FALSE;
+            (*nAlive)--;
+        } else {
+            if (rand() % 3 != 0)
+                length = 1 + rand() % BENCH_SMALLMAX;
+            else
+                length = BENCH_LARGEMIN + rand() % (BENCH_LARGEMAX - BENCH_LARGEMIN + 1);
+
+            t0 = bench_Now();
+            e = EduOM_CreateObject(catObjForFile, NULL, NULL, length, buf, &oids[i]);
+            if (latencies != NULL) latencies[creates] = bench_Now() - t0;
+
+            creates++;
+            alive[i] = TRUE;
+            (*nAlive)++;
+        }
+        if (e < eNOERROR) break;
+
+        if ((n + 1) % BENCH_IDLEPERIOD == 0) {
+            e = EduOM_RunDeferredCompaction(BENCH_IDLEBUDGET, &nCompacted);
+            if (e < eNOERROR) break;
+        }
+    }
+
+    if (nCreates != NULL) *nCreates = creates;
+
+    free(oids);
+    free(alive);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_Churn() */
+
+
+
+/*@================================
+ * bench_FileSpace()
+ *================================*/
+/*
+ * Function: Four bench_FileSpace(ObjectID*, Four*, long*)
+ *
+ * Description :
+ *  Count the pages of the file and sum up their unused bytes.
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_FileSpace(
+    ObjectID    *catObjForFile,	/* IN catalog object of the file */
+    Four        *nPages,	/* OUT # of pages of the file */
+    long        *unused)	/* OUT unused bytes of the pages */
+{
+    Four        e;		/* error */
+    sm_CatOverlayForData *catEntry; /* catalog entry of the file */
+    PageID      pid;		/* a page of the file */
+    ShortPageID nextPage;	/* next page of the file */
+    SlottedPage *apage;		/* pointer to a page of the file */
+
+
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    *nPages = 0;
+    *unused = 0;
+
+    MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+    while (pid.pageNo != NIL) {
+        e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        (*nPages)++;
+        *unused += apage->header.unused;
+        nextPage = apage->header.nextPage;
+
+        e = BfM_FreeTrain(&pid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        pid.pageNo = nextPage;
+    }
+
+    return(eNOERROR);
+
+} /* bench_FileSpace() */
+
+
+
+/*@================================
+ * bench_ParseList()
+ *================================*/
+/*
+ * Function: Four bench_ParseList(char*, Four*)
+ *
+ * Description :
+ *  Parse a list of integers separated by commas into 'values', which has
+ *  room for BENCH_MAXPARAMS values.
+ *
+ * Returns:
+ *  # of values; 0 if the list is malformed
+ */
+static Four bench_ParseList(
+    char        *str,		/* IN list of integers */
+    Four        *values)	/* OUT the integers */
+{
+    Four        n;		/* # of values parsed */
+    char        *end;		/* end of the value parsed */
+
+
+    for (n = 0; ; n++) {
+        if (n == BENCH_MAXPARAMS) return(0);
+
+        values[n] = strtol(str, &end, 10);
+        if (end == str) return(0);
+
+        if (*end == '\0') return(n + 1);
+        if (*end != ',') return(0);
+
+        str = end + 1;
+    }
+
+} /* bench_ParseList() */
+
+
+
+/*@================================
+ * bench_Suite()
+ *================================*/
+/*
+ * Function: Four bench_Suite(Four, BenchSuiteParams*)
+ *
+ * Description :
+ *  Run the microbenchmarks of the single object operations for every
+ *  combination of the object size, the fill level, and the fragmentation
+ *  ratio, through EduOM and, if requested, through the OM_* functions.
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_Suite(
+    Four        volId,		/* IN volume of the files */
+    BenchSuiteParams *params)	/* IN parameters of the suite */
+{
+    Four        e;		/* error */
+    Four        k;		/* index of the object manager */
+    Four        i, j, l;	/* index variables */
+
+
+    srand(1);
+
+    for (k = 0; k < (params->baseline ? 2 : 1); k++)
+        for (i = 0; i < params->nSizes; i++)
+            for (j = 0; j < params->nFills; j++)
+                for (l = 0; l < params->nFrags; l++) {
+                    e = bench_SuiteFile(volId, &bench_impls[k], params,
+                                        params->sizes[i], params->fills[j], params->frags[l]);
+                    if (e < eNOERROR) ERR(e);
+                }
+
+    return(eNOERROR);
+
+} /* bench_Suite() */
+
+
+
+/*@================================
+ * bench_SuiteFile()
+ *================================*/
+/*
+ * Function: Four bench_SuiteFile(Four, BenchImpl*, BenchSuiteParams*, Four, Four, Four)
+ *
+ * Description :
+ *  Build a file in a transaction, run each operation of the suite on it
+ *  once with an empty buffer pool and once more with the warm buffer pool,
+ *  and drop the file.
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_SuiteFile(
+    Four        volId,		/* IN volume of the file */
+    BenchImpl   *impl,		/* IN object manager measured */
+    BenchSuiteParams *params,	/* IN parameters of the suite */
+    Four        size,		/* IN size of the objects */
+    Four        fill,		/* IN % of the objects kept in the file */
+    Four        frag)		/* IN % of the removed objects taken from the middle */
+{
+    Four        e;		/* error */
+    Four        op;		/* operation */
+    Four        cold;		/* TRUE if the buffer pool is emptied before the run */
+    Four        nDone;		/* # of operations done in a run */
+    double      elapsed;	/* elapsed time of a run */
+    double      *latencies;	/* latency of each operation of a run */
+    BenchFile   file;		/* the file */
+    XactID      xactId;		/* transaction identifier */
+
+
+    latencies = (double*)malloc(params->nOps * sizeof(double));
+    if (latencies == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+    e = LRDS_BeginTransaction(&xactId, X_RR_RR);
+    if (e < eNOERROR) {
+        free(latencies);
+        ERR(e);
+    }
+
+    e = bench_BuildFile(volId, impl, params->nObjs, size, fill, frag, &file);
+
+    for (op = 0; e >= eNOERROR && op < BENCH_NUMOPERATIONS; op++) {
+        for (cold = TRUE; e >= eNOERROR && cold >= FALSE; cold--) {
+            e = bench_RunOperation(impl, &file, op, params->nOps, cold, &nDone, &elapsed, latencies);
+            if (e < eNOERROR) break;
+
+            bench_Report(bench_opNames[op], impl, &file, fill, frag, cold, nDone, elapsed, latencies);
+        }
+    }
+
+    if (e >= eNOERROR) e = bench_DropFile(&file);
+
+    free(latencies);
+
+    if (e < eNOERROR) {
+        (Four) LRDS_AbortTransaction(&xactId);
+        (Four) EduOM_InvalidateCatalogCache(NULL);
+        ERR(e);
+    }
+
+    e = LRDS_CommitTransaction(&xactId);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_SuiteFile() */
+
+
+
+/*@================================
+ * bench_BuildFile()
+ *================================*/
+/*
+ * Function: Four bench_BuildFile(Four, BenchImpl*, Four, Four, Four, Four, BenchFile*)
+ *
+ * Description :
+ *  Create a file of 'nObjs' objects of 'size' bytes, and destroy objects
+ *  of each page until 'fill' % of the objects remain. 'frag' % of the
+ *  objects destroyed are taken from the middle of the page, leaving holes
+ *  in the data area; the others are taken from the end of the page.
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_BuildFile(
+    Four        volId,		/* IN volume of the file */
+    BenchImpl   *impl,		/* IN object manager building the file */
+    Four        nObjs,		/* IN # of objects created */
+    Four        size,		/* IN size of the objects */
+    Four        fill,		/* IN % of the objects kept */
+    Four        frag,		/* IN % of the removed objects taken from the middle */
+    BenchFile   *file)		/* OUT the file built */
+{
+    Four        e;		/* error */
+    Four        i, t;		/* index variables */
+    Four        p;		/* index of the page group */
+    Four        m;		/* # of objects of the page */
+    Four        nMiddle;	/* # of objects destroyed in the middle of the page */
+    Four        nTail;		/* # of objects destroyed at the end of the page */
+    static char data[BENCH_MAXOBJSIZE];
+
+
+    memset(data, 'a', size);
+
+    e = SM_CreateFile(volId, &file->fid, FALSE, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &file->fid, &file->catObjForFile);
+    if (e < eNOERROR) ERR(e);
+
+    file->size = size;
+    file->nObjs = nObjs;
+    file->objs = (BenchObject*)malloc(nObjs * sizeof(BenchObject));
+    file->pageStart = (Four*)malloc(nObjs * sizeof(Four));
+    file->pageEnd = (Four*)malloc(nObjs * sizeof(Four));
+    if (file->objs == NULL || file->pageStart == NULL || file->pageEnd == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+    for (i = 0; i < nObjs; i++) {
+        e = impl->createObject(&file->catObjForFile, NULL, NULL, size, data, &file->objs[i].oid);
+        if (e < eNOERROR) ERR(e);
+
+        file->objs[i].alive = TRUE;
+    }
+
+    /*@ group the objects by the page */
+    qsort(file->objs, nObjs, sizeof(BenchObject), bench_CompareObjects);
+
+    for (i = 0, p = -1; i < nObjs; i++) {
+        if (i == 0 || file->objs[i].oid.pageNo != file->objs[i-1].oid.pageNo) {
+            p++;
+            file->pageStart[p] = i;
+        }
+        file->objs[i].page = p;
+        file->pageEnd[p] = i + 1;
+    }
+    file->nPages = p + 1;
+
+    /*@ destroy objects of each page */
+    for (p = 0; p < file->nPages; p++) {
+        m = file->pageEnd[p] - file->pageStart[p];
+        nMiddle = (m * (100 - fill) / 100) * frag / 100;
+        nTail = m * (100 - fill) / 100 - nMiddle;
+
+        /* the object at the end of the kept ones stays */
+        if (nMiddle > m - nTail - 1) {
+            nMiddle = MAX(0, m - nTail - 1);
+            nTail = m * (100 - fill) / 100 - nMiddle;
+        }
+
+        for (t = 0; t < nTail; t++) {
+            i = file->pageEnd[p] - 1 - t;
+            e = impl->destroyObject(&file->catObjForFile, &file->objs[i].oid, &dlPool, &dlHead);
+            if (e < eNOERROR) ERR(e);
+            file->objs[i].alive = FALSE;
+        }
+
+        for (t = 0; t < nMiddle; t++) {
+            i = file->pageStart[p] + t * (m - nTail - 1) / nMiddle;
+            e = impl->destroyObject(&file->catObjForFile, &file->objs[i].oid, &dlPool, &dlHead);
+            if (e < eNOERROR) ERR(e);
+            file->objs[i].alive = FALSE;
+        }
+    }
+
+    return(eNOERROR);
+
+} /* bench_BuildFile() */
+
+
+
+/*@================================
+ * bench_DropFile()
+ *================================*/
+/*
+ * Function: Four bench_DropFile(BenchFile*)
+ *
+ * Description :
+ *  Drop the file built by bench_BuildFile().
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_DropFile(
+    BenchFile   *file)		/* IN the file */
+{
+    Four        e;		/* error */
+
+
+    free(file->objs);
+    free(file->pageStart);
+    free(file->pageEnd);
+
+    e = SM_DestroyFile(&file->fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    (Four) EduOM_InvalidateCatalogCache(&file->catObjForFile);
+
+    return(eNOERROR);
+
+} /* bench_DropFile() */
+
+
+
+/*@================================
+ * bench_EmptyBufferPool()
+ *================================*/
+/*
+ * Function: Four bench_EmptyBufferPool(void)
+ *
+ * Description :
+ *  Write the dirty pages and discard all the pages of the buffer pool so
+ *  that the next run starts cold. No page may be fixed. The pages may still
+ *  be in the cache of the operating system.
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_EmptyBufferPool(void)
+{
+    Four        e;		/* error */
+
+
+    e = BfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+
+    e = BfM_DiscardAll();
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_EmptyBufferPool() */
+
+
+
+/*@================================
+ * bench_LastAlive()
+ *================================*/
+/*
+ * Function: Four bench_LastAlive(BenchFile*, Four)
+ *
+ * Description :
+ *  Return the last object of the page group 'p' not destroyed, i.e., the
+ *  object in the last slot of the page among the objects built.
+ *
+ * Returns:
+ *  index of the object; NIL if all the objects of the page are destroyed
+ */
+static Four bench_LastAlive(
+    BenchFile   *file,		/* IN the file */
+    Four        p)		/* IN index of the page group */
+{
+    Four        i;		/* index variable */
+
+
+    for (i = file->pageEnd[p] - 1; i >= file->pageStart[p]; i--)
+        if (file->objs[i].alive) return(i);
+
+    return(NIL);
+
+} /* bench_LastAlive() */
+
+
+
+/*@================================
+ * bench_RunOperation()
+ *================================*/
+/*
+ * Function: Four bench_RunOperation(BenchImpl*, BenchFile*, Four, Four, Boolean, Four*, double*, double*)
+ *
+ * Description :
+ *  Run up to 'nOps' operations 'op' on the file and measure the latency of
+ *  each. The objects operated on are chosen before the measurement:
+ *   read_*         : objects chosen at random
+ *   next/prev_scan : objects in the order of the file, from the first/last
+ *   destroy_middle : objects chosen at random which are not in the last
+ *                    slot of the page
+ *   destroy_last   : the object in the last slot of each page in turn; the
+ *                    last object of a page is kept
+ *   create_near    : near an object chosen at random
+ *   create_null    : no near object
+ *   compact        : each page holding an object built, once; the time
+ *                    includes fixing and unfixing the page
+ *
+ * Returns:
+ *  error code
+ */
+static Four bench_RunOperation(
+    BenchImpl   *impl,		/* IN object manager measured */
+    BenchFile   *file,		/* INOUT the file */
+    Four        op,		/* IN operation */
+    Four        nOps,		/* IN max # of operations */
+    Boolean     cold,		/* IN TRUE if the buffer pool is emptied first */
+    Four        *nDone,		/* OUT # of operations done */
+    double      *elapsed,	/* OUT elapsed time of the run */
+    double      *latencies)	/* OUT latency of each operation */
+{
+    Four        e;		/* error */
+    Four        n;		/* # of operations done */
+    Four        i, j;		/* index variables */
+    Four        p;		/* index of the page group */
+    Four        nTargets;	/* # of objects or pages operated on */
+    Four        start;		/* starting offset of the reads */
+    Four        length;		/* length of the reads */
+    Four        tries;		/* # of objects tried for destroy_middle */
+    Four        *targets;	/* objects or pages operated on */
+    ObjectID    cur;		/* current object of the scans */
+    ObjectID    next;		/* next object of the scans */
+    ObjectID    oid;		/* object created */
+    ObjectHdr   objHdr;		/* header of the object of the scans */
+    PageID      pid;		/* page compacted */
+    SlottedPage *apage;		/* buffer of the page compacted */
+    double      begin;		/* start time of the run */
+    double      t0;		/* start time of an operation */
+    static char buf[BENCH_MAXOBJSIZE];
+
+
+    targets = (Four*)malloc(nOps * sizeof(Four));
+    if (targets == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+    /*@ choose the objects or the pages to operate on */
+    nTargets = 0;
+    switch (op) {
+      case BENCH_READPARTIAL:
+      case BENCH_READREMAINDER:
+      case BENCH_CREATENEAR:
+        for (tries = 0; nTargets < nOps && tries < 100*nOps; tries++) {
+            i = rand() % file->nObjs;
+            if (file->objs[i].alive) targets[nTargets++] = i;
+        }
+        break;
+
+      case BENCH_DESTROYMIDDLE:
+        for (tries = 0; nTargets < nOps && tries < 100*nOps; tries++) {
+            i = rand() % file->nObjs;
+            if (file->objs[i].alive && bench_LastAlive(file, file->objs[i].page) > i) {
+                file->objs[i].alive = FALSE;
+                targets[nTargets++] = i;
+            }
+        }
+        break;
+
+      case BENCH_DESTROYLAST:
+        for (;;) {
+            for (p = 0, j = nTargets; p < file->nPages && nTargets < nOps; p++) {
+                i = bench_LastAlive(file, p);
+                if (i == NIL || i == file->pageStart[p] ||
+                    bench_LastAlive(file, p) == NIL) continue;
+
+                /* keep at least one object in the page */
+                file->objs[i].alive = FALSE;
+                if (bench_LastAlive(file, p) == NIL) {
+                    file->objs[i].alive = TRUE;
+                    continue;
+                }
+                targets[nTargets++] = i;
+            }
+            if (nTargets == nOps || nTargets == j) break;
+        }
+        break;
+
+      case BENCH_COMPACT:
+        for (p = 0; p < file->nPages && nTargets < nOps; p++)
+            if (bench_LastAlive(file, p) != NIL) targets[nTargets++] = p;
+        break;
+
+      default:
+        nTargets = nOps;
+        break;
+    }
+
+    if (cold) {
+        e = bench_EmptyBufferPool();
+        if (e < eNOERROR) {
+            free(targets);
+            ERR(e);
+        }
+    }
+
+    /*@ run the operations */
+    start = file->size / 4;
+    length = MAX(1, file->size / 2);
+    e = eNOERROR;
+
+    begin = bench_Now();
+
+    for (n = 0; n < nTargets; n++) {
+        t0 = bench_Now();
+
+        switch (op) {
+          case BENCH_READPARTIAL:
+            e = impl->readObject(&file->objs[targets[n]].oid, start, length, buf);
+            if (e >= eNOERROR && e != length) e = eBADLENGTH_OM;
+            break;
+
+          case BENCH_READREMAINDER:
+            e = impl->readObject(&file->objs[targets[n]].oid, 0, REMAINDER, buf);
+            if (e >= eNOERROR && e != file->size) e = eBADLENGTH_OM;
+            break;
+
+          case BENCH_NEXTSCAN:
+            e = impl->nextObject(&file->catObjForFile, (n == 0) ? NULL : &cur, &next, &objHdr);
+            /* the scan starts again at the end of the file */
+            if (e == EOS) e = impl->nextObject(&file->catObjForFile, NULL, &next, &objHdr);
+            cur = next;
+            break;
+
+          case BENCH_PREVSCAN:
+            e = impl->prevObject(&file->catObjForFile, (n == 0) ? NULL : &cur, &next, &objHdr);
+            if (e == EOS) e = impl->prevObject(&file->catObjForFile, NULL, &next, &objHdr);
+            cur = next;
+            break;
+
+          case BENCH_DESTROYMIDDLE:
+          case BENCH_DESTROYLAST:
+            e = impl->destroyObject(&file->catObjForFile, &file->objs[targets[n]].oid, &dlPool, &dlHead);
+            break;
+
+          case BENCH_CREATENEAR:
+            e = impl->createObject(&file->catObjForFile, &file->objs[targets[n]].oid, NULL,
+                                   file->size, buf, &oid);
+            break;
+
+          case BENCH_CREATENULL:
+            e = impl->createObject(&file->catObjForFile, NULL, NULL, file->size, buf, &oid);
+            break;
+
+          case BENCH_COMPACT:
+            i = file->pageStart[targets[n]];
+            MAKE_PAGEID(pid, file->objs[i].oid.volNo, file->objs[i].oid.pageNo);
+
+            e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+            if (e < eNOERROR) break;
+
+            e = impl->compactPage(apage, NIL);
+            if (e >= eNOERROR) e = BfM_SetDirty(&pid, PAGE_BUF);
+            if (e >= eNOERROR) e = BfM_FreeTrain(&pid, PAGE_BUF);
+            else (Four) BfM_FreeTrain(&pid, PAGE_BUF);
+            break;
+        }
+
+        latencies[n] = bench_Now() - t0;
+
+        if (e < eNOERROR) break;
+    }
+
+    *elapsed = bench_Now() - begin;
+    *nDone = n;
+
+    free(targets);
+
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_RunOperation() */
+
+
+
+/*@================================
+ * bench_CompareObjects()
+ *================================*/
+/*
+ * Function: int bench_CompareObjects(const void*, const void*)
+ *
+ * Description :
+ *  Compare two objects of a file by (page, slot) for qsort().
+ *
+ * Returns:
+ *  negative, zero, or positive
+ */
+static int bench_CompareObjects(
+    const void  *a,		/* IN an object */
+    const void  *b)		/* IN another object */
+{
+    ObjectID    *x = &((BenchObject*)a)->oid;
+    ObjectID    *y = &((BenchObject*)b)->oid;
+
+
+    if (x->pageNo != y->pageNo) return((x->pageNo < y->pageNo) ? -1 : 1);
+    if (x->slotNo != y->slotNo) return((x->slotNo < y->slotNo) ? -1 : 1);
+
+    return(0);
+
+} /* bench_CompareObjects() */
+
+
+
+/*@================================
+ * bench_CompareLatencies()
+ *================================*/
+/*
+ * Function: int bench_CompareLatencies(const void*, const void*)
+ *
+ * Description :
+ *  Compare two latencies for qsort().
+ *
+ * Returns:
+ *  negative, zero, or positive
+ */
+static int bench_CompareLatencies(
+    const void  *a,		/* IN a latency */
+    const void  *b)		/* IN another latency */
+{
+    double      x = *(double*)a;
+    double      y = *(double*)b;
+
+
+    return((x < y) ? -1 : ((x > y) ? 1 : 0));
+
+} /* bench_CompareLatencies() */
+
+
+
+/*@================================
+ * bench_Report()
+ *================================*/
+/*
+ * Function: void bench_Report(char*, BenchImpl*, BenchFile*, Four, Four, Boolean, Four, double, double*)
+ *
+ * Description :
+ *  Print the throughput and the median and 99th percentile latencies of a
+ *  run of the suite as a line of JSON. 'latencies' is sorted.
+ *
+ * Returns:
+ *  None
+ */
+static void bench_Report(
+    char        *opName,	/* IN name of the operation */
+    BenchImpl   *impl,		/* IN object manager measured */
+    BenchFile   *file,		/* IN the file */
+    Four        fill,		/* IN fill level of the file */
+    Four        frag,		/* IN fragmentation ratio of the file */
+    Boolean     cold,		/* IN TRUE if the buffer pool was emptied */
+    Four        nDone,		/* IN # of operations done */
+    double      elapsed,	/* IN elapsed time of the run */
+    double      *latencies)	/* INOUT latency of each operation */
+{
+    double      p50, p99;	/* percentiles of the latencies */
+
+
+    p50 = p99 = 0;
+    if (nDone > 0) {
+        qsort(latencies, nDone, sizeof(double), bench_CompareLatencies);
+        p50 = latencies[(nDone - 1) * 50 / 100];
+        p99 = latencies[(nDone - 1) * 99 / 100];
+    }
+
+    printf("{\"bench\": \"%s\", \"impl\": \"%s\", \"size\": %ld, \"fill\": %ld, \"frag\": %ld, "
+           "\"pool\": \"%s\", \"ops\": %ld, \"seconds\": %.6f, \"ops_per_sec\": %.0f, "
+           "\"p50_us\": %.3f, \"p99_us\": %.3f}\n",
+           opName, impl->name, (long)file->size, (long)fill, (long)frag, cold ? "cold" : "warm",
+           (long)nDone, elapsed, (elapsed > 0) ? nDone/elapsed : 0.0, p50*1e6, p99*1e6);
+
+} /* bench_Report() */
@@ -0,0 +1,455 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_BufferFront.c
+ *
+ * Description:
+ *  A thread-safe front end of the buffer manager for the readers of objects.
+ *  The buffer manager assumes a single thread, so the front end keeps the
+ *  recently read pages fixed in the buffer manager and lets several threads
+ *  fix them concurrently. The cached pages are hashed into shards, each with
+ *  its own latch; a fix of a cached page takes only the latch of its shard,
+ *  where the page is looked up in the hash buckets of the shard keyed on
+ *  (volNo, pageNo), and the fix count of a page is maintained with atomic operations, so an
+ *  unfix takes no latch at all. The buffer manager itself is called under a
+ *  latch only on a miss or an eviction, and that latch is never taken while
+ *  the latch of a shard is held, so a miss does not block the hits of its
+ *  shard while the page is read.
+ *  While the front end is enabled, EduOM_PinObject(), EduOM_ReadObject(),
+ *  and EduOM_ReadObjects() may be called by several threads at the same
+ *  time; the functions updating objects must not run concurrently with them.
+ *
+ * Exports:
+ *  Four EduOM_EnableBufferFront(Four)
+ *  Four EduOM_DisableBufferFront(void)
+ *
+ * Internal Functions:
+ *  Four eduom_FixPageForRead(PageID*, SlottedPage**, BufferFrontEntry**)
+ *  Four eduom_UnfixPageForRead(PageID*, BufferFrontEntry*)
+ */
+
+
+#include <pthread.h>
+#include "EduOM_common.h"
+#include "Util.h"		/* to get VarArray */
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+/*
+ * Typedef for a shard of the front end
+ */
+typedef struct {
+    pthread_mutex_t  latch;	/* latch of the shard */
+    BufferFrontEntry *entries;	/* entries of the shard */
+    Four             *buckets;	/* first entry of each hash bucket; NIL if empty */
+    Four             clock;	/* hand of the eviction clock */
+} BufferFrontShard;
+
+
+/*@
+ * Global variables
+ */
+static BufferFrontShard eduom_bfShards[BFRONT_NSHARDS];
+static VarArray eduom_bfEntries;	/* entries of all the shards */
+static VarArray eduom_bfBuckets;	/* hash buckets of all the shards */
+static Four eduom_bfShardSize = 0;	/* # of entries of a shard; 0 if disabled */
+static Four eduom_bfNBuckets;		/* # of hash buckets of a shard; a power of 2 */
+
+/* latch serializing the calls of the buffer manager */
+static pthread_mutex_t eduom_bfmLatch = PTHREAD_MUTEX_INITIALIZER;
+
+
+/*@
+ * Internal function prototypes
+ */
+static BufferFrontEntry *eduom_LookUpBufferFront(BufferFrontShard*, PageID*);
+
+
+/*@
+ * Macro Function Definitions
+ */
+/* hash value of the given page */
+#define BFRONT_HASH(pid) (((UFour)(pid)->pageNo * 2654435761U) ^ (UFour)(pid)->volNo)
+
+/* shard of the given page; the low bits of the hash value */
+#define BFRONT_SHARD(pid) (&eduom_bfShards[BFRONT_HASH(pid) & (BFRONT_NSHARDS-1)])
+
+/* hash bucket of the given page in its shard; the bits above those of the shard */
+#define BFRONT_BUCKET(pid) ((BFRONT_HASH(pid) / BFRONT_NSHARDS) & (eduom_bfNBuckets-1))
+
+
+
+/*@================================
+ * EduOM_EnableBufferFront()
+ *================================*/
+/*
+ * Function: Four EduOM_EnableBufferFront(Four)
+ *
+ * Description:
+ *  Enable the buffer front end which caches up to 'nPages' pages. The pages
+ *  cached stay fixed in the buffer manager, so 'nPages' must be less than
+ *  the number of buffers. This function must not be called concurrently
+ *  with the other EduOM functions.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_EnableBufferFront(
+    Four nPages)		/* IN max # of pages cached */
+{
+    Four e;			/* error */
+    Four i;			/* index variable */
+    Four shardSize;		/* # of entries of a shard */
+    Four nBuckets;		/* # of hash buckets of a shard */
+    BufferFrontEntry *entries;	/* entries of all the shards */
+    Four *buckets;		/* hash buckets of all the shards */
+
+
+    /*@ parameter checking */
+    if (nPages < 1 || eduom_bfShardSize > 0) ERR(eBADPARAMETER_OM);
+
+    shardSize = (nPages + BFRONT_NSHARDS - 1)/BFRONT_NSHARDS;
+
+    /* a bucket per entry, rounded up to a power of 2 */
+    for (nBuckets = 1; nBuckets < shardSize; nBuckets *= 2);
+
+    e = Util_initVarArray(&eduom_bfEntries, sizeof(BufferFrontEntry), shardSize*BFRONT_NSHARDS);
+    if (e < 0) ERR(e);
+
+    e = Util_initVarArray(&eduom_bfBuckets, sizeof(Four), nBuckets*BFRONT_NSHARDS);
+    if (e < 0) {
+        (void) Util_finalVarArray(&eduom_bfEntries);
+        ERR(e);
+    }
+
+    entries = (BufferFrontEntry*)eduom_bfEntries.ptr;
+    for (i = 0; i < shardSize*BFRONT_NSHARDS; i++) {
+        entries[i].pid.pageNo = NIL;
+        entries[i].pinCount = 0;
+        entries[i].refBit = 0;
+        entries[i].next = NIL;
+    }
+
+    buckets = (Four*)eduom_bfBuckets.ptr;
+    for (i = 0; i < nBuckets*BFRONT_NSHARDS; i++) buckets[i] = NIL;
+
+    for (i = 0; i < BFRONT_NSHARDS; i++) {
+        (void) pthread_mutex_init(&eduom_bfShards[i].latch, NULL);
+        eduom_bfShards[i].entries = &entries[i*shardSize];
+        eduom_bfShards[i].buckets = &buckets[i*nBuckets];
+        eduom_bfShards[i].clock = 0;
+    }
+
+    eduom_bfNBuckets = nBuckets;
+
+    eduom_bfShardSize = shardSize;
+
+    return(eNOERROR);
+
+} /* EduOM_EnableBufferFront() */
+
+
+
+/*@================================
+ * EduOM_DisableBufferFront()
+ *================================*/
+/*
+ * Function: Four EduOM_DisableBufferFront(void)
+ *
+ * Description:
+ *  Disable the buffer front end; the cached pages are freed in the buffer
+ *  manager. It must be called before the transaction ends, and it must not
+ *  be called concurrently with the other EduOM functions.
+ *
+ * Returns:
+ *  error code
+ *    ePAGEFIXED_EDUOM
+ *    some errors caused by function calls
+ */
+Four EduOM_DisableBufferFront(void)
+{
+    Four e;			/* error */
+    Four i;			/* index variable */
+    BufferFrontEntry *entries;	/* entries of all the shards */
+
+
+    if (eduom_bfShardSize == 0) return(eNOERROR);
+
+    entries = (BufferFrontEntry*)eduom_bfEntries.ptr;
+
+    /*@ all the pages must be unfixed by the readers */
+    for (i = 0; i < eduom_bfShardSize*BFRONT_NSHARDS; i++)
+        if (entries[i].pid.pageNo != NIL && entries[i].pinCount > 0) ERR(ePAGEFIXED_EDUOM);
+
+    for (i = 0; i < eduom_bfShardSize*BFRONT_NSHARDS; i++) {
+        if (entries[i].pid.pageNo == NIL) continue;
+
+        e = BfM_FreeTrain(&entries[i].pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        entries[i].pid.pageNo = NIL;
+    }
+
+    for (i = 0; i < BFRONT_NSHARDS; i++)
+        (void) pthread_mutex_destroy(&eduom_bfShards[i].latch);
+
+    eduom_bfShardSize = 0;
+
+    e = Util_finalVarArray(&eduom_bfEntries);
+    if (e < 0) ERR(e);
+
+    e = Util_finalVarArray(&eduom_bfBuckets);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_DisableBufferFront() */
+
+
+
+/*@================================
+ * eduom_FixPageForRead()
+ *================================*/
+/*
+ * Function: Four eduom_FixPageForRead(PageID*, SlottedPage**, BufferFrontEntry**)
+ *
+ * Description:
+ *  Fix the given page for reading. If the front end is enabled, the page is
+ *  fixed through the front end, where it is looked up in the hash bucket of
+ *  its shard; a page not cached replaces a page of the same shard which is
+ *  not fixed, chosen by the clock algorithm. The entry replaced is removed
+ *  from its bucket, emptied, and kept fixed while the latch of the shard is
+ *  released for the calls of the buffer manager; if another thread cached
+ *  the page meanwhile, its entry is used, and the new entry is left to be
+ *  replaced first. If every page of the shard is fixed, or the front end is
+ *  disabled, the page is fixed in the buffer manager directly. A page of a
+ *  mapped volume is not fixed at all; it is read in the mapping.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter apage
+ *     apage points to the buffer holding the page
+ *  2) parameter entry
+ *     entry is set to the entry of the front end, or NULL if the page is
+ *     fixed in the buffer manager directly
+ */
+Four eduom_FixPageForRead(
+    PageID           *pid,	/* IN page to fix */
+    SlottedPage      **apage,	/* OUT buffer holding the page */
+    BufferFrontEntry **entry)	/* OUT entry of the front end */
+{
+    Four e;			/* error */
+    Four i;			/* index variable */
+    Four *link;			/* link to an entry in a bucket chain */
+    BufferFrontShard *shard;	/* shard of the page */
+    BufferFrontEntry *victim;	/* entry replaced by the page */
+    BufferFrontEntry *cached;	/* entry caching the page */
+    PageID oldPid;		/* page replaced */
+    SlottedPage *newPage;	/* buffer holding the page read */
+
+
+    *entry = NULL;
+
+    /*@ a page of a mapped volume is read in the mapping without being fixed */
+    if (eduom_IsMappedVolume(pid->volNo)) return(eduom_GetPageForRead(pid, apage));
+
+    STAT_PIN();
+
+    if (eduom_bfShardSize > 0) {
+        shard = BFRONT_SHARD(pid);
+
+        (void) pthread_mutex_lock(&shard->latch);
+
+        /*@ look up the page in its bucket */
+        cached = eduom_LookUpBufferFront(shard, pid);
+        if (cached != NULL) {
+            (void) __atomic_add_fetch(&cached->pinCount, 1, __ATOMIC_ACQ_REL);
+            cached->refBit = 1;
+            *apage = cached->apage;
+            *entry = cached;
+
+            (void) pthread_mutex_unlock(&shard->latch);
+            return(eNOERROR);
+        }
+
+        /*@ find the entry to be replaced */
+        victim = NULL;
+        for (i = 0; i < 2*eduom_bfShardSize; i++) {
+            victim = &shard->entries[shard->clock];
+            shard->clock = (shard->clock + 1) % eduom_bfShardSize;
+
+            /* an entry being replaced by another thread is empty but fixed */
+            if (__atomic_load_n(&victim->pinCount, __ATOMIC_ACQUIRE) > 0) continue;
+            if (victim->pid.pageNo == NIL) break;
+            if (victim->refBit == 0) break;
+            victim->refBit = 0;
+        }
+        if (i == 2*eduom_bfShardSize) victim = NULL;
+
+        if (victim != NULL) {
+            /*@ empty the entry, keeping it fixed so that no other thread takes it */
+            oldPid = victim->pid;
+            if (oldPid.pageNo != NIL) {
+                for (link = &shard->buckets[BFRONT_BUCKET(&oldPid)];
+                     &shard->entries[*link] != victim; link = &shard->entries[*link].next);
+                *link = victim->next;
+            }
+            victim->pid.pageNo = NIL;
+            victim->next = NIL;
+            __atomic_store_n(&victim->pinCount, 1, __ATOMIC_RELEASE);
+
+            (void) pthread_mutex_unlock(&shard->latch);
+
+            (void) pthread_mutex_lock(&eduom_bfmLatch);
+
+            e = eNOERROR;
+            if (oldPid.pageNo != NIL) e = BfM_FreeTrain(&oldPid, PAGE_BUF);
+
+            if (e >= 0) e = EDUOM_GETTRAIN(pid, (char**)&newPage, PAGE_BUF);
+
+            (void) pthread_mutex_unlock(&eduom_bfmLatch);
+
+            (void) pthread_mutex_lock(&shard->latch);
+
+            if (e < 0) {
+                __atomic_store_n(&victim->pinCount, 0, __ATOMIC_RELEASE);
+                (void) pthread_mutex_unlock(&shard->latch);
+                ERR(e);
+            }
+
+            /*@ recheck whether another thread cached the page meanwhile */
+            cached = eduom_LookUpBufferFront(shard, pid);
+
+            victim->pid = *pid;
+            victim->apage = newPage;
+
+            /*@ insert the entry into its bucket, behind the entry found if any */
+            link = (cached != NULL) ? &cached->next : &shard->buckets[BFRONT_BUCKET(pid)];
+            victim->next = *link;
+            *link = victim - shard->entries;
+
+            if (cached != NULL) {
+                (void) __atomic_add_fetch(&cached->pinCount, 1, __ATOMIC_ACQ_REL);
+                cached->refBit = 1;
+                victim->refBit = 0;
+                __atomic_store_n(&victim->pinCount, 0, __ATOMIC_RELEASE);
+                victim = cached;
+            } else
+                victim->refBit = 1;
+
+            *apage = victim->apage;
+            *entry = victim;
+
+            (void) pthread_mutex_unlock(&shard->latch);
+            return(eNOERROR);
+        }
+
+        (void) pthread_mutex_unlock(&shard->latch);
+    }
+
+    /*@ fix the page in the buffer manager directly */
+    (void) pthread_mutex_lock(&eduom_bfmLatch);
+    e = EDUOM_GETTRAIN(pid, (char**)apage, PAGE_BUF);
+    (void) pthread_mutex_unlock(&eduom_bfmLatch);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_FixPageForRead() */
+
+
+
+/*@================================
+ * eduom_UnfixPageForRead()
+ *================================*/
+/*
+ * Function: Four eduom_UnfixPageForRead(PageID*, BufferFrontEntry*)
+ *
+ * Description:
+ *  Unfix the page fixed by eduom_FixPageForRead(). A page cached in the
+ *  front end stays fixed in the buffer manager until it is replaced.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_UnfixPageForRead(
+    PageID           *pid,	/* IN page to unfix */
+    BufferFrontEntry *entry)	/* IN entry given by eduom_FixPageForRead() */
+{
+    Four e;			/* error */
+
+
+    if (entry != NULL) {
+        (void) __atomic_sub_fetch(&entry->pinCount, 1, __ATOMIC_ACQ_REL);
+        return(eNOERROR);
+    }
+
+    if (eduom_IsMappedVolume(pid->volNo)) return(eNOERROR);
+
+    (void) pthread_mutex_lock(&eduom_bfmLatch);
+    e = BfM_FreeTrain(pid, PAGE_BUF);
+    (void) pthread_mutex_unlock(&eduom_bfmLatch);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_UnfixPageForRead() */
+
+
+
+/*@================================
+ * eduom_LookUpBufferFront()
+ *================================*/
+/*
+ * Function: BufferFrontEntry *eduom_LookUpBufferFront(BufferFrontShard*, PageID*)
+ *
+ * Description:
+ *  Look up the given page in its hash bucket of the given shard. The latch
+ *  of the shard must be held.
+ *
+ * Returns:
+ *  the first entry caching the page; NULL if the page is not cached
+ */
+static BufferFrontEntry *eduom_LookUpBufferFront(
+    BufferFrontShard *shard,	/* IN shard of the page */
+    PageID           *pid)	/* IN page to look up */
+{
+    Four i;			/* index of an entry of the shard */
+
+
+    for (i = shard->buckets[BFRONT_BUCKET(pid)]; i != NIL; i = shard->entries[i].next)
+        if (shard->entries[i].pid.pageNo == pid->pageNo && shard->entries[i].pid.volNo == pid->volNo)
+            return(&shard->entries[i]);
+
+    return(NULL);
+
+} /* eduom_LookUpBufferFront() */
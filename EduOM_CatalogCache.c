@@ -0,0 +1,200 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_CatalogCache.c
+ *
+ * Description:
+ *  Keep the catalog entries of the recently used data files in main memory
+ *  so that the operations on a file need not fix its catalog page each time.
+ *  The catalog object is still updated by the functions changing it, e.g.,
+ *  om_FileMapAddPage(); after such a change the cached entry is marked out
+ *  of date and is read again at its next use.
+ *  The cache cannot see the changes made outside EduOM, so the cached entry
+ *  of a file must be invalidated by EduOM_InvalidateCatalogCache() when the
+ *  file is dropped or when the transaction changing it is aborted.
+ *
+ * Exports:
+ *  Four EduOM_InvalidateCatalogCache(ObjectID*)
+ *
+ * Internal Functions:
+ *  Four eduom_GetCatalogEntry(ObjectID*, sm_CatOverlayForData**)
+ *  void eduom_CatalogEntryChanged(ObjectID*)
+ */
+
+
+#include "EduOM_common.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+/*@
+ * Global variables
+ */
+/* catalog entries of the recently used data files */
+static CatalogDescriptor eduom_catCache[CATCACHE_MAXFILES];
+static Four eduom_catClock = 0;		/* logical clock for LRU replacement */
+
+
+
+/*@================================
+ * eduom_GetCatalogEntry()
+ *================================*/
+/*
+ * Function: Four eduom_GetCatalogEntry(ObjectID*, sm_CatOverlayForData**)
+ *
+ * Description:
+ *  Return the catalog entry of the given data file. If the entry is not in
+ *  the cache or it is out of date, it is read from the catalog object; the
+ *  least recently used entry is replaced if the cache is full.
+ *  The entry returned is valid until the entry of another file is read.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter catEntry
+ *     catEntry points to the cached catalog entry of the file
+ */
+Four eduom_GetCatalogEntry(
+    ObjectID  *catObjForFile,	/* IN catalog object of the data file */
+    sm_CatOverlayForData **catEntry) /* OUT catalog entry of the data file */
+{
+    Four e;			/* error */
+    Four i;			/* index variable */
+    CatalogDescriptor *victim;	/* the descriptor to be replaced */
+    SlottedPage *catPage;	/* buffer page containing the catalog object */
+    sm_CatOverlayForData *entry; /* catalog entry in the catalog page */
+
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    victim = &eduom_catCache[0];
+    for (i = 0; i < CATCACHE_MAXFILES; i++) {
+        if (eduom_catCache[i].lastUsed != 0 &&
+            EQUAL_OBJECTID(eduom_catCache[i].catObjForFile, *catObjForFile)) {
+
+            if (!eduom_catCache[i].stale) {
+                eduom_catCache[i].lastUsed = ++eduom_catClock;
+                *catEntry = &eduom_catCache[i].entry;
+                return(eNOERROR);
+            }
+
+            /* the entry is read again into the same descriptor */
+            victim = &eduom_catCache[i];
+            break;
+        }
+
+        if (eduom_catCache[i].lastUsed < victim->lastUsed)
+            victim = &eduom_catCache[i];
+    }
+
+    /*@ read the catalog entry from the catalog object */
+    e = eduom_GetPageForRead((PageID*)catObjForFile, &catPage);
+    if (e < 0) ERR(e);
+
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, entry);
+
+    victim->catObjForFile = *catObjForFile;
+    victim->entry = *entry;
+    victim->stale = FALSE;
+    victim->lastUsed = ++eduom_catClock;
+
+    e = eduom_FreePageForRead((PageID*)catObjForFile);
+    if (e < 0) ERR(e);
+
+    *catEntry = &victim->entry;
+
+    return(eNOERROR);
+
+} /* eduom_GetCatalogEntry() */
+
+
+
+/*@================================
+ * eduom_CatalogEntryChanged()
+ *================================*/
+/*
+ * Function: void eduom_CatalogEntryChanged(ObjectID*)
+ *
+ * Description:
+ *  Mark the cached catalog entry of the given data file out of date after
+ *  the catalog object has been changed. The fields which do not change,
+ *  'fid', 'eff', and 'firstPage', stay valid until the entry is read again.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_CatalogEntryChanged(
+    ObjectID  *catObjForFile)	/* IN catalog object of the data file */
+{
+    Four i;			/* index variable */
+
+
+    for (i = 0; i < CATCACHE_MAXFILES; i++) {
+        if (eduom_catCache[i].lastUsed != 0 &&
+            EQUAL_OBJECTID(eduom_catCache[i].catObjForFile, *catObjForFile))
+            eduom_catCache[i].stale = TRUE;
+    }
+
+} /* eduom_CatalogEntryChanged() */
+
+
+
+/*@================================
+ * EduOM_InvalidateCatalogCache()
+ *================================*/
+/*
+ * Function: Four EduOM_InvalidateCatalogCache(ObjectID*)
+ *
+ * Description:
+ *  Discard the information about the given data file kept in main memory,
+ *  i.e., its cached catalog entry and its free space map. It must be called
+ *  when the file is dropped or when a transaction changing the file is
+ *  aborted. If 'catObjForFile' is NULL, the information about all the files
+ *  is discarded.
+ *
+ * Returns:
+ *  eNOERROR
+ */
+Four EduOM_InvalidateCatalogCache(
+    ObjectID  *catObjForFile)	/* IN catalog object of the data file; NULL for all */
+{
+    Four i;			/* index variable */
+
+
+    for (i = 0; i < CATCACHE_MAXFILES; i++) {
+        if (catObjForFile == NULL ||
+            EQUAL_OBJECTID(eduom_catCache[i].catObjForFile, *catObjForFile))
+            eduom_catCache[i].lastUsed = 0;
+    }
+
+    eduom_FsmInvalidate(catObjForFile);
+
+    return(eNOERROR);
+
+} /* EduOM_InvalidateCatalogCache() */
@@ -28,10 +28,15 @@
  * Description : 
  *  EduOM_CompactPage() reorganizes the page to make sure the unused bytes
  *  in the page are located contiguously "in the middle", between the tuples
- *  and the slot array. 
+ *  and the slot array. The prefix of a page with a prefix is chosen again
+ *  and its objects are written again with the new prefix. A page of
+ *  fixed-length objects is left as it is.
  *
  * Exports:
  *  Four EduOM_CompactPage(SlottedPage*, Two)
+ *
+ * Internal Functions:
+ *  void eduom_CompactPrefixPage(SlottedPage*, Two)
  */
 
 
@@ -41,6 +46,13 @@
 #include "EduOM_Internal.h"
 
 
+/*@
+ * Internal function prototypes
+ */
+static void eduom_CompactPrefixPage(SlottedPage*, Two);
+static Four eduom_ChoosePrefix(SlottedPage*, char*, Four, char*, Four*);
+
+
 
 /*@================================
  * EduOM_CompactPage()
@@ -59,15 +71,16 @@
  *  the beginning of the page.
  *
  *  (2) How to do?
- *  a. Save the given page into the temporary page
- *  b. FOR each nonempty slot DO
- *	Fill the original page by copying the object from the saved page
- *          to the data area of original page pointed by 'apageDataOffset'
- *	Update the slot offset
- *	Get 'apageDataOffet' to point the next moved position
+ *  a. Sort the nonempty slots except 'slotNo' by their offsets
+ *  b. Skip the objects which are already packed at the beginning of the
+ *     data area; compaction starts at the first hole
+ *  c. FOR each run of adjacent objects after the first hole DO
+ *	Move the whole run toward the beginning with one memmove()
+ *	Update the slot offsets of the objects in the run
  *     ENDFOR
- *   c. Update the 'freeStart' and 'unused' field of the page
- *   d. Return
+ *  d. Move the object of 'slotNo' to the end
+ *  e. Update the 'free' and 'unused' field of the page
+ *  f. Return
  *	
  * Returns:
  *  error code
@@ -80,53 +93,246 @@ Four EduOM_CompactPage(
     SlottedPage	*apage,		/* IN slotted page to compact */
     Two         slotNo)		/* IN slotNo to go to the end */
 {
-    SlottedPage	tpage;		/* temporay page used to save the given page */
-    Object *obj;		/* pointer to the object in the data area */
+    CompactEntry entries[SP_MAXSLOTS]; /* nonempty slots sorted by offset */
+    CompactEntry tmpEntry;	/* temporary entry used in sorting */
+    char   tobj[PAGESIZE];	/* the object of 'slotNo' saved while compacting */
     Two    apageDataOffset;	/* where the next object is to be moved */
-    Four   len;			/* length of object + length of ObjectHdr */
-    Two    lastSlot;		/* last non empty slot */
-    Two    i;			/* index variable */
+    Two    runStart;		/* offset of the run of adjacent objects */
+    Two    runEnd;		/* end offset of the run of adjacent objects */
+    Two    delta;		/* distance the run is moved by */
+    Four   len;			/* space taken by the object in the data area */
+    Four   nEntries;		/* # of entries in 'entries' */
+    Four   moved;		/* # of bytes moved */
+    Four   i, j, k;		/* index variable */
 
-    // Backup the original page to avoid overlap
-    memcpy(&tpage, apage, PAGESIZE);
 
-    // Initialize compaction starting point
-    apageDataOffset = 0;
-    lastSlot = 0;
-
-    // If slotNo is specified, save its object
-    Object *objTarget = NULL;
-    Four lenTarget = 0;
-    if (slotNo != NIL) {
-        objTarget = tpage.data + tpage.slot[-slotNo].offset;
-        lenTarget = sizeof(ObjectHdr) + ALIGNED_LENGTH(objTarget->header.length);
+    LAT_BEGIN(LAT_COMPACTPAGE);
+
+    /* an object of fixed length is put into an empty cell in place */
+    if (SP_IS_FIXED(apage)) return(eNOERROR);
+
+    if (SP_HAS_PREFIX(apage)) {
+        eduom_CompactPrefixPage(apage, slotNo);
+        return(eNOERROR);
     }
 
-    // Compact non-target objects
-    for (i = 0; i < tpage.header.nSlots; i++) {
-        if (i == slotNo) continue;
-        if (tpage.slot[-i].offset == EMPTYSLOT) continue;
+    /*@ collect the nonempty slots except 'slotNo' */
+    nEntries = 0;
+    for (i = 0; i < apage->header.nSlots; i++) {
+        if (i == slotNo || SP_OFFSET(apage, i) == EMPTYSLOT) continue;
 
-        obj = tpage.data + tpage.slot[-i].offset;
-        len = sizeof(ObjectHdr) + ALIGNED_LENGTH(obj->header.length);
+        entries[nEntries].slotNo = i;
+        entries[nEntries].offset = SP_OFFSET(apage, i);
+        entries[nEntries].len = eduom_GetObject(apage, entries[nEntries].offset, NULL, NULL);
 
-        // Copy to new position
-        memcpy(apage->data + apageDataOffset, obj, len);
-        apage->slot[-i].offset = apageDataOffset;
-        apageDataOffset += len;
-        lastSlot++;
+        /* insertion sort; the objects are usually placed in the order of slots */
+        for (j = nEntries; j > 0 && entries[j-1].offset > entries[j].offset; j--) {
+            tmpEntry = entries[j-1]; entries[j-1] = entries[j]; entries[j] = tmpEntry;
+        }
+        nEntries++;
     }
 
-    // Append target object to the end (if specified)
-    if (slotNo != NIL && objTarget) {
-        memcpy(apage->data + apageDataOffset, objTarget, lenTarget);
-        apage->slot[-slotNo].offset = apageDataOffset;
-        apageDataOffset += lenTarget;
+    /*@ save the object which goes to the end */
+    len = 0;
+    if (slotNo != NIL && SP_OFFSET(apage, slotNo) != EMPTYSLOT) {
+        len = eduom_GetObject(apage, SP_OFFSET(apage, slotNo), NULL, NULL);
+        memcpy(tobj, &(apage->data[SP_OFFSET(apage, slotNo)]), len);
     }
 
-    // Update header fields
+    /*@ skip the objects already packed at the beginning */
+    moved = 0;
+    apageDataOffset = 0;
+    for (i = 0; i < nEntries && entries[i].offset == apageDataOffset; i++)
+        apageDataOffset += entries[i].len;
+
+    /*@ move the runs of adjacent objects after the first hole */
+    while (i < nEntries) {
+        runStart = entries[i].offset;
+        runEnd = runStart + entries[i].len;
+        for (k = i + 1; k < nEntries && entries[k].offset == runEnd; k++)
+            runEnd += entries[k].len;
+
+        memmove(&(apage->data[apageDataOffset]), &(apage->data[runStart]), runEnd - runStart);
+        moved += runEnd - runStart;
+
+        delta = runStart - apageDataOffset;
+        for (; i < k; i++)
+            SET_SP_OFFSET(apage, entries[i].slotNo, entries[i].offset - delta);
+
+        apageDataOffset += runEnd - runStart;
+    }
+
+    /*@ append the saved object at the end */
+    if (len > 0) {
+        memcpy(&(apage->data[apageDataOffset]), tobj, len);
+        SET_SP_OFFSET(apage, slotNo, apageDataOffset);
+        apageDataOffset += len;
+    }
+
+    /*@ update the header fields */
     apage->header.free = apageDataOffset;
     apage->header.unused = 0;
 
+    STAT_ADD(compactions, 1);
+    STAT_ADD(compactBytes, moved + len);
+
     return(eNOERROR);
-}
\ No newline at end of file
+    
+} /* EduOM_CompactPage() */
+
+
+
+/*@================================
+ * eduom_CompactPrefixPage()
+ *================================*/
+/*
+ * Function: void eduom_CompactPrefixPage(SlottedPage*, Two)
+ *
+ * Description:
+ *  Compact a page with a prefix. The prefix is chosen again among the old
+ *  prefix and the first bytes of a few objects, and every object is
+ *  written again from the beginning of the data area with the new prefix;
+ *  the object of 'slotNo' is written last. The old prefix is among the
+ *  choices, so the objects never take more space than before.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_CompactPrefixPage(
+    SlottedPage	*apage,		/* INOUT slotted page to compact */
+    Two         slotNo)		/* IN slotNo to go to the end */
+{
+    SlottedPage tpage;		/* copy of the page before the compaction */
+    char   prefix[SP_MAXPREFIX];/* new prefix */
+    char   cand[SP_MAXPREFIX];	/* candidate of the prefix */
+    char   obj[PAGESIZE];	/* data of an object */
+    ObjectHdr objHdr;		/* header of an object */
+    Four   prefixLen;		/* length of the new prefix */
+    Four   candLen;		/* length of the candidate */
+    Four   gain;		/* bytes saved by the new prefix */
+    Four   candGain;		/* bytes saved by the candidate */
+    Four   nSlots;		/* # of slots of the page */
+    Four   offset;		/* offset of an object */
+    Four   c;			/* index of the candidate */
+    Two    i, k;		/* index variable */
+
+
+    memcpy(&tpage, apage, PAGESIZE);
+    nSlots = apage->header.nSlots;
+
+    /*@ choose the prefix; the old prefix is the first candidate */
+    prefixLen = eduom_ChoosePrefix(&tpage, SP_PREFIX(&tpage), SP_PREFIXLEN(&tpage), prefix, &gain);
+
+    for (c = 0; c < SP_PREFIXCANDIDATES; c++) {
+        i = (c * nSlots) / SP_PREFIXCANDIDATES;
+        if (SP_OFFSET(&tpage, i) == EMPTYSLOT) continue;
+
+        (Four) eduom_GetObject(&tpage, SP_OFFSET(&tpage, i), &objHdr, NULL);
+        candLen = MIN(objHdr.length, SP_MAXPREFIX);
+        eduom_ReadData(&tpage, SP_OFFSET(&tpage, i), 0, candLen, cand);
+
+        candLen = eduom_ChoosePrefix(&tpage, cand, candLen, cand, &candGain);
+        if (candGain > gain) {
+            gain = candGain;
+            prefixLen = candLen;
+            memcpy(prefix, cand, candLen);
+        }
+    }
+
+    /*@ write the prefix and the objects with it; the object of 'slotNo' goes last */
+    apage->data[0] = (char)prefixLen;
+    memcpy(SP_PREFIX(apage), prefix, prefixLen);
+    offset = 1 + prefixLen;
+
+    for (k = 0; k <= nSlots; k++) {
+        i = (k < nSlots) ? k : slotNo;
+        if (i == NIL || (k < nSlots && i == slotNo) || SP_OFFSET(&tpage, i) == EMPTYSLOT) continue;
+
+        (Four) eduom_GetObject(&tpage, SP_OFFSET(&tpage, i), &objHdr, NULL);
+        eduom_ReadData(&tpage, SP_OFFSET(&tpage, i), 0, objHdr.length, obj);
+
+        SET_SP_OFFSET(apage, i, offset);
+        offset += eduom_PutObject(apage, offset, &objHdr, obj);
+    }
+
+    apage->header.free = offset;
+    apage->header.unused = 0;
+
+    STAT_ADD(compactions, 1);
+    STAT_ADD(compactBytes, offset);
+
+} /* eduom_CompactPrefixPage() */
+
+
+
+/*@================================
+ * eduom_ChoosePrefix()
+ *================================*/
+/*
+ * Function: Four eduom_ChoosePrefix(SlottedPage*, char*, Four, char*, Four*)
+ *
+ * Description:
+ *  Find the length of the first bytes of the candidate which saves the most
+ *  bytes as the prefix of the objects of the page: an object saves the bytes
+ *  equal to the prefix, and the prefix takes its own length.
+ *
+ * Returns:
+ *  length of the prefix
+ *
+ * Side effect:
+ *  1) parameter prefix
+ *     prefix is set to the chosen prefix
+ *  2) parameter gain
+ *     gain is set to the bytes saved by the prefix
+ */
+static Four eduom_ChoosePrefix(
+    SlottedPage	*apage,		/* IN slotted page */
+    char        *cand,		/* IN candidate of the prefix */
+    Four        candLen,	/* IN length of the candidate */
+    char        *prefix,	/* OUT chosen prefix; may be 'cand' */
+    Four        *gain)		/* OUT bytes saved by the prefix */
+{
+    char   head[SP_MAXPREFIX];	/* first bytes of an object */
+    Four   nShared[SP_MAXPREFIX+1]; /* # of objects sharing just n bytes */
+    Four   nLonger;		/* # of objects sharing more than n bytes */
+    Four   saved;		/* bytes saved by the first n bytes */
+    Four   len;			/* length of the prefix */
+    Four   l;			/* # of the first bytes of an object */
+    Four   n;			/* index variable */
+    ObjectHdr objHdr;		/* header of an object */
+    Two    i;			/* index variable */
+
+
+    for (n = 0; n <= candLen; n++) nShared[n] = 0;
+
+    nLonger = 0;
+    for (i = 0; i < apage->header.nSlots; i++) {
+        if (SP_OFFSET(apage, i) == EMPTYSLOT) continue;
+
+        (Four) eduom_GetObject(apage, SP_OFFSET(apage, i), &objHdr, NULL);
+        l = MIN(objHdr.length, candLen);
+        eduom_ReadData(apage, SP_OFFSET(apage, i), 0, l, head);
+
+        for (n = 0; n < l && head[n] == cand[n]; n++);
+        nShared[n]++;
+        nLonger++;
+    }
+
+    /* the first n bytes save a byte for each object sharing more than n-1 bytes */
+    len = 0;
+    *gain = 0;
+    saved = 0;
+    for (n = 1; n <= candLen; n++) {
+        nLonger -= nShared[n-1];
+        saved += nLonger - 1;
+        if (saved > *gain) {
+            *gain = saved;
+            len = n;
+        }
+    }
+
+    if (prefix != cand) memcpy(prefix, cand, len);
+
+    return(len);
+
+} /* eduom_ChoosePrefix() */
@@ -0,0 +1,303 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_CompactPolicy.c
+ *
+ * Description:
+ *  Decide whether a page is compacted when an object is inserted into it.
+ *  By default a page having enough free space is compacted whenever its
+ *  contiguous free area is too small, so a single insertion may pay for
+ *  moving almost a whole page. The compaction policy limits the bytes moved
+ *  by the compactions of an operation and the cost of a compaction relative
+ *  to the space it gains; a page whose compaction is refused is not used by
+ *  the insertion, and its free space is recorded in the free space map as
+ *  its contiguous free area only.
+ *  With the deferred compaction, the pages whose compaction is refused and
+ *  the pages whose unused bytes reach a share of their free space are
+ *  queued, and EduOM_RunDeferredCompaction() compacts the queued pages which
+ *  are still in the buffer pool. The buffer manager assumes a single thread,
+ *  so the queue is not processed by a thread of its own; the application
+ *  calls EduOM_RunDeferredCompaction() when it is idle.
+ *
+ * Exports:
+ *  Four EduOM_SetCompactionPolicy(Four, Four, Four)
+ *  Four EduOM_RunDeferredCompaction(Four, Four*)
+ *
+ * Internal Functions:
+ *  Boolean eduom_MayCompact(SlottedPage*, Four)
+ *  void eduom_DeferCompaction(ObjectID*, PageID*, SlottedPage*, Boolean)
+ */
+
+
+#include "EduOM_common.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+/*@
+ * Global variables
+ */
+/* the compaction policy; no limit and no deferred compaction by default */
+CompactPolicy eduom_compactPolicy = { COMPACT_NOLIMIT, COMPACT_NOLIMIT, 0 };
+
+/* queue of the pages to be compacted; a ring of COMPACT_MAXDEFERRED entries */
+static DeferredCompaction eduom_deferred[COMPACT_MAXDEFERRED];
+static Four eduom_deferredHead = 0;	/* first entry of the queue */
+static Four eduom_nDeferred = 0;	/* # of entries of the queue */
+
+
+/*@
+ * Function prototypes of the buffer manager
+ */
+Four bfm_LookUp(TrainID*, Four);
+
+
+
+/*@================================
+ * EduOM_SetCompactionPolicy()
+ *================================*/
+/*
+ * Function: Four EduOM_SetCompactionPolicy(Four, Four, Four)
+ *
+ * Description:
+ *  Set the compaction policy of the insertions:
+ *   budget         : max bytes moved by the compactions of an operation
+ *   maxCost        : max bytes moved per 100 bytes gained by a compaction
+ *   deferThreshold : if not 0, the deferred compaction is on, and a page is
+ *                    queued when its unused bytes reach deferThreshold % of
+ *                    its free space
+ *  COMPACT_NOLIMIT removes the limit of 'budget' or 'maxCost'. Turning the
+ *  deferred compaction off empties the queue.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ */
+Four EduOM_SetCompactionPolicy(
+    Four      budget,		/* IN max bytes moved by an operation */
+    Four      maxCost,		/* IN max % of the bytes moved to the bytes gained */
+    Four      deferThreshold)	/* IN % of unused bytes queueing a page; 0 if off */
+{
+    /*@ parameter checking */
+    if (budget < 0 && budget != COMPACT_NOLIMIT) ERR(eBADPARAMETER_OM);
+
+    if (maxCost < 0 && maxCost != COMPACT_NOLIMIT) ERR(eBADPARAMETER_OM);
+
+    if (deferThreshold < 0 || deferThreshold > 100) ERR(eBADPARAMETER_OM);
+
+    eduom_compactPolicy.budget = budget;
+    eduom_compactPolicy.maxCost = maxCost;
+    eduom_compactPolicy.deferThreshold = deferThreshold;
+
+    if (deferThreshold == 0) eduom_nDeferred = 0;
+
+    return(eNOERROR);
+
+} /* EduOM_SetCompactionPolicy() */
+
+
+
+/*@================================
+ * EduOM_RunDeferredCompaction()
+ *================================*/
+/*
+ * Function: Four EduOM_RunDeferredCompaction(Four, Four*)
+ *
+ * Description:
+ *  Compact the queued pages in the order they were queued, until the bytes
+ *  moved would exceed 'budget'. A page which is no longer in the buffer pool
+ *  is dropped from the queue instead of being read from the disk, and so is
+ *  a page of a volume which is mapped by EduOM_MapVolume(). This
+ *  function must not be called concurrently with the other EduOM functions.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter nCompacted
+ *     nCompacted is set to the # of pages compacted
+ */
+Four EduOM_RunDeferredCompaction(
+    Four      budget,		/* IN max bytes moved; COMPACT_NOLIMIT for no limit */
+    Four      *nCompacted)	/* OUT # of pages compacted */
+{
+    Four e;			/* error */
+    Four spent;			/* bytes moved so far */
+    Four cost;			/* bytes moved by a compaction */
+    DeferredCompaction dc;	/* the first entry of the queue */
+    sm_CatOverlayForData *catEntry; /* catalog entry of the file of the page */
+    FreeSpaceMap *fsm;		/* free space map of the file */
+    SlottedPage *apage;		/* pointer to the page */
+
+
+    /*@ parameter checking */
+    if (budget < 0 && budget != COMPACT_NOLIMIT) ERR(eBADPARAMETER_OM);
+
+    if (nCompacted == NULL) ERR(eBADPARAMETER_OM);
+
+    STAT_BEGIN(STAT_OP_COMPACT);
+
+    *nCompacted = 0;
+    spent = 0;
+
+    while (eduom_nDeferred > 0) {
+        /*@ take the first entry of the queue */
+        dc = eduom_deferred[eduom_deferredHead];
+        eduom_deferredHead = (eduom_deferredHead + 1) % COMPACT_MAXDEFERRED;
+        eduom_nDeferred--;
+
+        /* the page was written out; compacting it now would cost a read */
+        if (bfm_LookUp(&dc.pid, PAGE_BUF) < 0) continue;
+
+        /* the volume was mapped after the page was queued */
+        if (eduom_IsMappedVolume(dc.pid.volNo)) continue;
+
+        e = eduom_GetCatalogEntry(&dc.catObjForFile, &catEntry);
+        if (e < 0) ERR(e);
+
+        e = BfM_GetTrain(&dc.pid, (char**)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+        STAT_PIN();
+
+        /* the page may have been compacted or removed from the file since */
+        cost = apage->header.free - apage->header.unused;
+        if (!EQUAL_FILEID(apage->header.fid, catEntry->fid) || apage->header.unused == 0)
+            cost = 0;
+
+        if (cost > 0 && budget != COMPACT_NOLIMIT && spent + cost > budget) {
+            /* the page is put back for the next run */
+            eduom_deferredHead = (eduom_deferredHead + COMPACT_MAXDEFERRED - 1) % COMPACT_MAXDEFERRED;
+            eduom_nDeferred++;
+
+            e = BfM_FreeTrain(&dc.pid, PAGE_BUF);
+            if (e < 0) ERR(e);
+            break;
+        }
+
+        if (cost > 0) {
+            EduOM_CompactPage(apage, NIL);
+            spent += cost;
+            (*nCompacted)++;
+            STAT_ADD(deferredCompactions, 1);
+
+            /* the page may have been recorded with its contiguous free area only */
+            e = eduom_GetFreeSpaceMap(&dc.catObjForFile, catEntry, &fsm);
+            if (e >= 0) e = eduom_FsmSetPage(fsm, dc.pid.pageNo, SP_FREE(apage));
+            if (e >= 0) e = BfM_SetDirty(&dc.pid, PAGE_BUF);
+            if (e < 0) ERRB1(e, &dc.pid, PAGE_BUF);
+        }
+
+        e = BfM_FreeTrain(&dc.pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* EduOM_RunDeferredCompaction() */
+
+
+
+/*@================================
+ * eduom_MayCompact()
+ *================================*/
+/*
+ * Function: Boolean eduom_MayCompact(SlottedPage*, Four)
+ *
+ * Description:
+ *  Decide whether the given page may be compacted by an operation which
+ *  has moved 'spent' bytes by compactions so far. A page of fixed-length
+ *  objects is never compacted, since its empty cells are reused in place.
+ *
+ * Returns:
+ *  TRUE if the page may be compacted
+ */
+Boolean eduom_MayCompact(
+    SlottedPage *apage,		/* IN page to be compacted */
+    Four      spent)		/* IN bytes moved by the operation so far */
+{
+    Four cost;			/* bytes moved by the compaction at most */
+
+
+    if (SP_IS_FIXED(apage)) return(TRUE);
+
+    cost = apage->header.free - apage->header.unused;
+
+    if ((eduom_compactPolicy.budget != COMPACT_NOLIMIT && spent + cost > eduom_compactPolicy.budget) ||
+        (eduom_compactPolicy.maxCost != COMPACT_NOLIMIT &&
+         cost*100 > eduom_compactPolicy.maxCost * apage->header.unused)) {
+        STAT_ADD(compactRefusals, 1);
+        return(FALSE);
+    }
+
+    return(TRUE);
+
+} /* eduom_MayCompact() */
+
+
+
+/*@================================
+ * eduom_DeferCompaction()
+ *================================*/
+/*
+ * Function: void eduom_DeferCompaction(ObjectID*, PageID*, SlottedPage*, Boolean)
+ *
+ * Description:
+ *  Queue the given page for the deferred compaction if the deferred
+ *  compaction is on and, unless 'force' is TRUE, the unused bytes of the
+ *  page reach the threshold. A page already queued is not queued again,
+ *  and nothing is queued while the queue is full. A page of fixed-length
+ *  objects is never queued.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_DeferCompaction(
+    ObjectID  *catObjForFile,	/* IN catalog object of the file of the page */
+    PageID    *pid,		/* IN page to be compacted */
+    SlottedPage *apage,		/* IN the page */
+    Boolean   force)		/* IN TRUE if the page is queued regardless of the threshold */
+{
+    Four i;			/* index variable */
+
+
+    if (eduom_compactPolicy.deferThreshold == 0 || apage->header.unused == 0 || SP_IS_FIXED(apage)) return;
+
+    if (!force && apage->header.unused*100 < eduom_compactPolicy.deferThreshold * SP_FREE(apage)) return;
+
+    if (eduom_nDeferred == COMPACT_MAXDEFERRED) return;
+
+    for (i = 0; i < eduom_nDeferred; i++)
+        if (EQUAL_PAGEID(eduom_deferred[(eduom_deferredHead + i) % COMPACT_MAXDEFERRED].pid, *pid)) return;
+
+    i = (eduom_deferredHead + eduom_nDeferred) % COMPACT_MAXDEFERRED;
+    eduom_deferred[i].catObjForFile = *catObjForFile;
+    eduom_deferred[i].pid = *pid;
+    eduom_nDeferred++;
+    STAT_ADD(compactDeferrals, 1);
+
+} /* eduom_DeferCompaction() */
@@ -30,6 +30,14 @@
  *
  * Exports:
  *  Four EduOM_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, ObjectID*)
+ *
+ * Internal Functions:
+ *  Four eduom_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, ObjectID*)
+ *  Four eduom_SelectPage(ObjectID*, FreeSpaceMap*, PageID*, ObjectHdr*, Four, Four, PageID*, SlottedPage**)
+ *  Four eduom_AllocPage(ObjectID*, sm_CatOverlayForData*, FreeSpaceMap*, PageID*, Boolean, PageID*, SlottedPage**)
+ *  Two eduom_FindEmptySlot(SlottedPage*)
+ *  void eduom_TakeSlot(SlottedPage*, Two)
+ *  Four eduom_GetUnique(PageID*, SlottedPage*, Unique*)
  */
 
 #include <string.h>
@@ -75,6 +83,7 @@
  *    eBADCATALOGOBJECT_OM
  *    eBADLENGTH_OM
  *    eBADUSERBUF_OM
+ *    eVOLUMEMAPPED_EDUOM
  *    some error codes from the lower level
  *
  * Side Effects :
@@ -94,9 +103,13 @@ Four EduOM_CreateObject(
     ObjectHdr   objectHdr;	/* ObjectHdr with tag set from parameter */
 
 
+    LAT_BEGIN(LAT_CREATEOBJECT);
+
     /*@ parameter checking */
     
     if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (eduom_IsMappedVolume(catObjForFile->volNo)) ERR(eVOLUMEMAPPED_EDUOM);
     
     if (length < 0) ERR(eBADLENGTH_OM);
 
@@ -106,19 +119,17 @@ Four EduOM_CreateObject(
 	if(ALIGNED_LENGTH(length) > LRGOBJ_THRESHOLD) ERR(eNOTSUPPORTED_EDUOM);
 
     objectHdr.properties = 0x0;
-    length = 0;
-    if(objHdr == NULL)
+    if (objHdr == NULL)
         objectHdr.tag = 0;
     else
-        objHdr->tag = objHdr->tag;
-    return eduom_CreateObject(catObjForFile,
-                       nearObj,
-                       objHdr,
-                       length,
-                       data,
-                       oid);
-
-    //return(eNOERROR);
+        objectHdr.tag = objHdr->tag;
+
+    STAT_BEGIN(STAT_OP_CREATE);
+
+    e = eduom_CreateObject(catObjForFile, nearObj, &objectHdr, length, data, oid);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
 }
 
 /*@================================
@@ -137,16 +148,29 @@ Four EduOM_CreateObject(
  *  NULL, a new page is allocated for object creation (In this case, the newly
  *  allocated page is inserted after the near page in the list of pages
  *  consiting in the file).
- *  If there is no room in the near page and the near object 'nearObj' is NULL,
- *  it trys to create a new object in the page in the available space list. If
- *  fail, then the new object will be put into the newly allocated page(In this
- *  case, the newly allocated page is appended at the tail of the list of pages
- *  cosisting in the file).
+ *  If the near object 'nearObj' is NULL, it trys to create a new object in the
+ *  page found through the free space map of the file. If fail, then the new
+ *  object will be put into the newly allocated page(In this case, the newly
+ *  allocated page is appended at the tail of the list of pages cosisting in
+ *  the file). The page last allocated so is tried before searching the map,
+ *  so that an append needs no search. If the file uses PLACEMENT_SIZECLASS,
+ *  the page is searched among the pages of the size class of the object,
+ *  and the page gets the class.
+ *  The available space lists are still maintained for the other modules, but
+ *  a page is moved between the lists only when its category changes.
+ *  A page which would have to be compacted is not used if the compaction
+ *  policy refuses the compaction; the page may be queued for the deferred
+ *  compaction instead.
+ *  A new page gets the format of the first page of the file, and the space
+ *  taken by the object depends on the format of the page it is put into.
+ *  In a file of fixed-length objects, the object is put into the cell of
+ *  its slot and gets the unique number of the page.
  *
  * Returns:
  *  error Code
  *    eBADCATALOGOBJECT_OM
  *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
  *    some errors caused by fuction calls
  */
 Four eduom_CreateObject(
@@ -158,27 +182,23 @@ Four eduom_CreateObject(
                         ObjectID	*oid)		/* OUT the object's ObjectID */
 {
     Four        e;		/* error number */
-    Four	neededSpace;	/* space needed to put new object [+ header] */
     SlottedPage *apage;		/* pointer to the slotted page buffer */
     Four        alignedLen;	/* aligned length of initial data */
     Boolean     needToAllocPage;/* Is there a need to alloc a new page? */
     PageID      pid;            /* PageID in which new object to be inserted */
     PageID      nearPid;
-    Four        firstExt;	/* first Extent No of the file */
-    Object      *obj;		/* point to the newly created object */
+    ObjectHdr   hdr;		/* header of the new object */
+    Four        objSpace;	/* space taken by the new object in the page */
+    Four        offset;		/* offset of the new object in the data area */
+    Four        slotSpace;	/* space taken by a new slot in the page */
+    Unique      unique;		/* unique number of the new object */
     Two         i;		/* index variable */
     sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
-    SlottedPage *catPage;	/* pointer to buffer containing the catalog */
     FileID      fid;		/* ID of file where the new object is placed */
-    Two         eff;		/* extent fill factor of file */
-    Boolean     isTmp;
-    PhysicalFileID pFid;
-    ShortPageID available[] =
-            {catEntry->availSpaceList10,
-             catEntry->availSpaceList20,
-             catEntry->availSpaceList30,
-             catEntry->availSpaceList40,
-             catEntry->availSpaceList50};
+    FreeSpaceMap *fsm;		/* free space map of the file */
+    Four        oldCategory;	/* available space list of the page before insertion */
+    Four        newCategory;	/* available space list of the page after insertion */
+    Four        sizeClass;	/* size class of the object; 0 if placed near 'nearObj' */
     
     /*@ parameter checking */
     
@@ -190,83 +210,446 @@ Four eduom_CreateObject(
     if(ALIGNED_LENGTH(length) > LRGOBJ_THRESHOLD) ERR(eNOTSUPPORTED_EDUOM);
 
     alignedLen = ALIGNED_LENGTH(length);
-    neededSpace = sizeof(ObjectHdr) + alignedLen + sizeof(SlottedPageSlot);
-    if((e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF)) < 0)
-        ERRB1(e, (TrainID*)catObjForFile, PAGE_BUF);
-    catEntry = (sm_CatOverlayForData*)(catPage->data + catPage->slot[-catObjForFile->slotNo].offset);
-    if (nearObj) {
-        if ((e = BfM_GetTrain((TrainID *) nearObj, (char **) &apage, PAGE_BUF)) < 0)
-            ERRB1(e, (TrainID *) catObjForFile, PAGE_BUF);
-        nearPid.pageNo = nearObj->pageNo;
-        nearPid.volNo = nearObj->volNo;
-        needToAllocPage = neededSpace > (apage->header.free + apage->header.unused);
-        if (!needToAllocPage) {
-            om_RemoveFromAvailSpaceList(catObjForFile, &nearPid, apage);
-            pid = nearPid;
-            if (neededSpace < apage->header.free)
-                EduOM_CompactPage(apage, nearObj->slotNo);
-        } else {
-            MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
-            if ((e = RDsM_PageIdToExtNo((PageID*)&pFid, &firstExt)) < 0) ERR(e);
-            if ((e = RDsM_AllocTrains(nearObj->volNo, firstExt, &nearPid, catEntry->eff, 1, PAGESIZE2, &pid)) < 0)
-                ERRB1(e, (TrainID*)nearObj, PAGE_BUF);
-            om_FileMapAddPage(catObjForFile, &nearPid, &pid);
-            BfM_GetNewTrain(&pid, (char**)&apage, PAGE_BUF);
-            apage->header.pid = pid;
-            apage->header.free = sizeof(SlottedPageHdr);
-        }
+
+    hdr.properties = objHdr->properties;
+    hdr.tag = objHdr->tag;
+    hdr.length = length;
+
+    /*@ read the catalog entry of the file */
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+
+    fid = catEntry->fid;
+
+    e = eduom_GetFreeSpaceMap(catObjForFile, catEntry, &fsm);
+    if (e < 0) ERR(e);
+
+    if (fsm->format == PAGE_FORMAT_FIXED && length != fsm->cellSize) ERR(eBADLENGTH_OM);
+
+    /*@ select the page into which the new object is inserted */
+    if (nearObj != NULL) {
+        MAKE_PAGEID(nearPid, nearObj->volNo, nearObj->pageNo);
+        sizeClass = 0;
     } else {
-        isTmp = FALSE;
-        for (i = 0; i < 5; i++) {
-            if (available[i] &&
-                (neededSpace <= (i + 1)*PAGESIZE)) {
-                pid.pageNo = available[i];
-                pid.volNo = catEntry->fid.volNo;
-                isTmp = TRUE;
-                break;
-            }
-        }
-        if(!isTmp){
-            MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
-            if ((e = RDsM_PageIdToExtNo((PageID*)&pFid, &firstExt)) < 0) ERR(e);
-            if ((e = RDsM_AllocTrains(catEntry->fid.volNo, firstExt, NULL,
-                                 catEntry->eff, 1, PAGESIZE2, &pid)) < 0)
-                ERR(e);
-            om_FileMapAddPage(catObjForFile, NULL, &pid);
-        }else {
-            if (neededSpace < apage->header.free)
-                EduOM_CompactPage(apage, NIL);
-        }
-        if ((e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF)) < 0) ERR(e);
+        MAKE_PAGEID(nearPid, fid.volNo, catEntry->lastPage);
+        sizeClass = SIZECLASS(alignedLen);
+    }
+
+    e = eduom_SelectPage(catObjForFile, fsm, (nearObj != NULL) ? &nearPid : NULL, &hdr, sizeClass, 0, &pid, &apage);
+    if (e < 0) ERR(e);
+
+    needToAllocPage = (apage == NULL) ? TRUE : FALSE;
+
+    if (needToAllocPage) {
+        /*@ allocate a new page and append it after the near page */
+        e = eduom_AllocPage(catObjForFile, catEntry, fsm, &nearPid, (nearObj == NULL) ? TRUE : FALSE, &pid, &apage);
+        if (e < 0) ERR(e);
+    }
+
+    /*@ find the slot for the new object; reuse an empty slot if any */
+    i = eduom_FindEmptySlot(apage);
+
+    eduom_StartPrefix(apage, data, length);
+
+    objSpace = eduom_PageObjectSize(apage, &hdr, data);
+    slotSpace = (i == apage->header.nSlots) ? SP_SLOTSIZE(apage) : 0;
+
+    /*@ the page moves to another available space list only if its category changes */
+    oldCategory = (needToAllocPage) ? 0 : SP_LIST_CATEGORY(apage, SP_FREE(apage));
+    newCategory = SP_LIST_CATEGORY(apage, SP_FREE(apage) - objSpace - slotSpace);
+
+    if (oldCategory != newCategory && oldCategory != 0) {
+        e = om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
+        eduom_CatalogEntryChanged(catObjForFile);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+        STAT_ADD(availListRemoves, 1);
+    }
+
+    if (SP_CFREE(apage) < objSpace + slotSpace) {
+        EduOM_CompactPage(apage, NIL);
+
+        /* the compaction may choose another prefix */
+        objSpace = eduom_PageObjectSize(apage, &hdr, data);
     }
 
+    eduom_TakeSlot(apage, i);
+
+    /*@ copy the object into the contiguous free area, or into the cell of the slot */
+    offset = SP_IS_FIXED(apage) ? SP_DATASTART(apage) + i*SP_CELLSIZE(apage) : apage->header.free;
+    (Four) eduom_PutObject(apage, offset, &hdr, data);
 
+    SET_SP_OFFSET(apage, i, offset);
+    if (offset == apage->header.free)
+        apage->header.free += objSpace;
+    else
+        apage->header.unused -= objSpace;
 
-    /* Update page metadata */
-    apage->header.nSlots++;
-    BfM_SetDirty(&pid, PAGE_BUF);
+    if (SP_IS_FIXED(apage))
+        unique = SP_FIXEDUNIQUE(apage);
+    else {
+        e = eduom_GetUnique(&pid, apage, &unique);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+        SET_SP_UNIQUE(apage, i, unique);
+    }
 
-    /* Copy object data */
-    obj = apage->data + apage->header.free;
-    apage->header.free += sizeof(ObjectHdr) + alignedLen;
-    obj->header.length = length;
-    obj->header.tag = objHdr->tag;
-    memcpy(obj->data, data, length);
+    /*@ put the page into the proper available space list */
+    if (oldCategory != newCategory && newCategory != 0) {
+        e = om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+        eduom_CatalogEntryChanged(catObjForFile);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+        STAT_ADD(availListPuts, 1);
+    }
 
-    //insert the object
-    apage->slot[-apage->header.nSlots].offset = apage->header.free;
-    om_GetUnique(&pid, &apage->slot[-apage->header.nSlots].unique);
+    if (sizeClass != 0) {
+        e = eduom_FsmSetClass(fsm, pid.pageNo, sizeClass);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+    }
 
-    /* Update oid */
-    oid->pageNo = pid.pageNo;
-    oid->volNo = pid.volNo;
-    oid->slotNo = apage->header.nSlots;
-    oid->unique = apage->slot[apage->header.nSlots].unique;
+    e = eduom_FsmSetPage(fsm, pid.pageNo, SP_FREE(apage));
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
 
-    om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+    if (oid != NULL)
+        MAKE_OBJECTID(*oid, pid.volNo, pid.pageNo, i, unique);
+
+    e = BfM_SetDirty(&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    e = BfM_FreeTrain(&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
 
-    if ((e = BfM_FreeTrain(&pid, PAGE_BUF)) < 0) ERR(e);
-    if ((e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF)) < 0) ERR(e);
     return(eNOERROR);
     
 } /* eduom_CreateObject() */
+
+
+
+/*@================================
+ * eduom_SelectPage()
+ *================================*/
+/*
+ * Function: Four eduom_SelectPage(ObjectID*, FreeSpaceMap*, PageID*, ObjectHdr*, Four, Four, PageID*, SlottedPage**)
+ *
+ * Description :
+ *  Select an existing page of the file into which an object of the given
+ *  header is put, and fix it. If 'nearPid' is not NULL, only the near page
+ *  is tried; otherwise the page is searched through the free space map among
+ *  the pages of the given size class, and the map is corrected for the pages
+ *  found out of date. Room for a new slot is always required.
+ *  A page which would have to be compacted is not selected if the compaction
+ *  policy refuses the compaction after 'spent' bytes moved by the caller; the
+ *  page may be queued for the deferred compaction instead.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter pid
+ *     pid is set to the selected page
+ *  2) parameter apage
+ *     apage is set to the buffer holding the selected page, which is fixed;
+ *     it is set to NULL if no page is selected
+ */
+Four eduom_SelectPage(
+    ObjectID    *catObjForFile,	/* IN file in which the object is to be placed */
+    FreeSpaceMap *fsm,		/* IN free space map of the file */
+    PageID      *nearPid,	/* IN page to try; NULL to search the free space map */
+    ObjectHdr   *hdr,		/* IN header of the object */
+    Four        sizeClass,	/* IN size class of the object; 0 if none */
+    Four        spent,		/* IN bytes moved by the compactions of the caller so far */
+    PageID      *pid,		/* OUT page selected */
+    SlottedPage **apage)	/* OUT buffer holding the page; NULL if none */
+{
+    Four        e;		/* error number */
+    Four        neededSpace;	/* space needed in a page of the format of the file */
+    Four        objSpace;	/* space needed in the page fixed */
+    SlottedPage *page;		/* buffer holding a page tried */
+
+
+    *apage = NULL;
+
+    if (nearPid != NULL) {
+        e = EDUOM_GETTRAIN(nearPid, (char**)&page, PAGE_BUF);
+        if (e < 0) ERR(e);
+        STAT_PIN();
+
+        objSpace = eduom_ObjectSize(SP_FORMAT(page), hdr) + SP_SLOTSIZE(page);
+
+        if (SP_FREE(page) >= objSpace &&
+            (SP_CFREE(page) >= objSpace || eduom_MayCompact(page, spent))) {
+            *pid = *nearPid;
+            *apage = page;
+
+            return(eNOERROR);
+        }
+
+        if (SP_FREE(page) >= objSpace) eduom_DeferCompaction(catObjForFile, nearPid, page, TRUE);
+
+        e = BfM_FreeTrain(nearPid, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        return(eNOERROR);
+    }
+
+    neededSpace = eduom_ObjectSize(fsm->format, hdr) + FORMAT_SLOTSIZE(fsm->format);
+
+    /* the free space map gives a page whose free space fits best */
+    for (;;) {
+        e = eduom_FsmSearch(fsm, neededSpace, sizeClass, &pid->pageNo);
+        if (e < 0) ERR(e);
+
+        if (pid->pageNo == NIL) {
+            STAT_ADD(spaceMisses, 1);
+            break;
+        }
+        pid->volNo = fsm->fid.volNo;
+
+        e = EDUOM_GETTRAIN(pid, (char**)&page, PAGE_BUF);
+        if (e < 0) ERR(e);
+        STAT_PIN();
+
+        objSpace = eduom_ObjectSize(SP_FORMAT(page), hdr) + SP_SLOTSIZE(page);
+
+        if (EQUAL_FILEID(page->header.fid, fsm->fid) && SP_FREE(page) >= objSpace) {
+            if (SP_CFREE(page) >= objSpace || eduom_MayCompact(page, spent)) {
+                *apage = page;
+
+                return(eNOERROR);
+            }
+
+            /* the compaction is refused; only the contiguous free area can be used */
+            eduom_DeferCompaction(catObjForFile, pid, page, TRUE);
+            e = eduom_FsmSetPage(fsm, pid->pageNo, SP_CFREE(page));
+        } else {
+            /*
+             * the map was out of date, or the page has the other format and the
+             * object takes more space in it; correct it and search again
+             */
+            e = eduom_FsmSetPage(fsm, pid->pageNo, EQUAL_FILEID(page->header.fid, fsm->fid) ?
+                                 MIN(SP_FREE(page), neededSpace - 1) : 0);
+        }
+        (Four) BfM_FreeTrain(pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* eduom_SelectPage() */
+
+
+
+/*@================================
+ * eduom_AllocPage()
+ *================================*/
+/*
+ * Function: Four eduom_AllocPage(ObjectID*, sm_CatOverlayForData*, FreeSpaceMap*, PageID*, Boolean, PageID*, SlottedPage**)
+ *
+ * Description :
+ *  Allocate a new page of the file, initialize it as an empty slotted page
+ *  of the format of the file, and insert it after the near page in the list
+ *  of pages of the file. The new page stays fixed for the caller, who must
+ *  set it dirty. If 'append' is TRUE, the page becomes the append page of
+ *  the free space map, so that the next appends need no search.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter pid
+ *     pid is set to the new page
+ *  2) parameter apage
+ *     apage is set to the buffer holding the new page
+ */
+Four eduom_AllocPage(
+    ObjectID    *catObjForFile,	/* IN file to which the page is added */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    FreeSpaceMap *fsm,		/* IN free space map of the file */
+    PageID      *nearPid,	/* IN the new page is placed after this page */
+    Boolean     append,		/* IN TRUE if the page is allocated by an append */
+    PageID      *pid,		/* OUT new page */
+    SlottedPage **apage)	/* OUT buffer holding the new page */
+{
+    Four        e;		/* error number */
+    Four        firstExt;	/* first Extent No of the file */
+    FileID      fid;		/* ID of the file */
+    PhysicalFileID pFid;
+    SlottedPage *page;		/* buffer holding the new page */
+
+
+    fid = catEntry->fid;
+
+    MAKE_PHYSICALFILEID(pFid, fid.volNo, catEntry->firstPage);
+    e = RDsM_PageIdToExtNo((PageID*)&pFid, &firstExt);
+    if (e < 0) ERR(e);
+
+    e = RDsM_AllocTrains(fid.volNo, firstExt, nearPid, catEntry->eff, 1, PAGESIZE2, pid);
+    if (e < 0) ERR(e);
+    STAT_ADD(pageAllocs, 1);
+
+    e = BfM_GetNewTrain(pid, (char**)&page, PAGE_BUF);
+    if (e < 0) ERR(e);
+    STAT_PIN();
+
+    /* initialize the page header */
+    page->header.pid = *pid;
+    page->header.flags = 0x0;
+    SET_PAGE_TYPE(page, SLOTTED_PAGE_TYPE);
+    page->header.flags |= FORMAT_FLAGS(fsm->format);
+    page->header.fid = fid;
+    page->header.unique = 0;
+    page->header.uniqueLimit = 0;
+    if (fsm->format == PAGE_FORMAT_FIXED) {
+        /* the objects of the page share a unique number */
+        e = eduom_GetUnique(pid, page, &SP_FIXEDUNIQUE(page));
+        if (e < 0) ERRB1(e, pid, PAGE_BUF);
+        SP_CELLSIZE(page) = fsm->cellSize;
+    }
+    page->header.nSlots = 1;
+    SET_SP_OFFSET(page, 0, EMPTYSLOT);
+    SET_SP_EMPTYSLOT_HINT(page, 0);
+    eduom_InitDataArea(page);
+    page->header.nextPage = NIL;
+    page->header.prevPage = NIL;
+    page->header.spaceListPrev = NIL;
+    page->header.spaceListNext = NIL;
+
+    e = om_FileMapAddPage(catObjForFile, nearPid, pid);
+    eduom_CatalogEntryChanged(catObjForFile);
+    if (e < 0) ERRB1(e, pid, PAGE_BUF);
+
+    /* the next appends go to the new page without searching the map */
+    if (append) eduom_FsmSetAppendPage(fsm, pid->pageNo);
+
+    *apage = page;
+
+    return(eNOERROR);
+
+} /* eduom_AllocPage() */
+
+
+
+/*@================================
+ * eduom_FindEmptySlot()
+ *================================*/
+/*
+ * Function: Two eduom_FindEmptySlot(SlottedPage*)
+ *
+ * Description :
+ *  Return the lowest empty slot of the page. If there is no empty slot, the
+ *  slot just after the slot array (i.e., nSlots) is returned.
+ *  The lowest empty slot is kept in the page header(see SP_EMPTYSLOT_HINT),
+ *  so the slot array is scanned only when the hint is not maintained yet or
+ *  it has been invalidated by other modules.
+ *
+ * Returns:
+ *  slot number for the new object
+ */
+Two eduom_FindEmptySlot(
+    SlottedPage *apage)		/* IN slotted page */
+{
+    Two         hint;		/* lowest empty slot kept in the header */
+    Two         i;		/* index variable */
+
+
+    hint = SP_EMPTYSLOT_HINT(apage);
+
+    if (hint == SP_EMPTYSLOT_NONE) return(apage->header.nSlots);
+
+    if (hint != SP_EMPTYSLOT_UNKNOWN && hint < apage->header.nSlots &&
+        SP_OFFSET(apage, hint) == EMPTYSLOT)
+        return(hint);
+
+    /* the hint is not available; scan the slot array and rebuild it */
+    for (i = 0; i < apage->header.nSlots; i++)
+        if (SP_OFFSET(apage, i) == EMPTYSLOT) break;
+
+    SET_SP_EMPTYSLOT_HINT(apage, (i < apage->header.nSlots) ? i : SP_EMPTYSLOT_NONE);
+
+    return(i);
+
+} /* eduom_FindEmptySlot() */
+
+
+
+/*@================================
+ * eduom_TakeSlot()
+ *================================*/
+/*
+ * Function: void eduom_TakeSlot(SlottedPage*, Two)
+ *
+ * Description :
+ *  Mark the slot returned by eduom_FindEmptySlot() as used. If the slot is
+ *  just after the slot array, the slot array grows by one. Otherwise the
+ *  empty slot hint advances to the next empty slot.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_TakeSlot(
+    SlottedPage *apage,		/* INOUT slotted page */
+    Two         slotNo)		/* IN slot to be used */
+{
+    Two         i;		/* index variable */
+
+
+    if (slotNo == apage->header.nSlots) {
+        apage->header.nSlots++;
+        return;
+    }
+
+    /* 'slotNo' was the lowest empty slot; find the next one */
+    for (i = slotNo + 1; i < apage->header.nSlots; i++)
+        if (SP_OFFSET(apage, i) == EMPTYSLOT) break;
+
+    SET_SP_EMPTYSLOT_HINT(apage, (i < apage->header.nSlots) ? i : SP_EMPTYSLOT_NONE);
+
+} /* eduom_TakeSlot() */
+
+
+
+/*@================================
+ * eduom_GetUnique()
+ *================================*/
+/*
+ * Function: Four eduom_GetUnique(PageID*, SlottedPage*, Unique*)
+ *
+ * Description :
+ *  Assign a unique number for a new object of the given page, which is
+ *  fixed by the caller. The page keeps a range of unique numbers reserved
+ *  from the raw disk manager in its header, [unique, uniqueLimit), and the
+ *  numbers are assigned from the range without any call of other modules;
+ *  a new range is reserved only when the range runs out.
+ *  The caller must set the page dirty.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter unique
+ *     unique is set to the unique number assigned
+ */
+Four eduom_GetUnique(
+    PageID      *pid,		/* IN page of the new object */
+    SlottedPage *apage,		/* INOUT buffer holding the page */
+    Unique      *unique)	/* OUT unique number assigned */
+{
+    Four        e;		/* error code */
+    Four        num;		/* # of unique numbers reserved */
+
+
+    if (apage->header.unique >= apage->header.uniqueLimit) {
+        e = RDsM_GetUnique(pid, &apage->header.unique, &num);
+        if (e < 0) ERR(e);
+        STAT_ADD(uniqueRefills, 1);
+
+        apage->header.uniqueLimit = apage->header.unique + num;
+    }
+
+    *unique = apage->header.unique++;
+    STAT_ADD(uniques, 1);
+
+    return(eNOERROR);
+
+} /* eduom_GetUnique() */
@@ -0,0 +1,353 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_CreateObjects.c
+ * 
+ * Description :
+ *  EduOM_CreateObjects() creates a set of new objects near the specified
+ *  object. As many objects as fit are put into a page while the page is
+ *  fixed once, so the page selection, the available space list update, and
+ *  the dirty marking are done once per page instead of once per object.
+ *
+ * Exports:
+ *  Four EduOM_CreateObjects(ObjectID*, ObjectID*, Four, ObjectHdr*, Four*, char**, ObjectID*)
+ */
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+/*@
+ * Internal function prototypes
+ */
+static Four eduom_CountObjectsFit(SlottedPage*, Four, Four, ObjectHdr*, Four*, Four*);
+
+
+
+/*@================================
+ * EduOM_CreateObjects()
+ *================================*/
+/*
+ * Function: Four EduOM_CreateObjects(ObjectID*, ObjectID*, Four, ObjectHdr*, Four*, char**, ObjectID*)
+ * 
+ * Description :
+ *  EduOM_CreateObjects() creates 'nObjs' new objects; the i-th object has
+ *  the tag of objHdrs[i] and the initial data datas[i] of lengths[i] bytes.
+ *  The objects are placed in the given order. The first objects are put
+ *  into the page holding 'nearObj', or into the page found through the free
+ *  space map of the file if 'nearObj' is NULL, and the objects which do not
+ *  fit are put into the newly allocated pages. Each page is filled as much as
+ *  possible before the next page is selected. If 'nearObj' is NULL and the
+ *  file uses PLACEMENT_SIZECLASS, a page is filled only with a run of objects
+ *  of the same size class, and it is searched among the pages of the class.
+ *  The compaction policy applies to the whole call; a page whose compaction
+ *  is refused is filled only up to its contiguous free area.
+ *  If an error occurs, the objects created before the error remain in the
+ *  file and their ObjectIDs are returned in 'oids'.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    eNOTSUPPORTED_EDUOM
+ *    eVOLUMEMAPPED_EDUOM
+ *    some error codes from the lower level
+ *
+ * Side Effects :
+ *  0) New objects are created.
+ *  1) parameter oids
+ *     oids[i] is set to the ObjectID of the i-th newly created object.
+ */
+Four EduOM_CreateObjects(
+    ObjectID  *catObjForFile,	/* IN file in which objects are to be placed */
+    ObjectID  *nearObj,		/* IN create the new objects near this object */
+    Four      nObjs,		/* IN # of objects to create */
+    ObjectHdr *objHdrs,		/* IN from which tags are to be set */
+    Four      *lengths,		/* IN amount of data of each object */
+    char      **datas,		/* IN the initial data of each object */
+    ObjectID  *oids)		/* OUT the objects' ObjectIDs */
+{
+    Four        e;		/* error number */
+    Four        k;		/* index of the object to be created next */
+    Four        nFit;		/* # of objects put into the current page */
+    Four        nRun;		/* # of objects which may be put into the current page */
+    Four        j;		/* index variable */
+    Four        contSpace;	/* contiguous space needed for the objects fit */
+    Four        objSpace;	/* space taken by an object in the page */
+    Four        offset;		/* offset of an object in the data area */
+    ObjectHdr   hdr;		/* header of an object */
+    Unique      unique;		/* unique number of an object */
+    SlottedPage *apage;		/* pointer to the slotted page buffer */
+    Boolean     needToAllocPage;/* Is there a need to alloc a new page? */
+    PageID      pid;            /* PageID in which new objects are inserted */
+    PageID      nearPid;	/* a new page is placed after this page */
+    Two         i;		/* slot of the newly created object */
+    sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
+    FileID      fid;		/* ID of file where the new objects are placed */
+    FreeSpaceMap *fsm;		/* free space map of the file */
+    Four        oldCategory;	/* available space list of the page before insertion */
+    Four        newCategory;	/* available space list of the page after insertion */
+    Four        sizeClass;	/* size class of the objects; 0 if placed near 'nearObj' */
+    Four        spent;		/* bytes moved by the compactions so far */
+
+
+    LAT_BEGIN(LAT_CREATEOBJECTS);
+
+    /*@ parameter checking */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (eduom_IsMappedVolume(catObjForFile->volNo)) ERR(eVOLUMEMAPPED_EDUOM);
+
+    if (nObjs < 0) ERR(eBADPARAMETER_OM);
+
+    if (nObjs > 0 && (lengths == NULL || datas == NULL || oids == NULL)) ERR(eBADPARAMETER_OM);
+
+    for (k = 0; k < nObjs; k++) {
+        if (lengths[k] < 0) ERR(eBADLENGTH_OM);
+
+        if (lengths[k] > 0 && datas[k] == NULL) ERR(eBADUSERBUF_OM);
+
+        /* Error check whether using not supported functionality by EduOM */
+        if (ALIGNED_LENGTH(lengths[k]) > LRGOBJ_THRESHOLD) ERR(eNOTSUPPORTED_EDUOM);
+    }
+
+    if (nObjs == 0) return(eNOERROR);
+
+    STAT_BEGIN(STAT_OP_CREATE);
+
+    /*@ read the catalog entry of the file */
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+
+    fid = catEntry->fid;
+
+    e = eduom_GetFreeSpaceMap(catObjForFile, catEntry, &fsm);
+    if (e < 0) ERR(e);
+
+    for (k = 0; fsm->format == PAGE_FORMAT_FIXED && k < nObjs; k++)
+        if (lengths[k] != fsm->cellSize) ERR(eBADLENGTH_OM);
+
+    if (nearObj != NULL)
+        MAKE_PAGEID(nearPid, nearObj->volNo, nearObj->pageNo);
+    else
+        MAKE_PAGEID(nearPid, fid.volNo, catEntry->lastPage);
+
+    spent = 0;
+
+    for (k = 0; k < nObjs; k += nFit) {
+
+        hdr.properties = 0x0;
+        hdr.tag = (objHdrs == NULL) ? 0 : objHdrs[k].tag;
+        hdr.length = lengths[k];
+
+        /* the objects of a different size class go to another page */
+        nRun = nObjs - k;
+        sizeClass = 0;
+        if (nearObj == NULL && fsm->nTrees > 1) {
+            sizeClass = SIZECLASS(ALIGNED_LENGTH(lengths[k]));
+            for (nRun = 1; k + nRun < nObjs && SIZECLASS(ALIGNED_LENGTH(lengths[k + nRun])) == sizeClass; nRun++);
+        }
+
+        /*@ select the page into which the next objects are inserted; the near page only first */
+        apage = NULL;
+        if (nearObj == NULL || k == 0) {
+            e = eduom_SelectPage(catObjForFile, fsm, (nearObj != NULL) ? &nearPid : NULL, &hdr, sizeClass, spent,
+                                 &pid, &apage);
+            if (e < 0) ERR(e);
+        }
+
+        needToAllocPage = (apage == NULL) ? TRUE : FALSE;
+
+        if (needToAllocPage) {
+            /*@ allocate a new page and append it after the near page */
+            e = eduom_AllocPage(catObjForFile, catEntry, fsm, &nearPid, (nearObj == NULL) ? TRUE : FALSE, &pid, &apage);
+            if (e < 0) ERR(e);
+
+            /* the following new pages are kept in the order of creation */
+            nearPid = pid;
+        }
+
+        /*@ decide the objects put into the page before updating it */
+        nFit = eduom_CountObjectsFit(apage, SP_FREE(apage), nRun, (objHdrs == NULL) ? NULL : &objHdrs[k],
+                                     &lengths[k], &contSpace);
+
+        /* an object which does not fit into an empty page would make a new page again and again */
+        if (nFit == 0 && needToAllocPage) {
+            (Four) BfM_SetDirty(&pid, PAGE_BUF);
+            ERRB1(eNOTSUPPORTED_EDUOM, &pid, PAGE_BUF);
+        }
+
+        /* without a compaction, only the objects fitting into the contiguous free area are put */
+        if (SP_CFREE(apage) < contSpace && !eduom_MayCompact(apage, spent)) {
+            nFit = eduom_CountObjectsFit(apage, SP_CFREE(apage), nRun, (objHdrs == NULL) ? NULL : &objHdrs[k],
+                                         &lengths[k], &contSpace);
+            eduom_DeferCompaction(catObjForFile, &pid, apage, TRUE);
+        }
+
+        /*@ the page moves to another available space list only if its category changes */
+        oldCategory = (needToAllocPage) ? 0 : SP_LIST_CATEGORY(apage, SP_FREE(apage));
+        newCategory = SP_LIST_CATEGORY(apage, SP_FREE(apage) - contSpace);
+
+        if (oldCategory != newCategory && oldCategory != 0) {
+            e = om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
+            eduom_CatalogEntryChanged(catObjForFile);
+            if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+            STAT_ADD(availListRemoves, 1);
+        }
+
+        /* compact the page at most once for all the objects */
+        if (SP_CFREE(apage) < contSpace) {
+            spent += apage->header.free - apage->header.unused;
+            EduOM_CompactPage(apage, NIL);
+        }
+
+        /*@ copy the objects into the contiguous free area, or into the cells of the slots */
+        if (nFit > 0) eduom_StartPrefix(apage, datas[k], lengths[k]);
+
+        for (j = k; j < k + nFit; j++) {
+            i = eduom_FindEmptySlot(apage);
+            eduom_TakeSlot(apage, i);
+
+            hdr.properties = 0x0;
+            hdr.tag = (objHdrs == NULL) ? 0 : objHdrs[j].tag;
+            hdr.length = lengths[j];
+
+            offset = SP_IS_FIXED(apage) ? SP_DATASTART(apage) + i*SP_CELLSIZE(apage) : apage->header.free;
+            objSpace = eduom_PutObject(apage, offset, &hdr, datas[j]);
+
+            SET_SP_OFFSET(apage, i, offset);
+            if (offset == apage->header.free)
+                apage->header.free += objSpace;
+            else
+                apage->header.unused -= objSpace;
+
+            if (SP_IS_FIXED(apage))
+                unique = SP_FIXEDUNIQUE(apage);
+            else {
+                e = eduom_GetUnique(&pid, apage, &unique);
+                if (e < 0) {
+                    (Four) BfM_SetDirty(&pid, PAGE_BUF);
+                    ERRB1(e, &pid, PAGE_BUF);
+                }
+                SET_SP_UNIQUE(apage, i, unique);
+            }
+
+            MAKE_OBJECTID(oids[j], pid.volNo, pid.pageNo, i, unique);
+        }
+
+        /*@ put the page into the proper available space list */
+        if (oldCategory != newCategory && newCategory != 0) {
+            e = om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+            eduom_CatalogEntryChanged(catObjForFile);
+            if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+            STAT_ADD(availListPuts, 1);
+        }
+
+        if (sizeClass != 0) {
+            e = eduom_FsmSetClass(fsm, pid.pageNo, sizeClass);
+            if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+        }
+
+        e = eduom_FsmSetPage(fsm, pid.pageNo, SP_FREE(apage));
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+        e = BfM_SetDirty(&pid, PAGE_BUF);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+        e = BfM_FreeTrain(&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* EduOM_CreateObjects() */
+
+
+
+/*@================================
+ * eduom_CountObjectsFit()
+ *================================*/
+/*
+ * Function: Four eduom_CountObjectsFit(SlottedPage*, Four, Four, ObjectHdr*, Four*, Four*)
+ *
+ * Description :
+ *  Count the leading objects of the given tags and lengths which fit into
+ *  the given free space of the page. 'objHdrs' may be NULL.
+ *  The empty slots of the page are reused first, and a new slot is counted
+ *  only after they are used up.
+ *
+ * Returns:
+ *  # of objects which fit into the page
+ *
+ * Side effect:
+ *  1) parameter contSpace
+ *     contSpace is set to the space occupied by the objects and the new slots
+ */
+static Four eduom_CountObjectsFit(
+    SlottedPage *apage,		/* IN slotted page */
+    Four      freeSpace,	/* IN free space of the page which may be used */
+    Four      nObjs,		/* IN # of objects */
+    ObjectHdr *objHdrs,		/* IN tags of the objects */
+    Four      *lengths,		/* IN lengths of the objects */
+    Four      *contSpace)	/* OUT space needed for the objects fit */
+{
+    Four        nEmpty;		/* # of empty slots of the page */
+    Four        needed;		/* space needed for an object */
+    Four        n;		/* # of objects fit */
+    ObjectHdr   hdr;		/* header of an object */
+    Two         i;		/* index variable */
+
+
+    nEmpty = 0;
+    i = eduom_FindEmptySlot(apage);
+    for ( ; i < apage->header.nSlots; i++)
+        if (SP_OFFSET(apage, i) == EMPTYSLOT) nEmpty++;
+
+    *contSpace = 0;
+
+    for (n = 0; n < nObjs; n++) {
+        hdr.properties = 0x0;
+        hdr.tag = (objHdrs == NULL) ? 0 : objHdrs[n].tag;
+        hdr.length = lengths[n];
+        needed = eduom_ObjectSize(SP_FORMAT(apage), &hdr);
+
+        /* a new slot is needed only after the empty slots are used up */
+        if (n >= nEmpty) needed += SP_SLOTSIZE(apage);
+
+        if (freeSpace < needed) break;
+
+        freeSpace -= needed;
+        *contSpace += needed;
+    }
+
+    return(n);
+
+} /* eduom_CountObjectsFit() */
@@ -55,19 +55,21 @@
  *  to make the contiguous space; it is done when it is needed.
  *  The page's membership to 'availSpaceList' may be changed.
  *  If the destroyed object is the only object in the page, then deallocate
- *  the page.
+ *  the page. (EduOM also destroys the data moved by an update with the
+ *  stub left in the slot of the object.)
  *
  *  (2) How to do?
  *  a. Read in the slotted page
- *  b. Remove this page from the 'availSpaceList'
+ *  b. Remove this page from the 'availSpaceList' if its category changes
  *  c. Delete the object from the page
  *  d. Update the control information: 'unused', 'freeStart', 'slot offset'
  *  e. IF no more object in this page THEN
  *	   Remove this page from the filemap List
  *	   Dealloate this page
  *    ELSE
- *	   Put this page into the proper 'availSpaceList'
+ *	   Put this page into the proper 'availSpaceList' if its category changed
  *    ENDIF
+ *    Update the free space map of the file
  * f. Return
  *
  * Returns:
@@ -75,6 +77,7 @@
  *    eBADCATALOGOBJECT_OM
  *    eBADOBJECTID_OM
  *    eBADFILEID_OM
+ *    eVOLUMEMAPPED_EDUOM
  *    some errors caused by function calls
  */
 Four EduOM_DestroyObject(
@@ -84,80 +87,214 @@ Four EduOM_DestroyObject(
     DeallocListElem *dlHead)	/* INOUT head of dealloc list */
 {
     Four        e;		/* error number */
+
+
+    LAT_BEGIN(LAT_DESTROYOBJECT);
+
+
+    /*@ Check parameters. */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (eduom_IsMappedVolume(catObjForFile->volNo)) ERR(eVOLUMEMAPPED_EDUOM);
+
+    if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+    STAT_BEGIN(STAT_OP_DESTROY);
+
+    e = eduom_DestroyObject(catObjForFile, oid, FALSE, dlPool, dlHead);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+    
+} /* EduOM_DestroyObject() */
+
+
+
+/*@================================
+ * eduom_DestroyObject()
+ *================================*/
+/*
+ * Function: Four eduom_DestroyObject(ObjectID*, ObjectID*, Boolean, Pool*, DeallocListElem*)
+ * 
+ * Description : 
+ *  Destroy the object 'oid' as described in EduOM_DestroyObject(). If
+ *  'forwarded' is TRUE, 'oid' is the data moved by an update, which has
+ *  P_FORWARDED; otherwise 'oid' is an object given to the users, and if it
+ *  is a stub left by an update, the moved data is destroyed after the stub.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    eBADFILEID_OM
+ *    some errors caused by function calls
+ */
+Four eduom_DestroyObject(
+    ObjectID *catObjForFile,	/* IN file containing the object */
+    ObjectID *oid,		/* IN object to destroy */
+    Boolean  forwarded,		/* IN TRUE if 'oid' is the data moved by an update */
+    Pool     *dlPool,		/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four        e;		/* error number */
     Two         i;		/* temporary variable */
     FileID      fid;		/* ID of file where the object was placed */
     PageID	pid;		/* page on which the object resides */
     SlottedPage *apage;		/* pointer to the buffer holding the page */
     Four        offset;		/* start offset of object in data area */
-    Object      *obj;		/* points to the object in data area */
-    Four        alignedLen;	/* aligned length of object */
+    Four        objSpace;	/* space taken by the object in data area */
     Boolean     last;		/* indicates the object is the last one */
-    SlottedPage *catPage;	/* buffer page containing the catalog object */
     sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
     DeallocListElem *dlElem;	/* pointer to element of dealloc list */
     PhysicalFileID pFid;	/* physical ID of file */
-    
-    
+    Two         nSlots;		/* # of slots after the deletion */
+    Four        oldCategory;	/* available space list of the page before deletion */
+    Four        newCategory;	/* available space list of the page after deletion */
+    FreeSpaceMap *fsm;		/* free space map of the file */
+    ObjectHdr   objHdr;		/* header of the object */
+    Boolean     moved;		/* TRUE if the object is a stub left by an update */
+    ObjectID    forward;	/* ObjectID of the data moved from the stub */
 
-    /*@ Check parameters. */
-    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
 
-    if (oid == NULL) ERR(eBADOBJECTID_OM);
+    /*@ read the catalog entry of the file */
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+
+    MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+
+    e = EDUOM_GETTRAIN(&pid, (char**)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+    STAT_PIN();
+
+    /*@ check whether the object exists */
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(oid, apage))
+        ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+
+    fid = catEntry->fid;
+    if (!EQUAL_FILEID(fid, apage->header.fid))
+        ERRB1(eBADFILEID_OM, &pid, PAGE_BUF);
+
+    e = eduom_GetFreeSpaceMap(catObjForFile, catEntry, &fsm);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    /*@ compute the free space after the deletion */
+    offset = SP_OFFSET(apage, oid->slotNo);
+    objSpace = eduom_GetObject(apage, offset, &objHdr, NULL);
+
+    /* the data moved by an update is destroyed only with its stub */
+    if (((objHdr.properties & P_FORWARDED) ? TRUE : FALSE) != forwarded)
+        ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
 
-    pid.pageNo = oid->pageNo;
-    pid.volNo = oid->volNo;
-    if (e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF) < 0)
-        ERR(e);
-
-    //remove from avail list
-    if (e = om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage) < 0)
-        ERR(e);
-    if (e = om_FileMapDeletePage(catObjForFile, &pid) < 0)
-        ERR(e);
-    BfM_FreeTrain(&pid, PAGE_BUF);
-
-    //empty offset
-    offset = apage->slot[-oid->slotNo].offset;
-    apage->slot[-oid->slotNo].offset = EMPTYSLOT;
-
-    obj = (Object*)(apage->data + offset);
-    Two freedSpace = sizeof(ObjectHdr) + ALIGNED_LENGTH(obj->header.length);
-    last = (oid->slotNo == apage->header.nSlots - 1);
+    moved = (objHdr.properties & P_MOVED) ? TRUE : FALSE;
+    if (moved) eduom_ReadData(apage, offset, 0, FORWARD_STUBLEN, (char*)&forward);
+
+    /* trailing empty slots are cut off from the slot array */
+    nSlots = apage->header.nSlots;
+    last = (oid->slotNo == nSlots - 1) ? TRUE : FALSE;
     if (last) {
-        apage->header.nSlots --;
-        freedSpace += (Two)sizeof(SlottedPageSlot);
-        apage->header.free += freedSpace;
+        STAT_ADD(destroyLastSlot, 1);
+        for (nSlots--; nSlots > 0 && SP_OFFSET(apage, nSlots-1) == EMPTYSLOT; nSlots--);
     }
+
+    oldCategory = SP_LIST_CATEGORY(apage, SP_FREE(apage));
+    if (nSlots == 0)
+        newCategory = (pid.pageNo == catEntry->firstPage) ? SP_LIST_CATEGORY(apage, PAGESIZE - SP_FIXED) : 0;
     else
-        apage->header.unused += freedSpace;
-
-    catEntry = (sm_CatOverlayForData*)catPage->data;
-    //check if page is empty and object not at start
-    if(apage->header.nSlots == 0 && pid.pageNo != catEntry->firstPage){
-        if (e = om_FileMapDeletePage(catObjForFile, &pid) < 0){
-            BfM_FreeTrain(&pid, PAGE_BUF);
-            ERR(e);
-        }
+        newCategory = SP_LIST_CATEGORY(apage, SP_FREE(apage) + objSpace +
+                                       (apage->header.nSlots - nSlots)*SP_SLOTSIZE(apage));
 
-        BfM_FreeTrain(&pid, PAGE_BUF);
-        if (e = Util_getElementFromPool(dlPool, (void**)&dlElem) < 0){
-            BfM_FreeTrain(&pid, PAGE_BUF);
-            ERR(e);
-        }
-        dlElem->type = DL_PAGE;
-        dlElem->elem.pid = pid;
-        dlElem->next = dlHead->next;
-        dlHead->next = dlElem;
+    /*@ the page leaves the available space list only if its category changes */
+    if (oldCategory != newCategory && oldCategory != 0) {
+        e = om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
+        eduom_CatalogEntryChanged(catObjForFile);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+        STAT_ADD(availListRemoves, 1);
+    }
+
+    /*@ delete the object from the page */
+    SET_SP_OFFSET(apage, oid->slotNo, EMPTYSLOT);
+
+    if (offset + objSpace == apage->header.free)
+        apage->header.free -= objSpace;
+    else
+        apage->header.unused += objSpace;
+
+    apage->header.nSlots = nSlots;
+    if (last) {
+        if (SP_EMPTYSLOT_HINT(apage) >= apage->header.nSlots)
+            SET_SP_EMPTYSLOT_HINT(apage, SP_EMPTYSLOT_NONE);
+    } else {
+        i = SP_EMPTYSLOT_HINT(apage);
+        if (i == SP_EMPTYSLOT_NONE || (i != SP_EMPTYSLOT_UNKNOWN && oid->slotNo < i))
+            SET_SP_EMPTYSLOT_HINT(apage, oid->slotNo);
     }
-    else{
-        if(e = om_PutInAvailSpaceList(catObjForFile, &pid, apage) < 0){
-            BfM_FreeTrain(&pid, PAGE_BUF);
-            ERR(e);
+
+    if (apage->header.nSlots == 0) {
+        /* no object remains; restore the initial state of an empty page */
+        apage->header.nSlots = 1;
+        SET_SP_OFFSET(apage, 0, EMPTYSLOT);
+        eduom_InitDataArea(apage);
+        SET_SP_EMPTYSLOT_HINT(apage, 0);
+
+        /* the empty page may be used by any size class */
+        e = eduom_FsmSetClass(fsm, pid.pageNo, 0);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+        if (pid.pageNo != catEntry->firstPage) {
+            /*@ the empty page is removed from the file and deallocated */
+            e = eduom_FsmSetPage(fsm, pid.pageNo, 0);
+            if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+            e = om_FileMapDeletePage(catObjForFile, &pid);
+            eduom_CatalogEntryChanged(catObjForFile);
+            if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+            e = BfM_FreeTrain(&pid, PAGE_BUF);
+            if (e < 0) ERR(e);
+
+            e = Util_getElementFromPool(dlPool, &dlElem);
+            if (e < 0) ERR(e);
+
+            dlElem->type = DL_PAGE;
+            dlElem->elem.pid = pid;
+            dlElem->next = dlHead->next;
+            dlHead->next = dlElem;
+            STAT_ADD(pageDeallocs, 1);
+
+            if (moved) {
+                e = eduom_DestroyObject(catObjForFile, &forward, TRUE, dlPool, dlHead);
+                if (e < 0) ERR(e);
+            }
+
+            return(eNOERROR);
         }
     }
 
-    BfM_SetDirty(&pid, PAGE_BUF);
-    BfM_FreeTrain(&pid, PAGE_BUF);
+    /*@ put the page into the proper available space list */
+    if (oldCategory != newCategory && newCategory != 0) {
+        e = om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+        eduom_CatalogEntryChanged(catObjForFile);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+        STAT_ADD(availListPuts, 1);
+    }
+
+    /* a page with many unused bytes is compacted later */
+    eduom_DeferCompaction(catObjForFile, &pid, apage, FALSE);
+
+    e = eduom_FsmSetPage(fsm, pid.pageNo, SP_FREE(apage));
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    e = BfM_SetDirty(&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    e = BfM_FreeTrain(&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    /*@ destroy the data moved from the stub */
+    if (moved) {
+        e = eduom_DestroyObject(catObjForFile, &forward, TRUE, dlPool, dlHead);
+        if (e < 0) ERR(e);
+    }
+
     return(eNOERROR);
     
-} /* EduOM_DestroyObject() */
+} /* eduom_DestroyObject() */
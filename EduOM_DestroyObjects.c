@@ -0,0 +1,400 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_DestroyObjects.c
+ * 
+ * Description : 
+ *  EduOM_DestroyObjects() destroys a set of objects. The objects are grouped
+ *  by the page holding them, and each page is updated once for all of its
+ *  objects.
+ *
+ * Exports:
+ *  Four EduOM_DestroyObjects(ObjectID*, Four, ObjectID*, Pool*, DeallocListElem*)
+ */
+
+#include <stdlib.h>
+#include "EduOM_common.h"
+#include "Util.h"		/* to get Pool & VarArray */
+#include "RDsM.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+/*@
+ * Internal function prototypes
+ */
+static Four eduom_DestroyObjectsInPage(ObjectID*, sm_CatOverlayForData*, FreeSpaceMap*, Four, ObjectID*, Boolean, VarArray*, Four*, Pool*, DeallocListElem*);
+static int eduom_CompareObjectIDs(const void*, const void*);
+
+
+
+/*@================================
+ * EduOM_DestroyObjects()
+ *================================*/
+/*
+ * Function: Four EduOM_DestroyObjects(ObjectID*, Four, ObjectID*, Pool*, DeallocListElem*)
+ * 
+ * Description : 
+ *  EduOM_DestroyObjects() destroys the 'nObjs' objects given in 'oids'.
+ *  The ObjectIDs are sorted by (volNo, pageNo, slotNo) so that the objects
+ *  in the same page are deleted while the page is fixed once. For each page,
+ *  the header is updated once, and the page is reclassified in the
+ *  available space lists at most once. The pages which become empty are
+ *  removed from the file and put into the dealloc list, except the first
+ *  page of the file.
+ *  The ObjectIDs of a page are all checked before the page is updated; if
+ *  an error occurs, the pages processed before the error remain updated.
+ *  The data moved by updates from the stubs destroyed is destroyed in the
+ *  same way after all the stubs, even if an error occurs.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    eBADOBJECTID_OM
+ *    eBADFILEID_OM
+ *    eVOLUMEMAPPED_EDUOM
+ *    some errors caused by function calls
+ */
+Four EduOM_DestroyObjects(
+    ObjectID *catObjForFile,	/* IN file containing the objects */
+    Four     nObjs,		/* IN # of objects to destroy */
+    ObjectID *oids,		/* IN objects to destroy */
+    Pool     *dlPool,		/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four        e;		/* error number */
+    Four        k;		/* index of the first object of the current page */
+    Four        end;		/* index after the last object of the current page */
+    Four        j;		/* index variable */
+    VarArray    sorted;		/* ObjectIDs sorted by the page */
+    ObjectID    *soids;		/* entries of 'sorted' */
+    VarArray    moved;		/* data moved from the stubs destroyed */
+    Four        nMoved;		/* # of entries used in 'moved' */
+    Four        e2;		/* error of the destruction of the moved data */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+    FreeSpaceMap *fsm;		/* free space map of the file */
+
+
+    LAT_BEGIN(LAT_DESTROYOBJECTS);
+
+    /*@ Check parameters. */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (eduom_IsMappedVolume(catObjForFile->volNo)) ERR(eVOLUMEMAPPED_EDUOM);
+
+    if (nObjs < 0 || (nObjs > 0 && oids == NULL)) ERR(eBADPARAMETER_OM);
+
+    if (nObjs == 0) return(eNOERROR);
+
+    STAT_BEGIN(STAT_OP_DESTROY);
+
+    /*@ sort the ObjectIDs by the page */
+    e = Util_initVarArray(&sorted, sizeof(ObjectID), nObjs);
+    if (e < 0) ERR(e);
+
+    soids = (ObjectID*)sorted.ptr;
+    for (j = 0; j < nObjs; j++) soids[j] = oids[j];
+
+    qsort(soids, nObjs, sizeof(ObjectID), eduom_CompareObjectIDs);
+
+    /*@ read the catalog entry of the file */
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) {
+        (Four) Util_finalVarArray(&sorted);
+        ERR(e);
+    }
+
+    e = eduom_GetFreeSpaceMap(catObjForFile, catEntry, &fsm);
+
+    /*@ destroy the objects page by page */
+    moved.nEntries = 0;
+    moved.ptr = NULL;
+    nMoved = 0;
+    for (k = 0; e >= 0 && k < nObjs; k = end) {
+
+        for (end = k + 1; end < nObjs && soids[end].volNo == soids[k].volNo &&
+             soids[end].pageNo == soids[k].pageNo; end++);
+
+        e = eduom_DestroyObjectsInPage(catObjForFile, catEntry, fsm, end - k, &soids[k], FALSE,
+                                       &moved, &nMoved, dlPool, dlHead);
+    }
+
+    /*@ destroy the data moved from the stubs destroyed in the same way */
+    if (nMoved > 0) {
+        soids = (ObjectID*)moved.ptr;
+        qsort(soids, nMoved, sizeof(ObjectID), eduom_CompareObjectIDs);
+
+        for (k = 0, e2 = eNOERROR; e2 >= 0 && k < nMoved; k = end) {
+
+            for (end = k + 1; end < nMoved && soids[end].volNo == soids[k].volNo &&
+                 soids[end].pageNo == soids[k].pageNo; end++);
+
+            e2 = eduom_DestroyObjectsInPage(catObjForFile, catEntry, fsm, end - k, &soids[k], TRUE,
+                                            NULL, NULL, dlPool, dlHead);
+        }
+        if (e >= 0) e = e2;
+    }
+
+    if (moved.ptr != NULL) (Four) Util_finalVarArray(&moved);
+    (Four) Util_finalVarArray(&sorted);
+
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_DestroyObjects() */
+
+
+
+/*@================================
+ * eduom_DestroyObjectsInPage()
+ *================================*/
+/*
+ * Function: Four eduom_DestroyObjectsInPage(ObjectID*, sm_CatOverlayForData*, FreeSpaceMap*, Four, ObjectID*, Boolean, VarArray*, Four*, Pool*, DeallocListElem*)
+ * 
+ * Description : 
+ *  Destroy the given objects which reside in the same page; the ObjectIDs
+ *  are sorted by the slot number. The page is not updated at all unless all
+ *  the ObjectIDs are valid. If 'forwarded' is TRUE, the objects are the
+ *  data moved by updates; otherwise they are objects given to the users,
+ *  and the ObjectIDs of the data moved from the stubs among them are
+ *  appended to 'moved'.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    eBADFILEID_OM
+ *    some errors caused by function calls
+ */
+static Four eduom_DestroyObjectsInPage(
+    ObjectID *catObjForFile,	/* IN file containing the objects */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    FreeSpaceMap *fsm,		/* INOUT free space map of the file */
+    Four     nObjs,		/* IN # of objects to destroy */
+    ObjectID *oids,		/* IN objects to destroy sorted by the slot number */
+    Boolean  forwarded,		/* IN TRUE if the objects are the data moved by updates */
+    VarArray *moved,		/* INOUT data moved from the stubs destroyed */
+    Four     *nMoved,		/* INOUT # of entries used in 'moved' */
+    Pool     *dlPool,		/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four        e;		/* error number */
+    Four        j;		/* index variable */
+    Two         i;		/* index variable */
+    PageID	pid;		/* page on which the objects reside */
+    SlottedPage *apage;		/* pointer to the buffer holding the page */
+    Four        freed;		/* space freed by the deletion */
+    Four        dataEnd;	/* end of the last object remaining in the page */
+    Two         nSlots;		/* # of slots after the deletion */
+    Two         hint;		/* lowest empty slot after the deletion */
+    DeallocListElem *dlElem;	/* pointer to element of dealloc list */
+    Four        oldCategory;	/* available space list of the page before deletion */
+    Four        newCategory;	/* available space list of the page after deletion */
+    ObjectHdr   objHdr;		/* header of an object */
+    Four        nStubs;		/* # of stubs among the objects */
+
+
+    MAKE_PAGEID(pid, oids[0].volNo, oids[0].pageNo);
+
+    e = EDUOM_GETTRAIN(&pid, (char**)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+    STAT_PIN();
+
+    /*@ check all the objects of the page before updating it */
+    if (!EQUAL_FILEID(catEntry->fid, apage->header.fid)) ERRB1(eBADFILEID_OM, &pid, PAGE_BUF);
+
+    freed = 0;
+    nStubs = 0;
+    for (j = 0; j < nObjs; j++) {
+        if (oids[j].slotNo < 0 || oids[j].slotNo >= apage->header.nSlots ||
+            !IS_VALID_OBJECTID(&oids[j], apage) ||
+            (j > 0 && oids[j].slotNo == oids[j-1].slotNo))
+            ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+
+        freed += eduom_GetObject(apage, SP_OFFSET(apage, oids[j].slotNo), &objHdr, NULL);
+
+        /* the data moved by an update is destroyed only with its stub */
+        if (((objHdr.properties & P_FORWARDED) ? TRUE : FALSE) != forwarded)
+            ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+
+        if (objHdr.properties & P_MOVED) nStubs++;
+    }
+
+    /*@ keep the data moved from the stubs, which is destroyed later */
+    if (nStubs > 0) {
+        if (*nMoved + nStubs > moved->nEntries) {
+            if (moved->ptr == NULL)
+                e = Util_initVarArray(moved, sizeof(ObjectID), MAX(nStubs, nObjs));
+            else
+                e = Util_reallocVarArray(moved, sizeof(ObjectID), MAX(*nMoved + nStubs, 2*moved->nEntries));
+            if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+        }
+
+        for (j = 0; j < nObjs; j++) {
+            (Four) eduom_GetObject(apage, SP_OFFSET(apage, oids[j].slotNo), &objHdr, NULL);
+            if (objHdr.properties & P_MOVED)
+                eduom_ReadData(apage, SP_OFFSET(apage, oids[j].slotNo), 0, FORWARD_STUBLEN,
+                               (char*)&((ObjectID*)moved->ptr)[(*nMoved)++]);
+        }
+    }
+
+    /*@ delete the objects from the slot array */
+    for (j = 0; j < nObjs; j++)
+        SET_SP_OFFSET(apage, oids[j].slotNo, EMPTYSLOT);
+
+    /* trailing empty slots are cut off from the slot array */
+    for (nSlots = apage->header.nSlots; nSlots > 0 && SP_OFFSET(apage, nSlots-1) == EMPTYSLOT; nSlots--);
+    if (nSlots < apage->header.nSlots) STAT_ADD(destroyLastSlot, 1);
+
+    /*@ the page moves to another available space list only if its category changes */
+    oldCategory = SP_LIST_CATEGORY(apage, SP_FREE(apage));
+    if (nSlots == 0)
+        newCategory = (pid.pageNo == catEntry->firstPage) ? SP_LIST_CATEGORY(apage, PAGESIZE - SP_FIXED) : 0;
+    else
+        newCategory = SP_LIST_CATEGORY(apage, SP_FREE(apage) + freed +
+                                       (apage->header.nSlots - nSlots)*SP_SLOTSIZE(apage));
+
+    if (oldCategory != newCategory && oldCategory != 0) {
+        e = om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
+        eduom_CatalogEntryChanged(catObjForFile);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+        STAT_ADD(availListRemoves, 1);
+    }
+
+    /*@ update the page header once for all the objects */
+    apage->header.unused += freed;
+    apage->header.nSlots = nSlots;
+
+    if (nSlots == 0) {
+        /* no object remains; restore the initial state of an empty page */
+        apage->header.nSlots = 1;
+        SET_SP_OFFSET(apage, 0, EMPTYSLOT);
+        eduom_InitDataArea(apage);
+        SET_SP_EMPTYSLOT_HINT(apage, 0);
+
+        /* the empty page may be used by any size class */
+        e = eduom_FsmSetClass(fsm, pid.pageNo, 0);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+        if (pid.pageNo != catEntry->firstPage) {
+            /*@ the empty page is removed from the file and deallocated */
+            e = eduom_FsmSetPage(fsm, pid.pageNo, 0);
+            if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+            e = om_FileMapDeletePage(catObjForFile, &pid);
+            eduom_CatalogEntryChanged(catObjForFile);
+            if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+            e = BfM_FreeTrain(&pid, PAGE_BUF);
+            if (e < 0) ERR(e);
+
+            e = Util_getElementFromPool(dlPool, &dlElem);
+            if (e < 0) ERR(e);
+
+            dlElem->type = DL_PAGE;
+            dlElem->elem.pid = pid;
+            dlElem->next = dlHead->next;
+            dlHead->next = dlElem;
+            STAT_ADD(pageDeallocs, 1);
+
+            return(eNOERROR);
+        }
+    } else {
+        /* the objects at the end of the data area go back to the contiguous free area */
+        dataEnd = SP_DATASTART(apage);
+        for (i = 0; i < nSlots; i++) {
+            if (SP_OFFSET(apage, i) == EMPTYSLOT) continue;
+
+            dataEnd = MAX(dataEnd, SP_OFFSET(apage, i) + eduom_GetObject(apage, SP_OFFSET(apage, i), NULL, NULL));
+        }
+
+        apage->header.unused -= apage->header.free - dataEnd;
+        apage->header.free = dataEnd;
+
+        /* the lowest deleted slot may become the lowest empty slot */
+        hint = SP_EMPTYSLOT_HINT(apage);
+        if (hint != SP_EMPTYSLOT_UNKNOWN && oids[0].slotNo < nSlots &&
+            (hint == SP_EMPTYSLOT_NONE || oids[0].slotNo < hint))
+            hint = oids[0].slotNo;
+        if (hint != SP_EMPTYSLOT_UNKNOWN && hint != SP_EMPTYSLOT_NONE && hint >= nSlots)
+            hint = SP_EMPTYSLOT_NONE;
+        SET_SP_EMPTYSLOT_HINT(apage, hint);
+    }
+
+    /*@ put the page into the proper available space list */
+    if (oldCategory != newCategory && newCategory != 0) {
+        e = om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+        eduom_CatalogEntryChanged(catObjForFile);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+        STAT_ADD(availListPuts, 1);
+    }
+
+    /* a page with many unused bytes is compacted later */
+    eduom_DeferCompaction(catObjForFile, &pid, apage, FALSE);
+
+    e = eduom_FsmSetPage(fsm, pid.pageNo, SP_FREE(apage));
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    e = BfM_SetDirty(&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    e = BfM_FreeTrain(&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_DestroyObjectsInPage() */
+
+
+
+/*@================================
+ * eduom_CompareObjectIDs()
+ *================================*/
+/*
+ * Function: int eduom_CompareObjectIDs(const void*, const void*)
+ *
+ * Description :
+ *  Compare two ObjectIDs by (volNo, pageNo, slotNo); used by qsort().
+ *
+ * Returns:
+ *  negative, 0, or positive as the first one is less than, equal to, or
+ *  greater than the second one
+ */
+static int eduom_CompareObjectIDs(
+    const void *a,		/* IN an ObjectID */
+    const void *b)		/* IN another ObjectID */
+{
+    const ObjectID *x = (const ObjectID*)a;
+    const ObjectID *y = (const ObjectID*)b;
+
+
+    if (x->volNo != y->volNo) return((x->volNo < y->volNo) ? -1 : 1);
+    if (x->pageNo != y->pageNo) return((x->pageNo < y->pageNo) ? -1 : 1);
+    if (x->slotNo != y->slotNo) return((x->slotNo < y->slotNo) ? -1 : 1);
+
+    return(0);
+
+} /* eduom_CompareObjectIDs() */
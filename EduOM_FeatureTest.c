@@ -0,0 +1,2167 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_FeatureTest.c
+ *
+ * Description :
+ *  Test the functions added to EduOM and show the result of the test.
+ *  It is linked with EduOM_TestModule.c in place of EduOM_Test.c, and its
+ *  output is compared with test/feature_solution.txt by test/checker.py.
+ *  Each test prints the objects it reads with a check of their data, and
+ *  the space accounting of the pages it changes.
+ *
+ * Exports:
+ *  Four EduOM_Test(Four, Four, Boolean)
+ */
+#include <string.h>
+#include "EduOM_common.h"
+#include "EduOM.h"
+#include "EduOM_Internal.h"
+#include "EduOM_TestModule.h"
+
+
+#define FTEST_MAXOBJECTS    64      /* max # of objects kept by a test */
+#define FTEST_CELLSIZE      400     /* length of the objects of the file of fixed-length objects */
+
+
+static Four eduom_TestUpdate(Four);
+static Four eduom_TestPageFormatV2(Four);
+static Four eduom_TestPrefix(Four);
+static Four eduom_TestCreateObjects(Four);
+static Four eduom_TestFixedLength(Four);
+static Four eduom_TestSizeClass(Four);
+static Four eduom_TestCompactionPolicy(Four);
+static Four eduom_TestAppendPage(Four);
+static void eduom_FillData(char*, Four, Four);
+static Boolean eduom_CheckData(char*, Four, Four, Four);
+static void eduom_FillKeyData(char*, char*, Four, Four);
+static Boolean eduom_CheckKeyData(char*, char*, Four, Four, Four);
+static Four eduom_PrintPageSpace(PageID*);
+static Four eduom_PrintObject(ObjectID*, Four);
+static Four eduom_PrintObjectV2(ObjectID*, Four);
+static Four eduom_PrintPrefix(PageID*);
+static Four eduom_PrintPrefixObject(ObjectID*, char*, Four);
+static Four eduom_PrintCells(PageID*);
+static Four eduom_PrintScans(ObjectID*);
+static void eduom_PrintCompactions(void);
+static void eduom_PrintPlacements(void);
+static Four eduom_GetForward(ObjectID*, ObjectID*);
+static char *eduom_ErrorName(Four);
+static Four eduom_ScanCallback(Four, ObjectID*, ObjectHdr*, const char*, void*);
+
+
+/*@================================
+ * EduOM_Test()
+ *================================*/
+/*
+ * Function: EduOM_Test(Four volId, Four handle, Boolean getcharFlag)
+ *
+ * Description :
+ *  Show a result of the tests of the functions added to EduOM.
+ *  TEST#5 tests EduOM_UpdateObject() and EduOM_WriteObject(), and how the
+ *  objects moved by them are read, scanned, and destroyed.
+ *  TEST#6 tests the objects of the pages of the format v2.
+ *  TEST#7 tests the prefix of the pages with a prefix, chosen again by a
+ *  compaction, and the reads of the objects across the end of the prefix.
+ *  TEST#8 tests EduOM_CreateObjects().
+ *  TEST#9 tests the files of fixed-length objects.
+ *  TEST#10 tests the placement of the objects by their size classes.
+ *  TEST#11 tests the compaction policy and the deferred compaction.
+ *  TEST#12 tests the append page of the insertions without a near object.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four EduOM_Test(Four volId, Four handle, Boolean getcharFlag){
+
+  Four 		e;										/* for errors */
+
+  printf("Loading EduOM_FeatureTest() complete...\n");
+
+  e = eduom_TestUpdate(volId);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_TestPageFormatV2(volId);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_TestPrefix(volId);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_TestCreateObjects(volId);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_TestFixedLength(volId);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_TestSizeClass(volId);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_TestCompactionPolicy(volId);
+  if (e < eNOERROR) ERR(e);
+
+  e = eduom_TestAppendPage(volId);
+  if (e < eNOERROR) ERR(e);
+
+  return(eNOERROR);
+}
+
+
+
+/*@================================
+ * eduom_TestUpdate()
+ *================================*/
+/*
+ * Function: Four eduom_TestUpdate(Four)
+ *
+ * Description :
+ *  Test EduOM_UpdateObject() and EduOM_WriteObject(): an update shrinking
+ *  an object, growing it in its page, moving it to another page with a
+ *  stub left in its slot, and moving it back; the reads and the scans
+ *  following the stub and rejecting the ObjectID of the moved data; the
+ *  destroy of a moved object; an update with no room for the stub.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_TestUpdate(
+    Four        volId)          /* IN volume of the test file */
+{
+  Four 		e;										/* for errors */
+  Four		i;										/* loop index */
+  Four		n;										/* # of objects */
+  FileID      fid;									/* file identifier */
+  ObjectID    catalogEntry;							/* catalog object */
+  ObjectID	oidA, oidB, oidC;						/* objects updated by the tests */
+  ObjectID	forward;								/* moved data of an object */
+  ObjectID	oid, nextOid;							/* object identifiers */
+  ObjectID	fillers[FTEST_MAXOBJECTS];				/* objects filling the page */
+  Four		nFillers;								/* # of fillers */
+  ObjectID	oids[FTEST_MAXOBJECTS];					/* objects read at once */
+  Four		seeds[FTEST_MAXOBJECTS];				/* seeds of the data of 'oids' */
+  Four		lengths[FTEST_MAXOBJECTS];				/* lengths of 'oids' */
+  Four		starts[FTEST_MAXOBJECTS];				/* starts of the reads */
+  Four		reads[FTEST_MAXOBJECTS];				/* lengths of the reads */
+  Four		results[FTEST_MAXOBJECTS];				/* results of the reads */
+  void		*bufs[FTEST_MAXOBJECTS];				/* buffers of the reads */
+  PageID	homePage;								/* page of the objects */
+  PageID	forwardPage;							/* page of a moved data */
+  PageID	forwardPages[3];						/* pages of the moved data */
+  ObjectHdr	objHdr;									/* header of an object */
+  EduOM_ScanCursor cursor;							/* scan cursor */
+  ObjectID	batchOids[8];							/* ObjectIDs fetched at once */
+  ObjectHdr	batchHdrs[8];							/* headers fetched at once */
+  EduOM_PinHandle pinHandle;						/* handle of a pinned object */
+  const char *pinData;								/* data of the pinned object */
+  Four		pinLength;								/* length of the pinned object */
+  Four		counts[2][2];							/* # of objects and bad objects per thread */
+  void		*args[2];								/* arguments of the scan callbacks */
+  static char	data[PAGESIZE];						/* data of an object */
+  static char	store[FTEST_MAXOBJECTS][PAGESIZE];	/* buffers of the reads */
+
+  /* Create File */
+  e = SM_CreateFile(volId, &fid, FALSE, NULL);
+  if (e < eNOERROR) ERR(e);
+  /* Get catalog entry */
+  e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catalogEntry);
+  if (e < eNOERROR) ERR(e);
+
+  printf("****************************** TEST#5, EduOM_UpdateObject and EduOM_WriteObject ******************************\n");
+
+  /* Test for EduOM_UpdateObject() shrinking an object */
+  printf("*Test 5_1 : Test for EduOM_UpdateObject() shrinking an object\n");
+  printf("->Insert three objects of 100 bytes and shrink the first one to 40 bytes\n\n");
+  eduom_FillData(data, 1, 100);
+  e = EduOM_CreateObject(&catalogEntry, NULL, NULL, 100, data, &oidA);
+  if (e < eNOERROR) ERR(e);
+  eduom_FillData(data, 2, 100);
+  e = EduOM_CreateObject(&catalogEntry, &oidA, NULL, 100, data, &oidB);
+  if (e < eNOERROR) ERR(e);
+  eduom_FillData(data, 3, 100);
+  e = EduOM_CreateObject(&catalogEntry, &oidB, NULL, 100, data, &oidC);
+  if (e < eNOERROR) ERR(e);
+  MAKE_PAGEID(homePage, oidA.volNo, oidA.pageNo);
+  e = eduom_PrintPageSpace(&homePage);
+  if (e < eNOERROR) ERR(e);
+
+  eduom_FillData(data, 4, 40);
+  e = EduOM_UpdateObject(&catalogEntry, &oidA, NULL, 40, data, &dlPool, &dlHead);
+  if (e < eNOERROR) ERR(e);
+  printf("---------------------------------- Result ----------------------------------\n");
+  e = eduom_PrintObject(&oidA, 4);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintPageSpace(&homePage);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Test for EduOM_UpdateObject() growing an object in its page */
+  printf("*Test 5_2 : Test for EduOM_UpdateObject() growing an object in its page\n");
+  printf("->Grow the last object of the data area to 200 bytes, the first object to 300 bytes, and write into the first object\n\n");
+  eduom_FillData(data, 5, 200);
+  e = EduOM_UpdateObject(&catalogEntry, &oidC, NULL, 200, data, &dlPool, &dlHead);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintObject(&oidC, 5);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintPageSpace(&homePage);
+  if (e < eNOERROR) ERR(e);
+
+  eduom_FillData(data, 6, 350);
+  e = EduOM_UpdateObject(&catalogEntry, &oidA, NULL, 300, data, &dlPool, &dlHead);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintObject(&oidA, 6);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintPageSpace(&homePage);
+  if (e < eNOERROR) ERR(e);
+
+  /* the bytes 10 ~ 14 are written in place, and the bytes 300 ~ 349 are appended */
+  e = EduOM_WriteObject(&catalogEntry, &oidA, 10, 5, &data[10], &dlPool, &dlHead);
+  if (e < eNOERROR) ERR(e);
+  e = EduOM_WriteObject(&catalogEntry, &oidA, 300, 50, &data[300], &dlPool, &dlHead);
+  if (e < eNOERROR) ERR(e);
+  printf("---------------------------------- Result ----------------------------------\n");
+  e = eduom_PrintObject(&oidA, 6);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintPageSpace(&homePage);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Test for EduOM_UpdateObject() moving an object to another page */
+  printf("*Test 5_3 : Test for EduOM_UpdateObject() moving an object to another page\n");
+  printf("->Fill the page with objects of 1000 bytes and grow the second object to 2000 bytes\n\n");
+  oid = oidC;
+  for (nFillers = 0; nFillers < FTEST_MAXOBJECTS; nFillers++) {
+    eduom_FillData(data, 10 + nFillers, 1000);
+    e = EduOM_CreateObject(&catalogEntry, &oid, NULL, 1000, data, &fillers[nFillers]);
+    if (e < eNOERROR) ERR(e);
+    oid = fillers[nFillers];
+    if (oid.pageNo != homePage.pageNo) break;
+  }
+  printf("%d objects of 1000 bytes are inserted into the page\n", nFillers);
+  nFillers++;
+  e = eduom_PrintPageSpace(&homePage);
+  if (e < eNOERROR) ERR(e);
+
+  eduom_FillData(data, 7, 2000);
+  e = EduOM_UpdateObject(&catalogEntry, &oidB, NULL, 2000, data, &dlPool, &dlHead);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_GetForward(&oidB, &forward);
+  if (e < eNOERROR) ERR(e);
+  MAKE_PAGEID(forwardPage, forward.volNo, forward.pageNo);
+  printf("---------------------------------- Result ----------------------------------\n");
+  e = eduom_PrintObject(&oidB, 7);
+  if (e < eNOERROR) ERR(e);
+  printf("The data of the object ( %d, %d ) is moved to ( %d, %d )\n", oidB.pageNo, oidB.slotNo, forward.pageNo, forward.slotNo);
+  e = eduom_PrintPageSpace(&homePage);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintPageSpace(&forwardPage);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Test for the reads and the scans of a moved object */
+  printf("*Test 5_4 : Test for the reads and the scans of a moved object\n");
+  printf("->Read the objects with EduOM_ReadObject(), EduOM_ReadObjects(), EduOM_PinObject(), and the scans\n\n");
+  oids[0] = oidA; seeds[0] = 6; lengths[0] = 350;
+  oids[1] = oidB; seeds[1] = 7; lengths[1] = 2000;
+  oids[2] = oidC; seeds[2] = 5; lengths[2] = 200;
+  for (n = 3, i = 0; i < nFillers; i++, n++) {
+    oids[n] = fillers[i]; seeds[n] = 10 + i; lengths[n] = 1000;
+  }
+
+  e = EduOM_ReadObject(&oidB, 1990, REMAINDER, data);
+  if (e < eNOERROR) ERR(e);
+  printf("EduOM_ReadObject() of the bytes 1990 ~ of the object ( %d, %d ) : %d bytes, data %s\n",
+         oidB.pageNo, oidB.slotNo, e, eduom_CheckData(data, 7, 1990, e) ? "OK" : "MISMATCH");
+
+  for (i = 0; i < n; i++) {
+    starts[i] = 0; reads[i] = REMAINDER; bufs[i] = store[i];
+  }
+  e = EduOM_ReadObjects(n, oids, starts, reads, bufs, results);
+  if (e < eNOERROR) ERR(e);
+  for (i = 0; i < n; i++)
+    printf("EduOM_ReadObjects() of the object ( %d, %d ) : %d bytes, data %s\n", oids[i].pageNo, oids[i].slotNo,
+           results[i], (results[i] == lengths[i] && eduom_CheckData(store[i], seeds[i], 0, results[i])) ? "OK" : "MISMATCH");
+
+  e = EduOM_PinObject(&oidB, &pinData, &pinLength, &pinHandle);
+  if (e < eNOERROR) ERR(e);
+  printf("EduOM_PinObject() of the object ( %d, %d ) : %d bytes, data %s\n", oidB.pageNo, oidB.slotNo,
+         pinLength, eduom_CheckData((char*)pinData, 7, 0, pinLength) ? "OK" : "MISMATCH");
+  e = EduOM_UnpinObject(&pinHandle);
+  if (e < eNOERROR) ERR(e);
+
+  printf("EduOM_NextObject() :");
+  e = EduOM_NextObject(&catalogEntry, NULL, &oid, &objHdr);
+  while (e != EOS) {
+    if (e < eNOERROR) ERR(e);
+    printf(" (%d,%d):%d", oid.pageNo, oid.slotNo, objHdr.length);
+    e = EduOM_NextObject(&catalogEntry, &oid, &nextOid, &objHdr);
+    oid = nextOid;
+  }
+  printf("\n");
+
+  printf("EduOM_PrevObject() :");
+  e = EduOM_PrevObject(&catalogEntry, NULL, &oid, &objHdr);
+  while (e != EOS) {
+    if (e < eNOERROR) ERR(e);
+    printf(" (%d,%d):%d", oid.pageNo, oid.slotNo, objHdr.length);
+    e = EduOM_PrevObject(&catalogEntry, &oid, &nextOid, &objHdr);
+    oid = nextOid;
+  }
+  printf("\n");
+
+  printf("EduOM_FetchBatch() :");
+  e = EduOM_OpenScan(&catalogEntry, NULL, FORWARD, &cursor);
+  if (e < eNOERROR) ERR(e);
+  while ((e = EduOM_FetchBatch(&cursor, 8, batchOids, batchHdrs)) > 0)
+    for (i = 0; i < e; i++) printf(" (%d,%d):%d", batchOids[i].pageNo, batchOids[i].slotNo, batchHdrs[i].length);
+  printf("\n");
+  if (e < eNOERROR && e != EOS) ERR(e);
+  e = EduOM_CloseScan(&cursor);
+  if (e < eNOERROR) ERR(e);
+
+  memset(counts, 0, sizeof(counts));
+  args[0] = counts[0]; args[1] = counts[1];
+  e = EduOM_ParallelScan(&catalogEntry, 2, 2, eduom_ScanCallback, args);
+  if (e < eNOERROR) ERR(e);
+  printf("EduOM_ParallelScan() : %d objects, %d objects of 2000 bytes\n",
+         counts[0][0] + counts[1][0], counts[0][1] + counts[1][1]);
+  printf("\n\n");
+
+  /* Test for the ObjectID of a moved data */
+  printf("*Test 5_5 : Test for the ObjectID of a moved data\n");
+  printf("->Use the ObjectID of the moved data instead of the ObjectID of the object\n\n");
+  printf("EduOM_ReadObject() : %s\n", eduom_ErrorName(EduOM_ReadObject(&forward, 0, REMAINDER, data)));
+  e = EduOM_PinObject(&forward, &pinData, &pinLength, &pinHandle);
+  printf("EduOM_PinObject() : %s\n", eduom_ErrorName(e));
+  if (e >= eNOERROR) (Four) EduOM_UnpinObject(&pinHandle);
+  oids[0] = forward; starts[0] = 0; reads[0] = REMAINDER; bufs[0] = store[0];
+  e = EduOM_ReadObjects(1, oids, starts, reads, bufs, results);
+  printf("EduOM_ReadObjects() : %s\n", eduom_ErrorName((e < eNOERROR) ? e : results[0]));
+  printf("EduOM_UpdateObject() : %s\n", eduom_ErrorName(EduOM_UpdateObject(&catalogEntry, &forward, NULL, 10, data, &dlPool, &dlHead)));
+  printf("EduOM_WriteObject() : %s\n", eduom_ErrorName(EduOM_WriteObject(&catalogEntry, &forward, 0, 10, data, &dlPool, &dlHead)));
+  printf("EduOM_DestroyObject() : %s\n", eduom_ErrorName(EduOM_DestroyObject(&catalogEntry, &forward, &dlPool, &dlHead)));
+  printf("---------------------------------- Result ----------------------------------\n");
+  e = eduom_PrintObject(&oidB, 7);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Test for EduOM_UpdateObject() moving an object back to its page */
+  printf("*Test 5_6 : Test for EduOM_UpdateObject() moving an object back to its page\n");
+  printf("->Destroy the objects of 1000 bytes in the page and shrink the moved object to 500 bytes\n\n");
+  for (i = 0; i < nFillers; i++) {
+    e = EduOM_DestroyObject(&catalogEntry, &fillers[i], &dlPool, &dlHead);
+    if (e < eNOERROR) ERR(e);
+  }
+  eduom_FillData(data, 8, 500);
+  e = EduOM_UpdateObject(&catalogEntry, &oidB, NULL, 500, data, &dlPool, &dlHead);
+  if (e < eNOERROR) ERR(e);
+  printf("---------------------------------- Result ----------------------------------\n");
+  e = eduom_PrintObject(&oidB, 8);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintPageSpace(&homePage);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintPageSpace(&forwardPage);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Test for EduOM_DestroyObject() and EduOM_DestroyObjects() of moved objects */
+  printf("*Test 5_7 : Test for EduOM_DestroyObject() and EduOM_DestroyObjects() of moved objects\n");
+  printf("->Fill the page again, grow three objects to 3000 bytes, and destroy them\n\n");
+  oid = oidC;
+  for (nFillers = 0; nFillers < FTEST_MAXOBJECTS; nFillers++) {
+    eduom_FillData(data, 10 + nFillers, 1000);
+    e = EduOM_CreateObject(&catalogEntry, &oid, NULL, 1000, data, &fillers[nFillers]);
+    if (e < eNOERROR) ERR(e);
+    oid = fillers[nFillers];
+    if (oid.pageNo != homePage.pageNo) break;
+  }
+  nFillers++;
+  eduom_FillData(data, 9, 3000);
+  oids[0] = oidA; oids[1] = oidB; oids[2] = oidC;
+  for (i = 0; i < 3; i++) {
+    e = EduOM_UpdateObject(&catalogEntry, &oids[i], NULL, 3000, data, &dlPool, &dlHead);
+    if (e < eNOERROR) ERR(e);
+    e = eduom_GetForward(&oids[i], &forward);
+    if (e < eNOERROR) ERR(e);
+    MAKE_PAGEID(forwardPages[i], forward.volNo, forward.pageNo);
+    printf("The data of the object ( %d, %d ) is moved to ( %d, %d )\n", oids[i].pageNo, oids[i].slotNo, forward.pageNo, forward.slotNo);
+  }
+  e = eduom_PrintPageSpace(&homePage);
+  if (e < eNOERROR) ERR(e);
+  for (i = 0; i < 3; i++) {
+    e = eduom_PrintPageSpace(&forwardPages[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  e = EduOM_DestroyObject(&catalogEntry, &oidA, &dlPool, &dlHead);
+  if (e < eNOERROR) ERR(e);
+  printf("The object ( %d, %d )  is destroyed from the page\n", oidA.pageNo, oidA.slotNo);
+  e = eduom_PrintPageSpace(&forwardPages[0]);
+  if (e < eNOERROR) ERR(e);
+
+  e = EduOM_DestroyObjects(&catalogEntry, 2, &oids[1], &dlPool, &dlHead);
+  if (e < eNOERROR) ERR(e);
+  printf("The objects ( %d, %d ) and ( %d, %d )  are destroyed from the page\n", oidB.pageNo, oidB.slotNo, oidC.pageNo, oidC.slotNo);
+  printf("---------------------------------- Result ----------------------------------\n");
+  e = eduom_PrintPageSpace(&homePage);
+  if (e < eNOERROR) ERR(e);
+  for (i = 1; i < 3; i++) {
+    e = eduom_PrintPageSpace(&forwardPages[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  for (n = 0, e = EduOM_NextObject(&catalogEntry, NULL, &oid, NULL); e != EOS; n++) {
+    if (e < eNOERROR) ERR(e);
+    e = EduOM_NextObject(&catalogEntry, &oid, &oid, NULL);
+  }
+  printf("%d objects are left in the file\n", n);
+  printf("\n\n");
+
+  /* Test for EduOM_UpdateObject() when the page has no room for the stub */
+  printf("*Test 5_8 : Test for EduOM_UpdateObject() when the page has no room for the stub\n");
+  printf("->Fill a page with objects of 1 byte and grow one of them to 2000 bytes\n\n");
+  for (i = 0; i < nFillers; i++) {
+    e = EduOM_DestroyObject(&catalogEntry, &fillers[i], &dlPool, &dlHead);
+    if (e < eNOERROR) ERR(e);
+  }
+  data[0] = 'x';
+  e = EduOM_CreateObject(&catalogEntry, NULL, NULL, 1, data, &oidA);
+  if (e < eNOERROR) ERR(e);
+  MAKE_PAGEID(homePage, oidA.volNo, oidA.pageNo);
+  oid = oidA;
+  do {
+    e = EduOM_CreateObject(&catalogEntry, &oid, NULL, 1, data, &oid);
+    if (e < eNOERROR) ERR(e);
+  } while (oid.pageNo == homePage.pageNo);
+  e = eduom_PrintPageSpace(&homePage);
+  if (e < eNOERROR) ERR(e);
+
+  eduom_FillData(data, 9, 2000);
+  printf("EduOM_UpdateObject() : %s\n", eduom_ErrorName(EduOM_UpdateObject(&catalogEntry, &oidA, NULL, 2000, data, &dlPool, &dlHead)));
+  printf("EduOM_WriteObject() : %s\n", eduom_ErrorName(EduOM_WriteObject(&catalogEntry, &oidA, 1, 1999, data, &dlPool, &dlHead)));
+  printf("---------------------------------- Result ----------------------------------\n");
+  e = EduOM_ReadObject(&oidA, 0, REMAINDER, data);
+  if (e < eNOERROR) ERR(e);
+  printf("The object ( %d, %d ) : %d bytes, data %s\n", oidA.pageNo, oidA.slotNo, e, (e == 1 && data[0] == 'x') ? "OK" : "MISMATCH");
+  e = eduom_PrintPageSpace(&homePage);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  printf("****************************** TEST#5, EduOM_UpdateObject and EduOM_WriteObject ******************************\n");
+
+  /* Destroy File */
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  return(eNOERROR);
+}
+
+
+
+/*@================================
+ * eduom_TestPageFormatV2()
+ *================================*/
+/*
+ * Function: Four eduom_TestPageFormatV2(Four)
+ *
+ * Description :
+ *  Test the objects of the pages of the format v2: the sizes of the
+ *  variable-length headers around the lengths where they grow, the objects
+ *  with and without a tag written and read back, their updates across
+ *  those lengths, and the destroy and the compaction of the objects.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_TestPageFormatV2(
+    Four        volId)          /* IN volume of the test file */
+{
+  Four 		e;										/* for errors */
+  Four		i;										/* loop index */
+  Four		n;										/* # of objects */
+  FileID      fid;									/* file identifier */
+  ObjectID    catalogEntry;							/* catalog object */
+  ObjectID	oid, nextOid;							/* object identifiers */
+  ObjectID	oids[FTEST_MAXOBJECTS];					/* objects of the test */
+  Four		seeds[FTEST_MAXOBJECTS];				/* seeds of the data of 'oids' */
+  Boolean	alive[FTEST_MAXOBJECTS];				/* TRUE if the object is not destroyed */
+  PageID	pid;									/* page of the objects */
+  SlottedPage *apage;								/* buffer holding the page */
+  ObjectHdr	objHdr;									/* header of an object */
+  static char	data[PAGESIZE];						/* data of an object */
+  static Four	lengths[] = { 1, 63, 64, 127, 128, 8191, 8192 };	/* lengths of the header sizes */
+  static Four	tags[] = { 0, 1, 127, 128 };		/* tags of the header sizes */
+  static Four	objLengths[] = { 1, 62, 63, 64, 65, 63, 64, 63, 64, 1000 };	/* lengths of the objects */
+  static Four	objTags[] = { 0, 0, 0, 0, 0, 5, 5, 300, 300, 0 };			/* tags of the objects */
+
+  printf("****************************** TEST#6, the page format v2 ******************************\n");
+
+  /* Test for the sizes of the headers of the format v2 */
+  printf("*Test 6_1 : Test for the sizes of the headers of the format v2\n");
+  printf("->Compute the bytes of the header of an object of each length and tag\n\n");
+  printf("---------------------------------- Result ----------------------------------\n");
+  for (i = 0; i < sizeof(lengths)/sizeof(lengths[0]); i++) {
+    printf("length = %4d :", lengths[i]);
+    for (n = 0; n < sizeof(tags)/sizeof(tags[0]); n++) {
+      objHdr.properties = 0;
+      objHdr.tag = tags[n];
+      objHdr.length = lengths[i];
+      printf("  tag %3d -> %d bytes", tags[n], eduom_ObjectSize(PAGE_FORMAT_V2, &objHdr) - lengths[i]);
+    }
+    printf("\n");
+  }
+  printf("\n\n");
+
+  /* Create File */
+  e = SM_CreateFile(volId, &fid, FALSE, NULL);
+  if (e < eNOERROR) ERR(e);
+  /* Get catalog entry */
+  e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catalogEntry);
+  if (e < eNOERROR) ERR(e);
+
+  e = EduOM_SetPageFormat(&catalogEntry, PAGE_FORMAT_V2);
+  if (e < eNOERROR) ERR(e);
+
+  /* Test for EduOM_CreateObject() in a file of the format v2 */
+  printf("*Test 6_2 : Test for EduOM_CreateObject() in a file of the format v2\n");
+  printf("->Insert objects of the lengths around 64 bytes with and without a tag, and read them back\n\n");
+  n = sizeof(objLengths)/sizeof(objLengths[0]);
+  for (i = 0; i < n; i++) {
+    eduom_FillData(data, 20 + i, objLengths[i]);
+    objHdr.properties = 0;
+    objHdr.tag = objTags[i];
+    objHdr.length = objLengths[i];
+    e = EduOM_CreateObject(&catalogEntry, (i == 0) ? NULL : &oids[i-1], &objHdr, objLengths[i], data, &oids[i]);
+    if (e < eNOERROR) ERR(e);
+    seeds[i] = 20 + i;
+    alive[i] = TRUE;
+  }
+  printf("---------------------------------- Result ----------------------------------\n");
+  for (i = 0; i < n; i++) {
+    e = eduom_PrintObjectV2(&oids[i], seeds[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  MAKE_PAGEID(pid, oids[0].volNo, oids[0].pageNo);
+  e = eduom_PrintPageSpace(&pid);
+  if (e < eNOERROR) ERR(e);
+  printf("EduOM_NextObject() :");
+  e = EduOM_NextObject(&catalogEntry, NULL, &oid, &objHdr);
+  while (e != EOS) {
+    if (e < eNOERROR) ERR(e);
+    printf(" (%d,%d):%d/%d", oid.pageNo, oid.slotNo, objHdr.length, objHdr.tag);
+    e = EduOM_NextObject(&catalogEntry, &oid, &nextOid, &objHdr);
+    oid = nextOid;
+  }
+  printf("\n\n\n");
+
+  /* Test for EduOM_UpdateObject() across the lengths where the header grows */
+  printf("*Test 6_3 : Test for EduOM_UpdateObject() across the lengths where the header grows\n");
+  printf("->Grow the objects of 63 bytes to 64 bytes, shrink the objects of 64 bytes to 63 bytes, and swap their tags\n");
+  printf("->Grow the object of 1000 bytes to 4000 bytes, which moves it to another page\n\n");
+  for (i = 0; i < n; i++) {
+    if (objLengths[i] != 63 && objLengths[i] != 64) continue;
+    eduom_FillData(data, 40 + i, 127 - objLengths[i]);
+    objHdr.tag = (objTags[i] == 0) ? 7 : 0;
+    e = EduOM_UpdateObject(&catalogEntry, &oids[i], &objHdr, 127 - objLengths[i], data, &dlPool, &dlHead);
+    if (e < eNOERROR) ERR(e);
+    seeds[i] = 40 + i;
+  }
+  eduom_FillData(data, 50, 4000);
+  objHdr.tag = 9;
+  e = EduOM_UpdateObject(&catalogEntry, &oids[n-1], &objHdr, 4000, data, &dlPool, &dlHead);
+  if (e < eNOERROR) ERR(e);
+  seeds[n-1] = 50;
+  printf("---------------------------------- Result ----------------------------------\n");
+  for (i = 0; i < n; i++) {
+    e = eduom_PrintObjectV2(&oids[i], seeds[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  e = eduom_PrintPageSpace(&pid);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Test for EduOM_DestroyObject() and EduOM_CompactPage() in a file of the format v2 */
+  printf("*Test 6_4 : Test for EduOM_DestroyObject() and EduOM_CompactPage() in a file of the format v2\n");
+  printf("->Destroy every other object, compact the page, and insert an object filling the page\n\n");
+  for (i = 1; i < n; i += 2) {
+    e = EduOM_DestroyObject(&catalogEntry, &oids[i], &dlPool, &dlHead);
+    if (e < eNOERROR) ERR(e);
+    alive[i] = FALSE;
+    printf("The object ( %d, %d )  is destroyed from the page\n", oids[i].pageNo, oids[i].slotNo);
+  }
+  e = eduom_PrintPageSpace(&pid);
+  if (e < eNOERROR) ERR(e);
+
+  e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+  e = EduOM_CompactPage(apage, NIL);
+  if (e >= eNOERROR) e = BfM_SetDirty(&pid, PAGE_BUF);
+  if (e < eNOERROR) ERRB1(e, &pid, PAGE_BUF);
+  e = BfM_FreeTrain(&pid, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+  printf("The page is compacted\n");
+  e = eduom_PrintPageSpace(&pid);
+  if (e < eNOERROR) ERR(e);
+
+  /* the new object takes all the free space but its slot and its 2-byte header */
+  e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+  objHdr.length = SP_FREE(apage) - sizeof(SlottedPageSlotV2) - 2;
+  e = BfM_FreeTrain(&pid, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+  eduom_FillData(data, 60, objHdr.length);
+  objHdr.tag = 0;
+  e = EduOM_CreateObject(&catalogEntry, &oids[0], &objHdr, objHdr.length, data, &oids[n]);
+  if (e < eNOERROR) ERR(e);
+  seeds[n] = 60;
+  alive[n] = TRUE;
+  n++;
+  printf("---------------------------------- Result ----------------------------------\n");
+  for (i = 0; i < n; i++) {
+    if (!alive[i]) continue;
+    e = eduom_PrintObjectV2(&oids[i], seeds[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  e = eduom_PrintPageSpace(&pid);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Test for EduOM_CreateObject() of the objects too large for a page */
+  printf("*Test 6_5 : Test for EduOM_CreateObject() of the objects too large for a page\n");
+  printf("->Insert objects of 8191 and 8192 bytes\n\n");
+  printf("---------------------------------- Result ----------------------------------\n");
+  printf("EduOM_CreateObject() of 8191 bytes : %s\n", eduom_ErrorName(EduOM_CreateObject(&catalogEntry, NULL, NULL, 8191, data, &oid)));
+  printf("EduOM_CreateObject() of 8192 bytes : %s\n", eduom_ErrorName(EduOM_CreateObject(&catalogEntry, NULL, NULL, 8192, data, &oid)));
+  printf("\n\n");
+
+  printf("****************************** TEST#6, the page format v2 ******************************\n");
+
+  /* Destroy File */
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  return(eNOERROR);
+}
+
+
+
+/*@================================
+ * eduom_TestPrefix()
+ *================================*/
+/*
+ * Function: Four eduom_TestPrefix(Four)
+ *
+ * Description :
+ *  Test the pages with a prefix: the prefix taken from the first object,
+ *  the prefix chosen again when the page is compacted to insert an object
+ *  after the objects sharing the old prefix are destroyed, and the reads
+ *  of an object lying in the prefix, in the suffix, and across both.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_TestPrefix(
+    Four        volId)          /* IN volume of the test file */
+{
+  Four 		e;										/* for errors */
+  Four		i;										/* loop index */
+  Four		n;										/* # of objects */
+  Four		k, t;									/* loop index */
+  Four		nRead;									/* # of bytes read */
+  Four		shared;									/* # of bytes of an object in the prefix */
+  FileID      fid;									/* file identifier */
+  ObjectID    catalogEntry;							/* catalog object */
+  ObjectID	oids[FTEST_MAXOBJECTS];					/* objects of the test */
+  char		keys[FTEST_MAXOBJECTS][16];				/* keys beginning the data of 'oids' */
+  Four		seeds[FTEST_MAXOBJECTS];				/* seeds of the rest of the data of 'oids' */
+  Boolean	alive[FTEST_MAXOBJECTS];				/* TRUE if the object is not destroyed */
+  Four		targets[2];								/* indexes of the objects read in pieces */
+  ObjectID	target;									/* object read in pieces */
+  PageID	pid;									/* page of the objects */
+  SlottedPage *apage;								/* buffer holding the page */
+  ObjectHdr	objHdr;									/* header of an object */
+  Four		starts[7];								/* starts of the reads */
+  Four		reads[7];								/* lengths of the reads */
+  static char	data[PAGESIZE];						/* data of an object */
+
+  printf("****************************** TEST#7, the pages with a prefix ******************************\n");
+
+  /* Create File */
+  e = SM_CreateFile(volId, &fid, FALSE, NULL);
+  if (e < eNOERROR) ERR(e);
+  /* Get catalog entry */
+  e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catalogEntry);
+  if (e < eNOERROR) ERR(e);
+
+  e = EduOM_SetPageFormat(&catalogEntry, PAGE_FORMAT_PREFIX);
+  if (e < eNOERROR) ERR(e);
+
+  /* Test for the prefix taken from the first object */
+  printf("*Test 7_1 : Test for the prefix taken from the first object of a page\n");
+  printf("->Insert 4 objects beginning with \"alpha/\" and 6 objects beginning with \"beta/\", and fill the page\n\n");
+  n = 10;
+  for (i = 0; i < n; i++) {
+    sprintf(keys[i], (i < 4) ? "alpha/key-%02d/" : "beta/item-%02d/", i);
+    seeds[i] = 70 + i;
+    alive[i] = TRUE;
+    eduom_FillKeyData(data, keys[i], seeds[i], 120);
+    e = EduOM_CreateObject(&catalogEntry, (i == 0) ? NULL : &oids[i-1], NULL, 120, data, &oids[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+
+  /* the filler shares no byte with the prefix and leaves 16 bytes of the contiguous free space */
+  MAKE_PAGEID(pid, oids[0].volNo, oids[0].pageNo);
+  e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+  objHdr.length = SP_CFREE(apage) - sizeof(SlottedPageSlotV2) - 3 - 16;
+  e = BfM_FreeTrain(&pid, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+  strcpy(keys[n], "#filler/");
+  seeds[n] = 90;
+  alive[n] = TRUE;
+  eduom_FillKeyData(data, keys[n], seeds[n], objHdr.length);
+  e = EduOM_CreateObject(&catalogEntry, &oids[n-1], NULL, objHdr.length, data, &oids[n]);
+  if (e < eNOERROR) ERR(e);
+  n++;
+
+  printf("---------------------------------- Result ----------------------------------\n");
+  e = eduom_PrintPrefix(&pid);
+  if (e < eNOERROR) ERR(e);
+  for (i = 0; i < n; i++) {
+    e = eduom_PrintPrefixObject(&oids[i], keys[i], seeds[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  e = eduom_PrintPageSpace(&pid);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Test for the prefix chosen again by a compaction */
+  printf("*Test 7_2 : Test for the prefix chosen again by a compaction\n");
+  printf("->Destroy the objects beginning with \"alpha/\", and insert an object which needs the page to be compacted\n\n");
+  for (i = 0; i < 4; i++) {
+    e = EduOM_DestroyObject(&catalogEntry, &oids[i], &dlPool, &dlHead);
+    if (e < eNOERROR) ERR(e);
+    alive[i] = FALSE;
+    printf("The object ( %d, %d )  is destroyed from the page\n", oids[i].pageNo, oids[i].slotNo);
+  }
+  e = eduom_PrintPrefix(&pid);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintPageSpace(&pid);
+  if (e < eNOERROR) ERR(e);
+
+  sprintf(keys[n], "beta/item-%02d/", n);
+  seeds[n] = 70 + n;
+  alive[n] = TRUE;
+  eduom_FillKeyData(data, keys[n], seeds[n], 120);
+  e = EduOM_CreateObject(&catalogEntry, &oids[n-1], NULL, 120, data, &oids[n]);
+  if (e < eNOERROR) ERR(e);
+  n++;
+
+  printf("---------------------------------- Result ----------------------------------\n");
+  e = eduom_PrintPrefix(&pid);
+  if (e < eNOERROR) ERR(e);
+  for (i = 0; i < n; i++) {
+    if (!alive[i]) continue;
+    e = eduom_PrintPrefixObject(&oids[i], keys[i], seeds[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  e = eduom_PrintPageSpace(&pid);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Test for EduOM_ReadObject() across the end of the prefix */
+  printf("*Test 7_3 : Test for EduOM_ReadObject() across the end of the prefix\n");
+  printf("->Read parts of objects in the prefix, in the suffix, and across the end of the prefix\n\n");
+  printf("---------------------------------- Result ----------------------------------\n");
+  /* an object kept before the compaction and the object inserted by it */
+  targets[0] = 5;
+  targets[1] = n - 1;
+  for (t = 0; t < 2; t++) {
+    i = targets[t];
+    target = oids[i];
+
+    e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+    shared = eduom_GetObject(apage, SP_OFFSET(apage, target.slotNo), &objHdr, NULL);
+    shared = eduom_ObjectSize(PAGE_FORMAT_PREFIX, &objHdr) - shared;
+    e = BfM_FreeTrain(&pid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    starts[0] = 0;          reads[0] = shared;
+    starts[1] = 1;          reads[1] = shared - 2;
+    starts[2] = shared - 3; reads[2] = 6;
+    starts[3] = shared;     reads[3] = 10;
+    starts[4] = shared + 5; reads[4] = 20;
+    starts[5] = shared - 1; reads[5] = REMAINDER;
+    starts[6] = 0;          reads[6] = REMAINDER;
+
+    printf("The object ( %d, %d ) : %d bytes in the prefix\n", target.pageNo, target.slotNo, shared);
+    for (k = 0; k < 7; k++) {
+      nRead = EduOM_ReadObject(&target, starts[k], reads[k], data);
+      if (nRead < eNOERROR) ERR(nRead);
+      printf("  EduOM_ReadObject(start = %3d, length = %3d) : %3d bytes  data %s\n", starts[k], reads[k], nRead,
+             eduom_CheckKeyData(data, keys[i], seeds[i], starts[k], nRead) ? "OK" : "MISMATCH");
+    }
+  }
+  printf("\n\n");
+
+  printf("****************************** TEST#7, the pages with a prefix ******************************\n");
+
+  /* Destroy File */
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  return(eNOERROR);
+}
+
+
+
+/*@================================
+ * eduom_TestCreateObjects()
+ *================================*/
+/*
+ * Function: Four eduom_TestCreateObjects(Four)
+ *
+ * Description :
+ *  Test EduOM_CreateObjects(): the objects of a call filling a page and
+ *  going on to new pages, the objects put near an object into the empty
+ *  slots of its page, and an object taking a whole new page of each format.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_TestCreateObjects(
+    Four        volId)          /* IN volume of the test file */
+{
+  Four 		e;										/* for errors */
+  Four		i;										/* loop index */
+  Four		n;										/* # of objects */
+  Four		f;										/* index of the page format */
+  FileID      fid;									/* file identifier */
+  ObjectID    catalogEntry;							/* catalog object */
+  ObjectID	oids[FTEST_MAXOBJECTS];					/* objects of the test */
+  Four		seeds[FTEST_MAXOBJECTS];				/* seeds of the data of 'oids' */
+  Four		lengths[FTEST_MAXOBJECTS];				/* lengths of 'oids' */
+  char		*datas[FTEST_MAXOBJECTS];				/* data of 'oids' */
+  ObjectHdr	objHdrs[FTEST_MAXOBJECTS];				/* headers of 'oids' */
+  PageID	pid;									/* page of the objects */
+  static Four	formats[] = { PAGE_FORMAT_V2, PAGE_FORMAT_PREFIX };	/* formats of 8_3 */
+  static char	*formatNames[] = { "v2", "with a prefix" };		/* names of 'formats' */
+  static Four	tags[] = { 200, 1 };				/* tags of the objects of 8_3 */
+  static char	store[FTEST_MAXOBJECTS][PAGESIZE];	/* data of 'oids' */
+
+  printf("****************************** TEST#8, EduOM_CreateObjects ******************************\n");
+
+  /* Create File */
+  e = SM_CreateFile(volId, &fid, FALSE, NULL);
+  if (e < eNOERROR) ERR(e);
+  /* Get catalog entry */
+  e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catalogEntry);
+  if (e < eNOERROR) ERR(e);
+  /* 8_3 inserts into this file in the format v2 */
+  e = EduOM_SetPageFormat(&catalogEntry, PAGE_FORMAT_V2);
+  if (e < eNOERROR) ERR(e);
+
+  /* Test for EduOM_CreateObjects() filling pages */
+  printf("*Test 8_1 : Test for EduOM_CreateObjects() filling pages\n");
+  printf("->Insert 12 objects of 100 ~ 1200 bytes at once\n\n");
+  n = 12;
+  for (i = 0; i < n; i++) {
+    seeds[i] = 100 + i;
+    lengths[i] = 100 * (i + 1);
+    datas[i] = store[i];
+    eduom_FillData(datas[i], seeds[i], lengths[i]);
+  }
+  e = EduOM_CreateObjects(&catalogEntry, NULL, n, NULL, lengths, datas, oids);
+  if (e < eNOERROR) ERR(e);
+  printf("---------------------------------- Result ----------------------------------\n");
+  for (i = 0; i < n; i++) {
+    e = eduom_PrintObject(&oids[i], seeds[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  for (i = 0; i < n; i++) {
+    if (i > 0 && oids[i].pageNo == oids[i-1].pageNo) continue;
+    MAKE_PAGEID(pid, oids[i].volNo, oids[i].pageNo);
+    e = eduom_PrintPageSpace(&pid);
+    if (e < eNOERROR) ERR(e);
+  }
+  e = eduom_PrintScans(&catalogEntry);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Test for EduOM_CreateObjects() near an object */
+  printf("*Test 8_2 : Test for EduOM_CreateObjects() near an object\n");
+  printf("->Destroy the second and the third objects, and insert 3 objects of 50 bytes near the first object\n\n");
+  for (i = 1; i < 3; i++) {
+    e = EduOM_DestroyObject(&catalogEntry, &oids[i], &dlPool, &dlHead);
+    if (e < eNOERROR) ERR(e);
+    printf("The object ( %d, %d )  is destroyed from the page\n", oids[i].pageNo, oids[i].slotNo);
+  }
+  for (i = 1; i < 4; i++) {
+    seeds[n+i] = 120 + i;
+    lengths[n+i] = 50;
+    datas[n+i] = store[n+i];
+    eduom_FillData(datas[n+i], seeds[n+i], lengths[n+i]);
+  }
+  e = EduOM_CreateObjects(&catalogEntry, &oids[0], 3, NULL, &lengths[n+1], &datas[n+1], &oids[n+1]);
+  if (e < eNOERROR) ERR(e);
+  printf("---------------------------------- Result ----------------------------------\n");
+  for (i = 1; i < 4; i++) {
+    e = eduom_PrintObject(&oids[n+i], seeds[n+i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  MAKE_PAGEID(pid, oids[0].volNo, oids[0].pageNo);
+  e = eduom_PrintPageSpace(&pid);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintScans(&catalogEntry);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Test for EduOM_CreateObjects() of an object taking a whole page */
+  printf("*Test 8_3 : Test for EduOM_CreateObjects() of an object taking a whole page\n");
+  printf("->Insert an object of %d bytes with a tag at once into the file above and into an empty file with a prefix\n\n", LRGOBJ_THRESHOLD);
+  printf("---------------------------------- Result ----------------------------------\n");
+  for (f = 0; f < 2; f++) {
+    /*@ the volume has room for a few files only: the format v2 reuses the file of 8_1 */
+    if (formats[f] != PAGE_FORMAT_V2) {
+      e = SM_CreateFile(volId, &fid, FALSE, NULL);
+      if (e < eNOERROR) ERR(e);
+      e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catalogEntry);
+      if (e < eNOERROR) ERR(e);
+      e = EduOM_SetPageFormat(&catalogEntry, formats[f]);
+      if (e < eNOERROR) ERR(e);
+    }
+
+    seeds[0] = 130 + f;
+    lengths[0] = LRGOBJ_THRESHOLD;
+    datas[0] = store[0];
+    eduom_FillData(datas[0], seeds[0], lengths[0]);
+    objHdrs[0].properties = 0;
+    objHdrs[0].tag = tags[f];
+    objHdrs[0].length = lengths[0];
+    e = EduOM_CreateObjects(&catalogEntry, NULL, 1, objHdrs, lengths, datas, oids);
+    printf("EduOM_CreateObjects() in the format %s with the tag %d : %s\n", formatNames[f], tags[f], eduom_ErrorName(e));
+    if (e < eNOERROR) ERR(e);
+
+    e = eduom_PrintObject(&oids[0], seeds[0]);
+    if (e < eNOERROR) ERR(e);
+    MAKE_PAGEID(pid, oids[0].volNo, oids[0].pageNo);
+    e = eduom_PrintPageSpace(&pid);
+    if (e < eNOERROR) ERR(e);
+    e = eduom_PrintScans(&catalogEntry);
+    if (e < eNOERROR) ERR(e);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+  }
+  printf("\n\n");
+
+  printf("****************************** TEST#8, EduOM_CreateObjects ******************************\n");
+
+  return(eNOERROR);
+}
+
+
+
+/*@================================
+ * eduom_TestFixedLength()
+ *================================*/
+/*
+ * Function: Four eduom_TestFixedLength(Four)
+ *
+ * Description :
+ *  Test the files of fixed-length objects: the objects put into the cells
+ *  of the pages, the lengths refused, the cells freed by destroyed objects
+ *  and used again, and the reads of a part of an object.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_TestFixedLength(
+    Four        volId)          /* IN volume of the test file */
+{
+  Four 		e;										/* for errors */
+  Four		i;										/* loop index */
+  Four		n;										/* # of objects */
+  FileID      fid;									/* file identifier */
+  ObjectID    catalogEntry;							/* catalog object */
+  ObjectID	oids[FTEST_MAXOBJECTS];					/* objects of the test */
+  Four		seeds[FTEST_MAXOBJECTS];				/* seeds of the data of 'oids' */
+  ObjectID	oid;									/* object refused */
+  PageID	pid;									/* page of the objects */
+  static Four	destroyed[] = { 1, 4, 5 };			/* objects destroyed by 9_3 */
+  static char	data[PAGESIZE];						/* data of an object */
+
+  printf("****************************** TEST#9, the files of fixed-length objects ******************************\n");
+
+  /* Create File */
+  e = SM_CreateFile(volId, &fid, FALSE, NULL);
+  if (e < eNOERROR) ERR(e);
+  /* Get catalog entry */
+  e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catalogEntry);
+  if (e < eNOERROR) ERR(e);
+
+  /* Test for the objects put into the cells */
+  printf("*Test 9_1 : Test for the objects put into the cells of the pages\n");
+  printf("->Make the file a file of objects of %d bytes, and insert 12 objects\n\n", FTEST_CELLSIZE);
+  e = EduOM_SetFixedLength(&catalogEntry, FTEST_CELLSIZE);
+  if (e < eNOERROR) ERR(e);
+  n = 12;
+  for (i = 0; i < n; i++) {
+    seeds[i] = 140 + i;
+    eduom_FillData(data, seeds[i], FTEST_CELLSIZE);
+    e = EduOM_CreateObject(&catalogEntry, NULL, NULL, FTEST_CELLSIZE, data, &oids[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  printf("---------------------------------- Result ----------------------------------\n");
+  for (i = 0; i < n; i++) {
+    e = eduom_PrintObject(&oids[i], seeds[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  for (i = 0; i < n; i++) {
+    if (i > 0 && oids[i].pageNo == oids[i-1].pageNo) continue;
+    MAKE_PAGEID(pid, oids[i].volNo, oids[i].pageNo);
+    e = eduom_PrintCells(&pid);
+    if (e < eNOERROR) ERR(e);
+    e = eduom_PrintPageSpace(&pid);
+    if (e < eNOERROR) ERR(e);
+  }
+  e = eduom_PrintScans(&catalogEntry);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Test for the lengths refused */
+  printf("*Test 9_2 : Test for the lengths refused\n");
+  printf("->Insert objects of other lengths, give the file not empty another length, and give bad lengths\n\n");
+  printf("---------------------------------- Result ----------------------------------\n");
+  eduom_FillData(data, 150, FTEST_CELLSIZE + 1);
+  e = EduOM_CreateObject(&catalogEntry, NULL, NULL, FTEST_CELLSIZE + 1, data, &oid);
+  printf("EduOM_CreateObject() of %d bytes : %s\n", FTEST_CELLSIZE + 1, eduom_ErrorName(e));
+  e = EduOM_CreateObject(&catalogEntry, NULL, NULL, FTEST_CELLSIZE - 1, data, &oid);
+  printf("EduOM_CreateObject() of %d bytes : %s\n", FTEST_CELLSIZE - 1, eduom_ErrorName(e));
+  e = EduOM_SetFixedLength(&catalogEntry, 2*FTEST_CELLSIZE);
+  printf("EduOM_SetFixedLength() of %d bytes to the file not empty : %s\n", 2*FTEST_CELLSIZE, eduom_ErrorName(e));
+  e = EduOM_SetFixedLength(&catalogEntry, 0);
+  printf("EduOM_SetFixedLength() of 0 bytes : %s\n", eduom_ErrorName(e));
+  e = EduOM_SetFixedLength(&catalogEntry, FIXED_MAXCELLSIZE + 1);
+  printf("EduOM_SetFixedLength() of %d bytes : %s\n", FIXED_MAXCELLSIZE + 1, eduom_ErrorName(e));
+  e = eduom_PrintScans(&catalogEntry);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Test for the cells freed by destroyed objects */
+  printf("*Test 9_3 : Test for the cells freed by destroyed objects\n");
+  printf("->Destroy the objects 2, 5 and 6, and insert 3 objects near the first object\n\n");
+  for (i = 0; i < 3; i++) {
+    e = EduOM_DestroyObject(&catalogEntry, &oids[destroyed[i]], &dlPool, &dlHead);
+    if (e < eNOERROR) ERR(e);
+    printf("The object ( %d, %d )  is destroyed from the page\n", oids[destroyed[i]].pageNo, oids[destroyed[i]].slotNo);
+  }
+  MAKE_PAGEID(pid, oids[0].volNo, oids[0].pageNo);
+  e = eduom_PrintCells(&pid);
+  if (e < eNOERROR) ERR(e);
+  for (i = 0; i < 3; i++) {
+    seeds[destroyed[i]] = 160 + i;
+    eduom_FillData(data, seeds[destroyed[i]], FTEST_CELLSIZE);
+    e = EduOM_CreateObject(&catalogEntry, &oids[0], NULL, FTEST_CELLSIZE, data, &oids[destroyed[i]]);
+    if (e < eNOERROR) ERR(e);
+  }
+  printf("---------------------------------- Result ----------------------------------\n");
+  for (i = 0; i < 3; i++) {
+    e = eduom_PrintObject(&oids[destroyed[i]], seeds[destroyed[i]]);
+    if (e < eNOERROR) ERR(e);
+  }
+  e = eduom_PrintCells(&pid);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintPageSpace(&pid);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintScans(&catalogEntry);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Test for the reads of a part of an object */
+  printf("*Test 9_4 : Test for the reads of a part of an object\n");
+  printf("->Read 50 bytes from the byte 100 and the rest from the byte 350 of the last object\n\n");
+  printf("---------------------------------- Result ----------------------------------\n");
+  e = EduOM_ReadObject(&oids[n-1], 100, 50, data);
+  if (e < eNOERROR) ERR(e);
+  printf("EduOM_ReadObject() from 100 : length = %d  data %s\n", e, eduom_CheckData(data, seeds[n-1], 100, e) ? "OK" : "MISMATCH");
+  e = EduOM_ReadObject(&oids[n-1], 350, REMAINDER, data);
+  if (e < eNOERROR) ERR(e);
+  printf("EduOM_ReadObject() from 350 : length = %d  data %s\n", e, eduom_CheckData(data, seeds[n-1], 350, e) ? "OK" : "MISMATCH");
+  printf("\n\n");
+
+  /* Destroy File */
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  printf("****************************** TEST#9, the files of fixed-length objects ******************************\n");
+
+  return(eNOERROR);
+}
+
+
+
+/*@================================
+ * eduom_TestSizeClass()
+ *================================*/
+/*
+ * Function: Four eduom_TestSizeClass(Four)
+ *
+ * Description :
+ *  Test the placement policy PLACEMENT_SIZECLASS: the objects of different
+ *  size classes put into different pages, the space freed by destroyed
+ *  objects refilled by objects of their class, an object put near an
+ *  object of another class, and the objects put after the policy is set
+ *  back to PLACEMENT_DEFAULT.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_TestSizeClass(
+    Four        volId)          /* IN volume of the test file */
+{
+  Four 		e;										/* for errors */
+  Four		i;										/* loop index */
+  Four		n;										/* # of objects */
+  FileID      fid;									/* file identifier */
+  ObjectID    catalogEntry;							/* catalog object */
+  ObjectID	oids[FTEST_MAXOBJECTS];					/* objects of the test */
+  Four		seeds[FTEST_MAXOBJECTS];				/* seeds of the data of 'oids' */
+  Four		lengths[FTEST_MAXOBJECTS];				/* lengths of 'oids' */
+  PageID	pid;									/* page of the objects */
+  static Four	classLengths[] = { 40, 200, 800 };	/* lengths of the objects of 3 classes */
+  static char	data[PAGESIZE];						/* data of an object */
+
+  printf("****************************** TEST#10, the placement by size classes ******************************\n");
+
+  /* Create File */
+  e = SM_CreateFile(volId, &fid, FALSE, NULL);
+  if (e < eNOERROR) ERR(e);
+  /* Get catalog entry */
+  e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catalogEntry);
+  if (e < eNOERROR) ERR(e);
+
+  /* Test for the objects of different classes */
+  printf("*Test 10_1 : Test for the objects of different size classes\n");
+  printf("->Set the policy PLACEMENT_SIZECLASS, and insert objects of 40, 200 and 800 bytes in turn, 4 of each\n\n");
+  e = EduOM_SetPlacementPolicy(&catalogEntry, PLACEMENT_SIZECLASS);
+  if (e < eNOERROR) ERR(e);
+  n = 12;
+  for (i = 0; i < n; i++) {
+    seeds[i] = 170 + i;
+    lengths[i] = classLengths[i % 3];
+    eduom_FillData(data, seeds[i], lengths[i]);
+    e = EduOM_CreateObject(&catalogEntry, NULL, NULL, lengths[i], data, &oids[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  printf("---------------------------------- Result ----------------------------------\n");
+  for (i = 0; i < n; i++) {
+    e = eduom_PrintObject(&oids[i], seeds[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  for (i = 0; i < 3; i++) {
+    MAKE_PAGEID(pid, oids[i].volNo, oids[i].pageNo);
+    e = eduom_PrintPageSpace(&pid);
+    if (e < eNOERROR) ERR(e);
+  }
+  e = eduom_PrintScans(&catalogEntry);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Test for the space freed in a page refilled by the objects of its class */
+  printf("*Test 10_2 : Test for the space freed in a page refilled by the objects of its size class\n");
+  printf("->Destroy two objects of 200 bytes, and insert an object of 40 bytes and two of 200 bytes\n\n");
+  for (i = 1; i < 6; i += 3) {
+    e = EduOM_DestroyObject(&catalogEntry, &oids[i], &dlPool, &dlHead);
+    if (e < eNOERROR) ERR(e);
+    printf("The object ( %d, %d )  is destroyed from the page\n", oids[i].pageNo, oids[i].slotNo);
+  }
+  for (i = 0; i < 3; i++) {
+    seeds[n+i] = 190 + i;
+    lengths[n+i] = (i == 0) ? classLengths[0] : classLengths[1];
+    eduom_FillData(data, seeds[n+i], lengths[n+i]);
+    e = EduOM_CreateObject(&catalogEntry, NULL, NULL, lengths[n+i], data, &oids[n+i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  printf("---------------------------------- Result ----------------------------------\n");
+  for (i = 0; i < 3; i++) {
+    e = eduom_PrintObject(&oids[n+i], seeds[n+i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  for (i = 0; i < 2; i++) {
+    MAKE_PAGEID(pid, oids[i].volNo, oids[i].pageNo);
+    e = eduom_PrintPageSpace(&pid);
+    if (e < eNOERROR) ERR(e);
+  }
+  e = eduom_PrintScans(&catalogEntry);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+  n += 3;
+
+  /* Test for an object near an object of another class */
+  printf("*Test 10_3 : Test for an object put near an object of another size class\n");
+  printf("->Insert an object of 800 bytes near the first object of 40 bytes\n\n");
+  seeds[n] = 195;
+  lengths[n] = classLengths[2];
+  eduom_FillData(data, seeds[n], lengths[n]);
+  e = EduOM_CreateObject(&catalogEntry, &oids[0], NULL, lengths[n], data, &oids[n]);
+  if (e < eNOERROR) ERR(e);
+  printf("---------------------------------- Result ----------------------------------\n");
+  e = eduom_PrintObject(&oids[n], seeds[n]);
+  if (e < eNOERROR) ERR(e);
+  MAKE_PAGEID(pid, oids[0].volNo, oids[0].pageNo);
+  e = eduom_PrintPageSpace(&pid);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintScans(&catalogEntry);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+  n++;
+
+  /* Test for the policy set back */
+  printf("*Test 10_4 : Test for the policy set back to PLACEMENT_DEFAULT\n");
+  printf("->Give a bad policy, set the policy PLACEMENT_DEFAULT, and insert an object of 200 bytes\n\n");
+  printf("---------------------------------- Result ----------------------------------\n");
+  e = EduOM_SetPlacementPolicy(&catalogEntry, PLACEMENT_SIZECLASS + 1);
+  printf("EduOM_SetPlacementPolicy() of the policy %d : %s\n", PLACEMENT_SIZECLASS + 1, eduom_ErrorName(e));
+  e = EduOM_SetPlacementPolicy(&catalogEntry, PLACEMENT_DEFAULT);
+  if (e < eNOERROR) ERR(e);
+  seeds[n] = 196;
+  lengths[n] = classLengths[1];
+  eduom_FillData(data, seeds[n], lengths[n]);
+  e = EduOM_CreateObject(&catalogEntry, NULL, NULL, lengths[n], data, &oids[n]);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintObject(&oids[n], seeds[n]);
+  if (e < eNOERROR) ERR(e);
+  MAKE_PAGEID(pid, oids[n].volNo, oids[n].pageNo);
+  e = eduom_PrintPageSpace(&pid);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintScans(&catalogEntry);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Destroy File */
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  printf("****************************** TEST#10, the placement by size classes ******************************\n");
+
+  return(eNOERROR);
+}
+
+
+
+/*@================================
+ * eduom_TestCompactionPolicy()
+ *================================*/
+/*
+ * Function: Four eduom_TestCompactionPolicy(Four)
+ *
+ * Description :
+ *  Test EduOM_SetCompactionPolicy() and EduOM_RunDeferredCompaction(): an
+ *  insertion refused the compaction of the page of its near object, the
+ *  page queued and compacted later within a budget, an insertion using the
+ *  space gained, and the parameters refused. The policy is set back to no
+ *  limit and no deferred compaction at the end.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_TestCompactionPolicy(
+    Four        volId)          /* IN volume of the test file */
+{
+  Four 		e;										/* for errors */
+  Four		i;										/* loop index */
+  Four		n;										/* # of objects */
+  Four		nCompacted;								/* # of pages compacted */
+  FileID      fid;									/* file identifier */
+  ObjectID    catalogEntry;							/* catalog object */
+  ObjectID	oids[FTEST_MAXOBJECTS];					/* objects of the test */
+  Four		seeds[FTEST_MAXOBJECTS];				/* seeds of the data of 'oids' */
+  PageID	pid;									/* page of the objects */
+  static Four	kept[] = { 0, 3, 4, 5 };			/* objects not destroyed after 11_2 */
+  static char	data[PAGESIZE];						/* data of an object */
+
+  printf("****************************** TEST#11, the compaction policy ******************************\n");
+
+  /* Create File */
+  e = SM_CreateFile(volId, &fid, FALSE, NULL);
+  if (e < eNOERROR) ERR(e);
+  /* Get catalog entry */
+  e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catalogEntry);
+  if (e < eNOERROR) ERR(e);
+
+  /* fill a page and leave holes in it */
+  n = 4;
+  for (i = 0; i < n; i++) {
+    seeds[i] = 200 + i;
+    eduom_FillData(data, seeds[i], 900);
+    e = EduOM_CreateObject(&catalogEntry, (i == 0) ? NULL : &oids[0], NULL, 900, data, &oids[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  for (i = 1; i < 3; i++) {
+    e = EduOM_DestroyObject(&catalogEntry, &oids[i], &dlPool, &dlHead);
+    if (e < eNOERROR) ERR(e);
+  }
+  MAKE_PAGEID(pid, oids[0].volNo, oids[0].pageNo);
+
+  /* Test for an insertion refused the compaction */
+  printf("*Test 11_1 : Test for an insertion refused the compaction of a page\n");
+  printf("->Insert 4 objects of 900 bytes, destroy the second and the third, set a budget of 100 bytes,\n");
+  printf("  and insert an object of 1000 bytes near the first object\n\n");
+  e = EduOM_SetCompactionPolicy(100, COMPACT_NOLIMIT, 0);
+  if (e < eNOERROR) ERR(e);
+  e = EduOM_ResetStats();
+  if (e < eNOERROR) ERR(e);
+  seeds[n] = 210;
+  eduom_FillData(data, seeds[n], 1000);
+  e = EduOM_CreateObject(&catalogEntry, &oids[0], NULL, 1000, data, &oids[n]);
+  if (e < eNOERROR) ERR(e);
+  printf("---------------------------------- Result ----------------------------------\n");
+  e = eduom_PrintObject(&oids[n], seeds[n]);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintPageSpace(&pid);
+  if (e < eNOERROR) ERR(e);
+  eduom_PrintCompactions();
+  e = eduom_PrintScans(&catalogEntry);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+  n++;
+
+  /* Test for the deferred compaction */
+  printf("*Test 11_2 : Test for the deferred compaction of a page refused the compaction\n");
+  printf("->Turn the deferred compaction on, insert an object of 1000 bytes near the first object,\n");
+  printf("  and run the deferred compaction with a budget of 100 bytes, and with no limit\n\n");
+  e = EduOM_SetCompactionPolicy(100, COMPACT_NOLIMIT, 30);
+  if (e < eNOERROR) ERR(e);
+  e = EduOM_ResetStats();
+  if (e < eNOERROR) ERR(e);
+  seeds[n] = 211;
+  eduom_FillData(data, seeds[n], 1000);
+  e = EduOM_CreateObject(&catalogEntry, &oids[0], NULL, 1000, data, &oids[n]);
+  if (e < eNOERROR) ERR(e);
+  printf("---------------------------------- Result ----------------------------------\n");
+  e = eduom_PrintObject(&oids[n], seeds[n]);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintPageSpace(&pid);
+  if (e < eNOERROR) ERR(e);
+  e = EduOM_RunDeferredCompaction(100, &nCompacted);
+  if (e < eNOERROR) ERR(e);
+  printf("EduOM_RunDeferredCompaction() with a budget of 100 bytes : %d pages compacted\n", nCompacted);
+  e = eduom_PrintPageSpace(&pid);
+  if (e < eNOERROR) ERR(e);
+  e = EduOM_RunDeferredCompaction(COMPACT_NOLIMIT, &nCompacted);
+  if (e < eNOERROR) ERR(e);
+  printf("EduOM_RunDeferredCompaction() with no limit : %d pages compacted\n", nCompacted);
+  e = eduom_PrintPageSpace(&pid);
+  if (e < eNOERROR) ERR(e);
+  eduom_PrintCompactions();
+  for (i = 0; i < 4; i++) {
+    e = eduom_PrintObject(&oids[kept[i]], seeds[kept[i]]);
+    if (e < eNOERROR) ERR(e);
+  }
+  e = eduom_PrintScans(&catalogEntry);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+  n++;
+
+  /* Test for an insertion into the page compacted */
+  printf("*Test 11_3 : Test for an insertion into the page compacted\n");
+  printf("->Insert an object of 1000 bytes near the first object\n\n");
+  e = EduOM_ResetStats();
+  if (e < eNOERROR) ERR(e);
+  seeds[n] = 212;
+  eduom_FillData(data, seeds[n], 1000);
+  e = EduOM_CreateObject(&catalogEntry, &oids[0], NULL, 1000, data, &oids[n]);
+  if (e < eNOERROR) ERR(e);
+  printf("---------------------------------- Result ----------------------------------\n");
+  e = eduom_PrintObject(&oids[n], seeds[n]);
+  if (e < eNOERROR) ERR(e);
+  e = eduom_PrintPageSpace(&pid);
+  if (e < eNOERROR) ERR(e);
+  eduom_PrintCompactions();
+  e = eduom_PrintScans(&catalogEntry);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Test for the parameters refused */
+  printf("*Test 11_4 : Test for the parameters refused\n");
+  printf("->Give a negative budget, a negative cost, a threshold over 100 %%, and a negative budget to the deferred compaction\n\n");
+  printf("---------------------------------- Result ----------------------------------\n");
+  e = EduOM_SetCompactionPolicy(-2, COMPACT_NOLIMIT, 0);
+  printf("EduOM_SetCompactionPolicy() of the budget -2 : %s\n", eduom_ErrorName(e));
+  e = EduOM_SetCompactionPolicy(COMPACT_NOLIMIT, -2, 0);
+  printf("EduOM_SetCompactionPolicy() of the cost -2 : %s\n", eduom_ErrorName(e));
+  e = EduOM_SetCompactionPolicy(COMPACT_NOLIMIT, COMPACT_NOLIMIT, 101);
+  printf("EduOM_SetCompactionPolicy() of the threshold 101 : %s\n", eduom_ErrorName(e));
+  e = EduOM_RunDeferredCompaction(-2, &nCompacted);
+  printf("EduOM_RunDeferredCompaction() of the budget -2 : %s\n", eduom_ErrorName(e));
+  printf("\n\n");
+
+  e = EduOM_SetCompactionPolicy(COMPACT_NOLIMIT, COMPACT_NOLIMIT, 0);
+  if (e < eNOERROR) ERR(e);
+
+  /* Destroy File */
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  printf("****************************** TEST#11, the compaction policy ******************************\n");
+
+  return(eNOERROR);
+}
+
+
+
+/*@================================
+ * eduom_TestAppendPage()
+ *================================*/
+/*
+ * Function: Four eduom_TestAppendPage(Four)
+ *
+ * Description :
+ *  Test the append page of the free space map: the appends put into the
+ *  page last allocated without a search, the append page moved to the page
+ *  allocated when it is full, and the appends searched through the map
+ *  when the append page is not used.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_TestAppendPage(
+    Four        volId)          /* IN volume of the test file */
+{
+  Four 		e;										/* for errors */
+  Four		i;										/* loop index */
+  Four		n;										/* # of objects */
+  FileID      fid;									/* file identifier */
+  ObjectID    catalogEntry;							/* catalog object */
+  ObjectID	oids[FTEST_MAXOBJECTS];					/* objects of the test */
+  Four		seeds[FTEST_MAXOBJECTS];				/* seeds of the data of 'oids' */
+  Four		lengths[FTEST_MAXOBJECTS];				/* lengths of 'oids' */
+  PageID	pid;									/* page of the objects */
+  static Four	appendLengths[] = { 3000, 3000, 500 }; /* lengths of the objects of 12_2 and 12_3 */
+  static char	data[PAGESIZE];						/* data of an object */
+
+  printf("****************************** TEST#12, the append page ******************************\n");
+
+  /* Create File */
+  e = SM_CreateFile(volId, &fid, FALSE, NULL);
+  if (e < eNOERROR) ERR(e);
+  /* Get catalog entry */
+  e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catalogEntry);
+  if (e < eNOERROR) ERR(e);
+
+  /* Test for the appends put into the append page */
+  printf("*Test 12_1 : Test for the appends put into the page last allocated\n");
+  printf("->Insert 10 objects of 1000 bytes without a near object\n\n");
+  e = EduOM_ResetStats();
+  if (e < eNOERROR) ERR(e);
+  n = 10;
+  for (i = 0; i < n; i++) {
+    seeds[i] = 220 + i;
+    lengths[i] = 1000;
+    eduom_FillData(data, seeds[i], lengths[i]);
+    e = EduOM_CreateObject(&catalogEntry, NULL, NULL, lengths[i], data, &oids[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  printf("---------------------------------- Result ----------------------------------\n");
+  for (i = 0; i < n; i++) {
+    e = eduom_PrintObject(&oids[i], seeds[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  for (i = 0; i < n; i++) {
+    if (i > 0 && oids[i].pageNo == oids[i-1].pageNo) continue;
+    MAKE_PAGEID(pid, oids[i].volNo, oids[i].pageNo);
+    e = eduom_PrintPageSpace(&pid);
+    if (e < eNOERROR) ERR(e);
+  }
+  eduom_PrintPlacements();
+  e = eduom_PrintScans(&catalogEntry);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Test for the append page moved to a new page */
+  printf("*Test 12_2 : Test for the append page moved to the page allocated when it is full\n");
+  printf("->Insert objects of 3000, 3000 and 500 bytes without a near object\n\n");
+  e = EduOM_ResetStats();
+  if (e < eNOERROR) ERR(e);
+  for (i = 0; i < 3; i++) {
+    seeds[n+i] = 230 + i;
+    lengths[n+i] = appendLengths[i];
+    eduom_FillData(data, seeds[n+i], lengths[n+i]);
+    e = EduOM_CreateObject(&catalogEntry, NULL, NULL, lengths[n+i], data, &oids[n+i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  printf("---------------------------------- Result ----------------------------------\n");
+  for (i = n; i < n + 3; i++) {
+    e = eduom_PrintObject(&oids[i], seeds[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  for (i = n; i < n + 3; i++) {
+    if (i > n && oids[i].pageNo == oids[i-1].pageNo) continue;
+    MAKE_PAGEID(pid, oids[i].volNo, oids[i].pageNo);
+    e = eduom_PrintPageSpace(&pid);
+    if (e < eNOERROR) ERR(e);
+  }
+  eduom_PrintPlacements();
+  e = eduom_PrintScans(&catalogEntry);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+  n += 3;
+
+  /* Test for the appends without the append page */
+  printf("*Test 12_3 : Test for the appends searched through the map without the append page\n");
+  printf("->Stop using the append page, and insert objects of 3000, 3000 and 500 bytes without a near object\n\n");
+  eduom_useAppendPage = FALSE;
+  e = EduOM_ResetStats();
+  if (e < eNOERROR) ERR(e);
+  for (i = 0; i < 3; i++) {
+    seeds[n+i] = 240 + i;
+    lengths[n+i] = appendLengths[i];
+    eduom_FillData(data, seeds[n+i], lengths[n+i]);
+    e = EduOM_CreateObject(&catalogEntry, NULL, NULL, lengths[n+i], data, &oids[n+i]);
+    if (e < eNOERROR) break;
+  }
+  eduom_useAppendPage = TRUE;
+  if (e < eNOERROR) ERR(e);
+  printf("---------------------------------- Result ----------------------------------\n");
+  for (i = n; i < n + 3; i++) {
+    e = eduom_PrintObject(&oids[i], seeds[i]);
+    if (e < eNOERROR) ERR(e);
+  }
+  eduom_PrintPlacements();
+  e = eduom_PrintScans(&catalogEntry);
+  if (e < eNOERROR) ERR(e);
+  printf("\n\n");
+
+  /* Destroy File */
+  e = SM_DestroyFile(&fid, NULL);
+  if (e < eNOERROR) ERR(e);
+
+  printf("****************************** TEST#12, the append page ******************************\n");
+
+  return(eNOERROR);
+}
+
+
+
+/*@================================
+ * eduom_FillData()
+ *================================*/
+/*
+ * Function: void eduom_FillData(char*, Four, Four)
+ *
+ * Description:
+ *  Fill the buffer with 'length' bytes of the data of the given seed.
+ *  The byte i of the data depends on the seed and i only, so that a part
+ *  of the data can be checked by eduom_CheckData().
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_FillData(
+    char        *buf,           /* OUT buffer to fill */
+    Four        seed,           /* IN seed of the data */
+    Four        length)         /* IN # of bytes to fill */
+{
+  Four i;
+
+  for (i = 0; i < length; i++) buf[i] = 'A' + (seed*7 + i) % 26;
+}
+
+
+
+/*@================================
+ * eduom_CheckData()
+ *================================*/
+/*
+ * Function: Boolean eduom_CheckData(char*, Four, Four, Four)
+ *
+ * Description:
+ *  Check the buffer holding 'length' bytes of the data of the given seed
+ *  from the byte 'start'.
+ *
+ * Returns:
+ *  TRUE if the data is correct
+ */
+static Boolean eduom_CheckData(
+    char        *buf,           /* IN buffer to check */
+    Four        seed,           /* IN seed of the data */
+    Four        start,          /* IN first byte of the data in the buffer */
+    Four        length)         /* IN # of bytes to check */
+{
+  Four i;
+
+  for (i = 0; i < length; i++)
+    if (buf[i] != 'A' + (seed*7 + start + i) % 26) return(FALSE);
+
+  return(TRUE);
+}
+
+
+
+/*@================================
+ * eduom_FillKeyData()
+ *================================*/
+/*
+ * Function: void eduom_FillKeyData(char*, char*, Four, Four)
+ *
+ * Description:
+ *  Fill the buffer with the key followed by the data made from the seed as
+ *  by eduom_FillData(), so that the objects with the same key share their
+ *  first bytes.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_FillKeyData(
+    char        *buf,           /* OUT buffer to fill */
+    char        *key,           /* IN key beginning the data */
+    Four        seed,           /* IN seed of the rest of the data */
+    Four        length)         /* IN # of bytes to fill */
+{
+  Four i;
+  Four n;
+
+  n = strlen(key);
+  for (i = 0; i < length; i++)
+    buf[i] = (i < n) ? key[i] : 'A' + (seed*7 + i) % 26;
+}
+
+
+
+/*@================================
+ * eduom_CheckKeyData()
+ *================================*/
+/*
+ * Function: Boolean eduom_CheckKeyData(char*, char*, Four, Four, Four)
+ *
+ * Description:
+ *  Check that the buffer holds the given bytes of the data filled by
+ *  eduom_FillKeyData() with the key and the seed.
+ *
+ * Returns:
+ *  TRUE if the data is right, otherwise FALSE
+ */
+static Boolean eduom_CheckKeyData(
+    char        *buf,           /* IN buffer to check */
+    char        *key,           /* IN key beginning the data */
+    Four        seed,           /* IN seed of the rest of the data */
+    Four        start,          /* IN first byte of the data in the buffer */
+    Four        length)         /* IN # of bytes to check */
+{
+  static char data[PAGESIZE];
+
+  eduom_FillKeyData(data, key, seed, start + length);
+
+  return((memcmp(buf, &data[start], length) == 0) ? TRUE : FALSE);
+}
+
+
+
+/*@================================
+ * eduom_PrintPageSpace()
+ *================================*/
+/*
+ * Function: Four eduom_PrintPageSpace(PageID*)
+ *
+ * Description:
+ *  Print the space accounting of the given page.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_PrintPageSpace(
+    PageID      *pid)           /* IN page to print */
+{
+  Four e;
+  SlottedPage *apage;
+
+  e = BfM_GetTrain(pid, (char**)&apage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  printf("PageID = (%d, %d) : nSlots = %d  free = %d  unused = %d  FREE = %d  CFREE = %d\n",
+         pid->volNo, pid->pageNo, apage->header.nSlots, apage->header.free, apage->header.unused,
+         SP_FREE(apage), SP_CFREE(apage));
+
+  e = BfM_FreeTrain(pid, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  return(eNOERROR);
+}
+
+
+
+/*@================================
+ * eduom_PrintObject()
+ *================================*/
+/*
+ * Function: Four eduom_PrintObject(ObjectID*, Four)
+ *
+ * Description:
+ *  Print the properties in the slot of the given object, and its length
+ *  and data as read by EduOM_ReadObject(), checked against the seed.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_PrintObject(
+    ObjectID    *oid,           /* IN object to print */
+    Four        seed)           /* IN seed of the data of the object */
+{
+  Four e;
+  PageID pid;
+  SlottedPage *apage;
+  ObjectHdr objHdr;
+  static char buf[PAGESIZE];
+
+  MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+  e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+  (Four) eduom_GetObject(apage, SP_OFFSET(apage, oid->slotNo), &objHdr, NULL);
+  e = BfM_FreeTrain(&pid, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  e = EduOM_ReadObject(oid, 0, REMAINDER, buf);
+  if (e < eNOERROR) ERR(e);
+
+  printf("The object ( %d, %d ) : properties = 0x%x  length = %d  data %s\n", oid->pageNo, oid->slotNo,
+         objHdr.properties, e, eduom_CheckData(buf, seed, 0, e) ? "OK" : "MISMATCH");
+
+  return(eNOERROR);
+}
+
+
+
+/*@================================
+ * eduom_PrintObjectV2()
+ *================================*/
+/*
+ * Function: Four eduom_PrintObjectV2(ObjectID*, Four)
+ *
+ * Description:
+ *  Print the header of the given object of a page of the format v2, the
+ *  bytes of its header in the data area, and its data as read by
+ *  EduOM_ReadObject(), checked against the seed. The header of the data
+ *  moved from a stub is printed too.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_PrintObjectV2(
+    ObjectID    *oid,           /* IN object to print */
+    Four        seed)           /* IN seed of the data of the object */
+{
+  Four e;
+  Four len;
+  Four space;
+  PageID pid;
+  SlottedPage *apage;
+  ObjectHdr objHdr;
+  ObjectID forward;
+  static char buf[PAGESIZE];
+
+  e = EduOM_ReadObject(oid, 0, REMAINDER, buf);
+  if (e < eNOERROR) ERR(e);
+  len = e;
+
+  MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+  e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+  space = eduom_GetObject(apage, SP_OFFSET(apage, oid->slotNo), &objHdr, NULL);
+  e = BfM_FreeTrain(&pid, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  printf("The object ( %d, %d ) : properties = 0x%x  tag = %d  length = %d  header = %d bytes  data %s\n",
+         oid->pageNo, oid->slotNo, objHdr.properties, objHdr.tag, len, space - objHdr.length,
+         eduom_CheckData(buf, seed, 0, len) ? "OK" : "MISMATCH");
+
+  if (objHdr.properties & P_MOVED) {
+    e = eduom_GetForward(oid, &forward);
+    if (e < eNOERROR) ERR(e);
+
+    MAKE_PAGEID(pid, forward.volNo, forward.pageNo);
+    e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+    space = eduom_GetObject(apage, SP_OFFSET(apage, forward.slotNo), &objHdr, NULL);
+    e = BfM_FreeTrain(&pid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    printf("  moved to ( %d, %d ) : properties = 0x%x  tag = %d  length = %d  header = %d bytes\n",
+           forward.pageNo, forward.slotNo, objHdr.properties, objHdr.tag, objHdr.length, space - objHdr.length);
+  }
+
+  return(eNOERROR);
+}
+
+
+
+/*@================================
+ * eduom_PrintPrefix()
+ *================================*/
+/*
+ * Function: Four eduom_PrintPrefix(PageID*)
+ *
+ * Description:
+ *  Print the prefix of the given page with a prefix.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_PrintPrefix(
+    PageID      *pid)           /* IN page to print */
+{
+  Four e;
+  SlottedPage *apage;
+
+  e = BfM_GetTrain(pid, (char**)&apage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  printf("Prefix of the page ( %d, %d ) = \"%.*s\"  (%d bytes)\n", pid->volNo, pid->pageNo,
+         SP_PREFIXLEN(apage), SP_PREFIX(apage), SP_PREFIXLEN(apage));
+
+  e = BfM_FreeTrain(pid, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  return(eNOERROR);
+}
+
+
+
+/*@================================
+ * eduom_PrintPrefixObject()
+ *================================*/
+/*
+ * Function: Four eduom_PrintPrefixObject(ObjectID*, char*, Four)
+ *
+ * Description:
+ *  Print the length of the given object of a page with a prefix, the # of
+ *  its first bytes kept in the prefix, and its data as read by
+ *  EduOM_ReadObject(), checked against the key and the seed.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_PrintPrefixObject(
+    ObjectID    *oid,           /* IN object to print */
+    char        *key,           /* IN key beginning the data of the object */
+    Four        seed)           /* IN seed of the rest of the data */
+{
+  Four e;
+  Four len;
+  Four space;
+  PageID pid;
+  SlottedPage *apage;
+  ObjectHdr objHdr;
+  static char buf[PAGESIZE];
+
+  e = EduOM_ReadObject(oid, 0, REMAINDER, buf);
+  if (e < eNOERROR) ERR(e);
+  len = e;
+
+  MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+  e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+  space = eduom_GetObject(apage, SP_OFFSET(apage, oid->slotNo), &objHdr, NULL);
+  e = BfM_FreeTrain(&pid, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  printf("The object ( %d, %d ) : \"%s\"  length = %d  shared = %d  data %s\n", oid->pageNo, oid->slotNo, key,
+         len, eduom_ObjectSize(PAGE_FORMAT_PREFIX, &objHdr) - space,
+         eduom_CheckKeyData(buf, key, seed, 0, len) ? "OK" : "MISMATCH");
+
+  return(eNOERROR);
+}
+
+
+
+/*@================================
+ * eduom_PrintCells()
+ *================================*/
+/*
+ * Function: Four eduom_PrintCells(PageID*)
+ *
+ * Description:
+ *  Print the cells of the given page of fixed-length objects; a cell in
+ *  use is printed as 'X', and a free one as '.'.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_PrintCells(
+    PageID      *pid)           /* IN page to print */
+{
+  Four e;
+  Four i;
+  SlottedPage *apage;
+
+  e = BfM_GetTrain(pid, (char**)&apage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  printf("PageID = (%d, %d) : cellSize = %d  nCells = %d  cells = ", pid->volNo, pid->pageNo,
+         SP_CELLSIZE(apage), SP_NCELLS(apage));
+  for (i = 0; i < SP_NCELLS(apage); i++) printf("%c", SP_CELLUSED(apage, i) ? 'X' : '.');
+  printf("\n");
+
+  e = BfM_FreeTrain(pid, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  return(eNOERROR);
+}
+
+
+
+/*@================================
+ * eduom_PrintScans()
+ *================================*/
+/*
+ * Function: Four eduom_PrintScans(ObjectID*)
+ *
+ * Description:
+ *  Print the objects of the file as found by EduOM_NextObject(),
+ *  EduOM_PrevObject(), and EduOM_FetchBatch(), with their lengths.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_PrintScans(
+    ObjectID    *catalogEntry)  /* IN file to scan */
+{
+  Four e;
+  Four i;
+  ObjectID oid, nextOid;
+  ObjectHdr objHdr;
+  EduOM_ScanCursor cursor;
+  ObjectID batchOids[8];
+  ObjectHdr batchHdrs[8];
+
+  printf("EduOM_NextObject() :");
+  e = EduOM_NextObject(catalogEntry, NULL, &oid, &objHdr);
+  while (e != EOS) {
+    if (e < eNOERROR) ERR(e);
+    printf(" (%d,%d):%d", oid.pageNo, oid.slotNo, objHdr.length);
+    e = EduOM_NextObject(catalogEntry, &oid, &nextOid, &objHdr);
+    oid = nextOid;
+  }
+  printf("\n");
+
+  printf("EduOM_PrevObject() :");
+  e = EduOM_PrevObject(catalogEntry, NULL, &oid, &objHdr);
+  while (e != EOS) {
+    if (e < eNOERROR) ERR(e);
+    printf(" (%d,%d):%d", oid.pageNo, oid.slotNo, objHdr.length);
+    e = EduOM_PrevObject(catalogEntry, &oid, &nextOid, &objHdr);
+    oid = nextOid;
+  }
+  printf("\n");
+
+  printf("EduOM_FetchBatch() :");
+  e = EduOM_OpenScan(catalogEntry, NULL, FORWARD, &cursor);
+  if (e < eNOERROR) ERR(e);
+  while ((e = EduOM_FetchBatch(&cursor, 8, batchOids, batchHdrs)) > 0)
+    for (i = 0; i < e; i++) printf(" (%d,%d):%d", batchOids[i].pageNo, batchOids[i].slotNo, batchHdrs[i].length);
+  printf("\n");
+  if (e < eNOERROR && e != EOS) ERR(e);
+  e = EduOM_CloseScan(&cursor);
+  if (e < eNOERROR) ERR(e);
+
+  /* no object can be asked for, since 0 is the end of the scan */
+  e = EduOM_OpenScan(catalogEntry, NULL, FORWARD, &cursor);
+  if (e < eNOERROR) ERR(e);
+  printf("EduOM_FetchBatch() of 0 objects : %s\n", eduom_ErrorName(EduOM_FetchBatch(&cursor, 0, batchOids, batchHdrs)));
+  e = EduOM_CloseScan(&cursor);
+  if (e < eNOERROR) ERR(e);
+
+  return(eNOERROR);
+}
+
+
+
+/*@================================
+ * eduom_PrintCompactions()
+ *================================*/
+/*
+ * Function: void eduom_PrintCompactions(void)
+ *
+ * Description:
+ *  Print the counters of the compactions since the last reset.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_PrintCompactions(void)
+{
+  EduOM_Stats stats;
+
+  (Four) EduOM_GetStats(&stats);
+
+  printf("compactions = %lu  compactRefusals = %lu  compactDeferrals = %lu  deferredCompactions = %lu\n",
+         stats.compactions, stats.compactRefusals, stats.compactDeferrals, stats.deferredCompactions);
+}
+
+
+
+/*@================================
+ * eduom_PrintPlacements()
+ *================================*/
+/*
+ * Function: void eduom_PrintPlacements(void)
+ *
+ * Description:
+ *  Print the counters of the placement of the new objects since the last
+ *  reset.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_PrintPlacements(void)
+{
+  EduOM_Stats stats;
+
+  (Four) EduOM_GetStats(&stats);
+
+  printf("appendHits = %lu  spaceMisses = %lu  pageAllocs = %lu\n",
+         stats.appendHits, stats.spaceMisses, stats.pageAllocs);
+}
+
+
+
+/*@================================
+ * eduom_GetForward()
+ *================================*/
+/*
+ * Function: Four eduom_GetForward(ObjectID*, ObjectID*)
+ *
+ * Description:
+ *  Get the ObjectID of the moved data of the given object from its stub.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ */
+static Four eduom_GetForward(
+    ObjectID    *oid,           /* IN moved object */
+    ObjectID    *forward)       /* OUT ObjectID of the moved data */
+{
+  Four e;
+  PageID pid;
+  SlottedPage *apage;
+  ObjectHdr objHdr;
+
+  MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+  e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  (Four) eduom_GetObject(apage, SP_OFFSET(apage, oid->slotNo), &objHdr, NULL);
+  if (!(objHdr.properties & P_MOVED)) ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+
+  eduom_ReadData(apage, SP_OFFSET(apage, oid->slotNo), 0, FORWARD_STUBLEN, (char*)forward);
+
+  e = BfM_FreeTrain(&pid, PAGE_BUF);
+  if (e < eNOERROR) ERR(e);
+
+  return(eNOERROR);
+}
+
+
+
+/*@================================
+ * eduom_ErrorName()
+ *================================*/
+/*
+ * Function: char *eduom_ErrorName(Four)
+ *
+ * Description:
+ *  Return the name of the given result of an EduOM function.
+ *
+ * Returns:
+ *  name of the result
+ */
+static char *eduom_ErrorName(
+    Four        e)              /* IN result of a function */
+{
+  if (e >= eNOERROR) return("eNOERROR");
+
+  switch (e) {
+  case eBADPARAMETER_OM:      return("eBADPARAMETER_OM");
+  case eBADOBJECTID_OM:       return("eBADOBJECTID_OM");
+  case eBADLENGTH_OM:         return("eBADLENGTH_OM");
+  case eNOSPACEFORSTUB_EDUOM: return("eNOSPACEFORSTUB_EDUOM");
+  case eNOTSUPPORTED_EDUOM:   return("eNOTSUPPORTED_EDUOM");
+  case eFILENOTEMPTY_EDUOM:   return("eFILENOTEMPTY_EDUOM");
+  default:                    return("another error");
+  }
+}
+
+
+
+/*@================================
+ * eduom_ScanCallback()
+ *================================*/
+/*
+ * Function: Four eduom_ScanCallback(Four, ObjectID*, ObjectHdr*, const char*, void*)
+ *
+ * Description:
+ *  Count the objects delivered by EduOM_ParallelScan() and those of 2000
+ *  bytes, whose data must be that of the moved object of TEST#5. An object
+ *  with wrong data stops the scan.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ */
+static Four eduom_ScanCallback(
+    Four        threadNo,       /* IN number of the worker thread */
+    ObjectID    *oid,           /* IN object delivered */
+    ObjectHdr   *objHdr,        /* IN header of the object */
+    const char  *data,          /* IN data of the object */
+    void        *arg)           /* INOUT # of objects and of the objects of 2000 bytes */
+{
+  Four *counts = (Four*)arg;
+
+  if (objHdr->properties & (P_MOVED | P_FORWARDED)) return(eBADOBJECTID_OM);
+
+  counts[0]++;
+  if (objHdr->length == 2000) {
+    if (!eduom_CheckData((char*)data, 7, 0, 2000)) return(eBADOBJECTID_OM);
+    counts[1]++;
+  }
+
+  return(eNOERROR);
+}
@@ -0,0 +1,984 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_FreeSpaceMap.c
+ *
+ * Description:
+ *  Maintain the free space map of data files. Each page of a file is
+ *  summarized by one byte, the size of its free space in units of
+ *  FSM_UNIT bytes, and a max tree is kept over the bytes so that a page
+ *  with enough free space is found in O(log #pages). The map is kept in main
+ *  memory and is built from the pages of the file when it is missing; the
+ *  table of the maps grows with the # of files used, so that a map is built
+ *  only on the first use of its file or after it is discarded.
+ *  Since other modules may update the pages without updating the map, the
+ *  map is used as a hint; a page found through the map must be checked.
+ *  A file may use the placement policy PLACEMENT_SIZECLASS; then each page
+ *  has the size class of the objects put into it, the map keeps one tree per
+ *  size class, and a new object is put into a page of its own class, so that
+ *  the holes left by deleted objects are refilled by objects of similar size.
+ *  The classes are kept only in main memory; when the map is rebuilt, a page
+ *  gets the class of its first object.
+ *  Under PLACEMENT_DEFAULT, the page last allocated by an insertion is kept
+ *  with its exact free space as the append page; an insertion which fits
+ *  into it does not search the tree, so that appends to a file cost O(1).
+ *  The map also keeps the format of the first page of a file, which
+ *  EduOM_SetPageFormat() sets; the new pages of the file get the format.
+ *  EduOM_SetFixedLength() gives a file the format for fixed-length objects,
+ *  whose pages are arrays of cells of the length kept in the first page.
+ *
+ * Exports:
+ *  Four EduOM_SetPlacementPolicy(ObjectID*, Four)
+ *  Four EduOM_SetPageFormat(ObjectID*, Four)
+ *  Four EduOM_SetFixedLength(ObjectID*, Four)
+ *
+ * Internal Functions:
+ *  Four eduom_GetFreeSpaceMap(ObjectID*, sm_CatOverlayForData*, FreeSpaceMap**)
+ *  Four eduom_FsmSetPage(FreeSpaceMap*, PageNo, Four)
+ *  Four eduom_FsmSetClass(FreeSpaceMap*, PageNo, Four)
+ *  Four eduom_FsmSearch(FreeSpaceMap*, Four, Four, PageNo*)
+ *  void eduom_FsmSetAppendPage(FreeSpaceMap*, PageNo)
+ *  void eduom_FsmInvalidate(ObjectID*)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "EduOM_common.h"
+#include "Util.h"		/* to get VarArray */
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+/*@
+ * Global variables
+ */
+/* pointers to the free space maps of the data files used */
+static VarArray eduom_fsmTable = {0, NULL};
+static Four eduom_nFsms = 0;		/* # of maps in the table */
+
+/* files using a placement policy other than PLACEMENT_DEFAULT */
+static PlacementEntry eduom_placementTable[PLACEMENT_MAXFILES];
+
+/* TRUE if the append page of a map is tried before the tree */
+Boolean eduom_useAppendPage = TRUE;
+
+
+/*@
+ * Internal function prototypes
+ */
+static void eduom_FsmUpdate(UOne*, Four, Four, UOne);
+static PageNo eduom_FsmDescend(FreeSpaceMap*, Four, UOne);
+static Four eduom_FsmResize(FreeSpaceMap*, PageNo);
+static Four eduom_FsmBuild(FreeSpaceMap*, ObjectID*, sm_CatOverlayForData*);
+static Four eduom_SetFileFormat(ObjectID*, Four, Four);
+
+
+
+/*@================================
+ * EduOM_SetPlacementPolicy()
+ *================================*/
+/*
+ * Function: Four EduOM_SetPlacementPolicy(ObjectID*, Four)
+ *
+ * Description:
+ *  Set the placement policy of the given data file, which decides the page
+ *  into which a new object is put when no near object is given:
+ *   PLACEMENT_DEFAULT   : the page whose free space fits best
+ *   PLACEMENT_SIZECLASS : the page last used for the size class of the
+ *                         object, or else the page of that class whose free
+ *                         space fits best, or else an empty page
+ *  The policy is kept in main memory until it is set again or the file is
+ *  dropped. The free space map of the file is rebuilt on its next use.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    eTOOMANYFILES_EDUOM
+ *    some errors caused by function calls
+ */
+Four EduOM_SetPlacementPolicy(
+    ObjectID  *catObjForFile,	/* IN catalog object of the data file */
+    Four      policy)		/* IN PLACEMENT_DEFAULT or PLACEMENT_SIZECLASS */
+{
+    Four e;			/* error */
+    Four i;			/* index variable */
+    sm_CatOverlayForData *catEntry; /* catalog entry of the data file */
+    PlacementEntry *entry;	/* entry of the file */
+
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (policy != PLACEMENT_DEFAULT && policy != PLACEMENT_SIZECLASS) ERR(eBADPARAMETER_OM);
+
+    STAT_BEGIN(STAT_OP_FILE);
+
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+
+    /*@ find the entry of the file, or an empty entry */
+    entry = NULL;
+    for (i = 0; i < PLACEMENT_MAXFILES; i++) {
+        if (eduom_placementTable[i].policy != PLACEMENT_DEFAULT &&
+            EQUAL_OBJECTID(eduom_placementTable[i].catObjForFile, *catObjForFile)) {
+            entry = &eduom_placementTable[i];
+            break;
+        }
+
+        if (entry == NULL && eduom_placementTable[i].policy == PLACEMENT_DEFAULT)
+            entry = &eduom_placementTable[i];
+    }
+
+    if (entry == NULL) {
+        if (policy == PLACEMENT_DEFAULT) return(eNOERROR);
+        ERR(eTOOMANYFILES_EDUOM);
+    }
+
+    entry->catObjForFile = *catObjForFile;
+    entry->fid = catEntry->fid;
+    entry->policy = policy;
+
+    eduom_FsmInvalidate(catObjForFile);
+
+    return(eNOERROR);
+
+} /* EduOM_SetPlacementPolicy() */
+
+
+
+/*@================================
+ * EduOM_SetPageFormat()
+ *================================*/
+/*
+ * Function: Four EduOM_SetPageFormat(ObjectID*, Four)
+ *
+ * Description:
+ *  Set the format of the pages of the given data file to PAGE_FORMAT_V1,
+ *  PAGE_FORMAT_V2, or PAGE_FORMAT_PREFIX. The format is kept in the first
+ *  page of the file, so the file must be empty, i.e., its first page has no
+ *  object and no page follows it. A page of the format other than v1 is
+ *  taken out of the available space lists, and a page of the format v1 is
+ *  put back. The format for fixed-length objects is set by
+ *  EduOM_SetFixedLength().
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    eFILENOTEMPTY_EDUOM
+ *    eVOLUMEMAPPED_EDUOM
+ *    some errors caused by function calls
+ */
+Four EduOM_SetPageFormat(
+    ObjectID  *catObjForFile,	/* IN catalog object of the data file */
+    Four      format)		/* IN PAGE_FORMAT_V1, PAGE_FORMAT_V2, or PAGE_FORMAT_PREFIX */
+{
+    Four e;			/* error */
+
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (eduom_IsMappedVolume(catObjForFile->volNo)) ERR(eVOLUMEMAPPED_EDUOM);
+
+    if (format != PAGE_FORMAT_V1 && format != PAGE_FORMAT_V2 && format != PAGE_FORMAT_PREFIX)
+        ERR(eBADPARAMETER_OM);
+
+    STAT_BEGIN(STAT_OP_FILE);
+
+    e = eduom_SetFileFormat(catObjForFile, format, 0);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_SetPageFormat() */
+
+
+
+/*@================================
+ * EduOM_SetFixedLength()
+ *================================*/
+/*
+ * Function: Four EduOM_SetFixedLength(ObjectID*, Four)
+ *
+ * Description:
+ *  Make the given data file a file of fixed-length objects of 'length'
+ *  bytes. The pages of the file have no slot array and no object headers;
+ *  an object is found in the cell of its slot number, and the cells in use
+ *  are kept in a bitmap. The objects of a page share the unique number of
+ *  the page. The file must be empty, and every object created in it must
+ *  have the given length.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADLENGTH_OM
+ *    eFILENOTEMPTY_EDUOM
+ *    eVOLUMEMAPPED_EDUOM
+ *    some errors caused by function calls
+ */
+Four EduOM_SetFixedLength(
+    ObjectID  *catObjForFile,	/* IN catalog object of the data file */
+    Four      length)		/* IN length of the objects of the file */
+{
+    Four e;			/* error */
+
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (eduom_IsMappedVolume(catObjForFile->volNo)) ERR(eVOLUMEMAPPED_EDUOM);
+
+    if (length < 1 || length > FIXED_MAXCELLSIZE) ERR(eBADLENGTH_OM);
+
+    STAT_BEGIN(STAT_OP_FILE);
+
+    e = eduom_SetFileFormat(catObjForFile, PAGE_FORMAT_FIXED, length);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_SetFixedLength() */
+
+
+
+/*@================================
+ * eduom_SetFileFormat()
+ *================================*/
+/*
+ * Function: Four eduom_SetFileFormat(ObjectID*, Four, Four)
+ *
+ * Description:
+ *  Empty the first page of the given empty data file in the given format.
+ *  The page of a format other than v1 reserves unique numbers; a page of
+ *  the format for fixed-length objects gets the cell length and a unique
+ *  number shared by its objects.
+ *
+ * Returns:
+ *  error code
+ *    eFILENOTEMPTY_EDUOM
+ *    some errors caused by function calls
+ */
+static Four eduom_SetFileFormat(
+    ObjectID  *catObjForFile,	/* IN catalog object of the data file */
+    Four      format,		/* IN one of PAGE_FORMAT_* */
+    Four      cellSize)		/* IN length of the objects for PAGE_FORMAT_FIXED */
+{
+    Four e;			/* error */
+    Two i;			/* index variable */
+    sm_CatOverlayForData *catEntry; /* catalog entry of the data file */
+    PageID pid;			/* first page of the file */
+    SlottedPage *apage;		/* pointer to the first page */
+    Unique unique;		/* unique number reserved by the page */
+
+
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+
+    MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+
+    e = EDUOM_GETTRAIN(&pid, (char**)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+    STAT_PIN();
+
+    if (eduom_ClearStaleFormat(apage)) {
+        e = BfM_SetDirty(&pid, PAGE_BUF);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+    }
+
+    if (SP_FORMAT(apage) == format && (format != PAGE_FORMAT_FIXED || SP_CELLSIZE(apage) == cellSize)) {
+        e = BfM_FreeTrain(&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        return(eNOERROR);
+    }
+
+    for (i = 0; i < apage->header.nSlots; i++)
+        if (SP_OFFSET(apage, i) != EMPTYSLOT) break;
+
+    if (i < apage->header.nSlots || apage->header.nextPage != NIL)
+        ERRB1(eFILENOTEMPTY_EDUOM, &pid, PAGE_BUF);
+
+    /*@ the other modules must not find the page through the lists */
+    if (SP_LIST_CATEGORY(apage, SP_FREE(apage)) != 0) {
+        e = om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
+        eduom_CatalogEntryChanged(catObjForFile);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+        STAT_ADD(availListRemoves, 1);
+    }
+
+    /*@ restore the initial state of an empty page in the new format */
+    apage->header.flags &= ~(SP_FORMAT_V2 | SP_FORMAT_PREFIX | SP_FORMAT_FIXED);
+    apage->header.flags |= FORMAT_FLAGS(format);
+
+    /* the reserved unique numbers tell the format from the bits left by the library */
+    if (format != PAGE_FORMAT_V1) {
+        e = eduom_GetUnique(&pid, apage, &unique);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+    }
+
+    if (format == PAGE_FORMAT_FIXED) {
+        SP_FIXEDUNIQUE(apage) = unique;
+        SP_CELLSIZE(apage) = cellSize;
+    }
+
+    apage->header.nSlots = 1;
+    SET_SP_OFFSET(apage, 0, EMPTYSLOT);
+    eduom_InitDataArea(apage);
+    SET_SP_EMPTYSLOT_HINT(apage, 0);
+
+    if (SP_LIST_CATEGORY(apage, SP_FREE(apage)) != 0) {
+        e = om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+        eduom_CatalogEntryChanged(catObjForFile);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+        STAT_ADD(availListPuts, 1);
+    }
+
+    e = BfM_SetDirty(&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    e = BfM_FreeTrain(&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    /* the free space map keeps the format of the new pages */
+    eduom_FsmInvalidate(catObjForFile);
+
+    return(eNOERROR);
+
+} /* eduom_SetFileFormat() */
+
+
+
+/*@================================
+ * eduom_GetFreeSpaceMap()
+ *================================*/
+/*
+ * Function: Four eduom_GetFreeSpaceMap(ObjectID*, sm_CatOverlayForData*, FreeSpaceMap**)
+ *
+ * Description:
+ *  Return the free space map of the given data file. If the map is not in
+ *  the table, or it describes another file which had the same catalog
+ *  object before, the map is built by reading all the pages of the file.
+ *  The new map takes an empty entry of the table; if there is none, the
+ *  table grows instead of a map of another file being replaced, so that the
+ *  files used in turn do not rebuild each other's maps.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eMEMORYALLOCERR_EDUOM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter fsm
+ *     fsm points to the free space map of the file
+ */
+Four eduom_GetFreeSpaceMap(
+    ObjectID  *catObjForFile,	/* IN catalog object of the data file */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the data file */
+    FreeSpaceMap **fsm)		/* OUT free space map of the file */
+{
+    Four e;			/* error */
+    Four i;			/* index variable */
+    FreeSpaceMap **maps;	/* maps in the table */
+    FreeSpaceMap *entry;	/* entry into which the map is built */
+
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL || catEntry == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    maps = (FreeSpaceMap**)eduom_fsmTable.ptr;
+    entry = NULL;
+    for (i = 0; i < eduom_nFsms; i++) {
+        if (maps[i]->valid &&
+            EQUAL_OBJECTID(maps[i]->catObjForFile, *catObjForFile)) {
+
+            if (EQUAL_FILEID(maps[i]->fid, catEntry->fid) &&
+                maps[i]->firstPage == catEntry->firstPage) {
+                *fsm = maps[i];
+                return(eNOERROR);
+            }
+
+            /* the catalog object now describes another file */
+            entry = maps[i];
+            break;
+        }
+
+        if (entry == NULL && !maps[i]->valid) entry = maps[i];
+    }
+
+    /*@ add an entry to the table */
+    if (entry == NULL) {
+        if (eduom_fsmTable.ptr == NULL) {
+            e = Util_initVarArray(&eduom_fsmTable, sizeof(FreeSpaceMap*), FSM_INITFILES);
+            if (e < 0) ERR(e);
+        } else if (eduom_nFsms == eduom_fsmTable.nEntries) {
+            e = Util_reallocVarArray(&eduom_fsmTable, sizeof(FreeSpaceMap*), 2*eduom_fsmTable.nEntries);
+            if (e < 0) ERR(e);
+        }
+
+        /* the maps are allocated one by one so that a map does not move when the table grows */
+        entry = (FreeSpaceMap*)calloc(1, sizeof(FreeSpaceMap));
+        if (entry == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+        ((FreeSpaceMap**)eduom_fsmTable.ptr)[eduom_nFsms++] = entry;
+    }
+
+    e = eduom_FsmBuild(entry, catObjForFile, catEntry);
+    if (e < 0) ERR(e);
+
+    entry->valid = TRUE;
+    *fsm = entry;
+
+    return(eNOERROR);
+
+} /* eduom_GetFreeSpaceMap() */
+
+
+
+/*@================================
+ * eduom_FsmSetPage()
+ *================================*/
+/*
+ * Function: Four eduom_FsmSetPage(FreeSpaceMap*, PageNo, Four)
+ *
+ * Description:
+ *  Record the free space of the given page in the map. A page removed from
+ *  the file is recorded with 0 bytes of free space. The tree of the class of
+ *  the page is updated only when the summary byte of the page changes, and
+ *  only up to the node whose value does not change. The free space of the
+ *  append page is kept exactly.
+ *
+ * Returns:
+ *  error code
+ *    eBADPAGEID_OM
+ *    some errors caused by function calls
+ */
+Four eduom_FsmSetPage(
+    FreeSpaceMap *fsm,		/* INOUT free space map */
+    PageNo    pageNo,		/* IN page whose free space is changed */
+    Four      freeSpace)	/* IN free space of the page */
+{
+    Four e;			/* error */
+    Four leaf;			/* leaf of the page */
+    Four sizeClass;		/* size class of the page */
+    UOne value;			/* summary of the free space */
+
+
+    if (pageNo == NIL) ERR(eBADPAGEID_OM);
+
+    if (pageNo == fsm->appendPage) fsm->appendFree = freeSpace;
+
+    value = FSM_SUMMARY(freeSpace);
+
+    if (pageNo < fsm->basePage || pageNo >= fsm->basePage + fsm->nLeaves) {
+        if (value == 0) return(eNOERROR);
+
+        e = eduom_FsmResize(fsm, pageNo);
+        if (e < 0) ERR(e);
+    }
+
+    leaf = pageNo - fsm->basePage;
+    sizeClass = (fsm->nTrees > 1) ? ((UOne*)fsm->pageClass.ptr)[leaf] : 0;
+
+    eduom_FsmUpdate((UOne*)fsm->tree[sizeClass].ptr, fsm->nLeaves, leaf, value);
+
+    return(eNOERROR);
+
+} /* eduom_FsmSetPage() */
+
+
+
+/*@================================
+ * eduom_FsmSetClass()
+ *================================*/
+/*
+ * Function: Four eduom_FsmSetClass(FreeSpaceMap*, PageNo, Four)
+ *
+ * Description:
+ *  Set the size class of the given page; its free space moves to the tree
+ *  of the new class. A page of a class becomes the page into which the next
+ *  object of the class is put first, and a page which became empty is given
+ *  the class 0 so that it can be used by any class. Nothing is done unless
+ *  the file uses PLACEMENT_SIZECLASS.
+ *
+ * Returns:
+ *  error code
+ *    eBADPAGEID_OM
+ *    some errors caused by function calls
+ */
+Four eduom_FsmSetClass(
+    FreeSpaceMap *fsm,		/* INOUT free space map */
+    PageNo    pageNo,		/* IN page whose class is set */
+    Four      sizeClass)	/* IN size class; 0 for none */
+{
+    Four e;			/* error */
+    Four leaf;			/* leaf of the page */
+    UOne *pageClass;		/* size class of each page */
+    UOne value;			/* summary of the free space */
+
+
+    if (fsm->nTrees == 1) return(eNOERROR);
+
+    if (pageNo == NIL) ERR(eBADPAGEID_OM);
+
+    if (pageNo < fsm->basePage || pageNo >= fsm->basePage + fsm->nLeaves) {
+        if (sizeClass == 0) return(eNOERROR);
+
+        e = eduom_FsmResize(fsm, pageNo);
+        if (e < 0) ERR(e);
+    }
+
+    leaf = pageNo - fsm->basePage;
+    pageClass = (UOne*)fsm->pageClass.ptr;
+
+    if (pageClass[leaf] != sizeClass) {
+        value = ((UOne*)fsm->tree[pageClass[leaf]].ptr)[fsm->nLeaves + leaf];
+
+        eduom_FsmUpdate((UOne*)fsm->tree[pageClass[leaf]].ptr, fsm->nLeaves, leaf, 0);
+        eduom_FsmUpdate((UOne*)fsm->tree[sizeClass].ptr, fsm->nLeaves, leaf, value);
+        pageClass[leaf] = sizeClass;
+    }
+
+    if (sizeClass != 0) fsm->insertPage[sizeClass] = pageNo;
+
+    return(eNOERROR);
+
+} /* eduom_FsmSetClass() */
+
+
+
+/*@================================
+ * eduom_FsmSearch()
+ *================================*/
+/*
+ * Function: Four eduom_FsmSearch(FreeSpaceMap*, Four, Four, PageNo*)
+ *
+ * Description:
+ *  Find a page which has at least 'neededSpace' bytes of free space. When
+ *  both subtrees of a node have enough space, the search goes down to the
+ *  subtree with less space, so the page found is a near fit.
+ *  Under PLACEMENT_SIZECLASS, the page last used for the given size class is
+ *  tried first, then the pages of the class and then the empty pages.
+ *  Under PLACEMENT_DEFAULT, the append page is tried first, and 'sizeClass'
+ *  is ignored.
+ *
+ * Returns:
+ *  error code
+ *    eNOERROR
+ *
+ * Side effect:
+ *  1) parameter pageNo
+ *     pageNo is set to the page found, or NIL if there is no such page
+ */
+Four eduom_FsmSearch(
+    FreeSpaceMap *fsm,		/* IN free space map */
+    Four      neededSpace,	/* IN needed free space */
+    Four      sizeClass,	/* IN size class of the object */
+    PageNo    *pageNo)		/* OUT page found */
+{
+    UOne needed;		/* summary of the needed space */
+    PageNo last;		/* page last used for the class */
+
+
+    needed = FSM_SUMMARY(neededSpace + FSM_UNIT - 1);
+
+    if (fsm->nTrees == 1) {
+        if (eduom_useAppendPage && fsm->appendPage != NIL && fsm->appendFree >= neededSpace) {
+            STAT_ADD(appendHits, 1);
+            *pageNo = fsm->appendPage;
+            return(eNOERROR);
+        }
+
+        *pageNo = eduom_FsmDescend(fsm, 0, needed);
+        return(eNOERROR);
+    }
+
+    last = fsm->insertPage[sizeClass];
+    if (last != NIL && last >= fsm->basePage && last < fsm->basePage + fsm->nLeaves &&
+        ((UOne*)fsm->tree[sizeClass].ptr)[fsm->nLeaves + (last - fsm->basePage)] >= needed) {
+        *pageNo = last;
+        return(eNOERROR);
+    }
+
+    *pageNo = eduom_FsmDescend(fsm, sizeClass, needed);
+    if (*pageNo == NIL) *pageNo = eduom_FsmDescend(fsm, 0, needed);
+
+    return(eNOERROR);
+
+} /* eduom_FsmSearch() */
+
+
+
+/*@================================
+ * eduom_FsmSetAppendPage()
+ *================================*/
+/*
+ * Function: void eduom_FsmSetAppendPage(FreeSpaceMap*, PageNo)
+ *
+ * Description:
+ *  Make the given page, just allocated by an insertion, the append page of
+ *  the map. Its free space is recorded by the following eduom_FsmSetPage().
+ *  Nothing is done unless the file uses PLACEMENT_DEFAULT.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_FsmSetAppendPage(
+    FreeSpaceMap *fsm,		/* INOUT free space map */
+    PageNo    pageNo)		/* IN page allocated */
+{
+    if (fsm->nTrees > 1) return;
+
+    fsm->appendPage = pageNo;
+    fsm->appendFree = 0;
+
+} /* eduom_FsmSetAppendPage() */
+
+
+
+/*@================================
+ * eduom_FsmInvalidate()
+ *================================*/
+/*
+ * Function: void eduom_FsmInvalidate(ObjectID*)
+ *
+ * Description:
+ *  Discard the free space map of the given data file, e.g., when the file
+ *  is dropped. If 'catObjForFile' is NULL, all the maps are discarded.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_FsmInvalidate(
+    ObjectID  *catObjForFile)	/* IN catalog object of the data file; NULL for all */
+{
+    Four i;			/* index variable */
+    FreeSpaceMap **maps;	/* maps in the table */
+
+
+    maps = (FreeSpaceMap**)eduom_fsmTable.ptr;
+    for (i = 0; i < eduom_nFsms; i++) {
+        if (catObjForFile == NULL ||
+            EQUAL_OBJECTID(maps[i]->catObjForFile, *catObjForFile))
+            maps[i]->valid = FALSE;
+    }
+
+} /* eduom_FsmInvalidate() */
+
+
+
+/*@================================
+ * eduom_FsmUpdate()
+ *================================*/
+/*
+ * Function: void eduom_FsmUpdate(UOne*, Four, Four, UOne)
+ *
+ * Description:
+ *  Set a leaf of a max tree and update its ancestors up to the node whose
+ *  value does not change.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_FsmUpdate(
+    UOne      *tree,		/* INOUT the max tree */
+    Four      nLeaves,		/* IN # of leaves of the tree */
+    Four      leaf,		/* IN leaf to be set */
+    UOne      value)		/* IN new value of the leaf */
+{
+    Four node;			/* node of the tree */
+
+
+    node = nLeaves + leaf;
+
+    if (tree[node] == value) return;
+
+    tree[node] = value;
+    for (node /= 2; node >= 1; node /= 2) {
+        value = MAX(tree[2*node], tree[2*node+1]);
+        if (tree[node] == value) break;
+        tree[node] = value;
+    }
+
+} /* eduom_FsmUpdate() */
+
+
+
+/*@================================
+ * eduom_FsmDescend()
+ *================================*/
+/*
+ * Function: PageNo eduom_FsmDescend(FreeSpaceMap*, Four, UOne)
+ *
+ * Description:
+ *  Go down the given tree of the map to the page whose free space fits the
+ *  needed summary best.
+ *
+ * Returns:
+ *  page found, or NIL if there is no such page
+ */
+static PageNo eduom_FsmDescend(
+    FreeSpaceMap *fsm,		/* IN free space map */
+    Four      t,		/* IN tree to search */
+    UOne      needed)		/* IN summary of the needed space */
+{
+    Four node;			/* node of the tree */
+    UOne *tree;			/* the max tree */
+
+
+    tree = (UOne*)fsm->tree[t].ptr;
+
+    if (fsm->nLeaves == 0 || tree[1] < needed) return(NIL);
+
+    for (node = 1; node < fsm->nLeaves; ) {
+        if (tree[2*node] >= needed &&
+            (tree[2*node+1] < needed || tree[2*node] <= tree[2*node+1]))
+            node = 2*node;
+        else
+            node = 2*node + 1;
+    }
+
+    return(fsm->basePage + (node - fsm->nLeaves));
+
+} /* eduom_FsmDescend() */
+
+
+
+/*@================================
+ * eduom_FsmResize()
+ *================================*/
+/*
+ * Function: Four eduom_FsmResize(FreeSpaceMap*, PageNo)
+ *
+ * Description:
+ *  Enlarge the range of pages covered by the map so that it includes the
+ *  given page. The number of leaves is kept to a power of 2. All the trees
+ *  and the size classes of the pages cover the same range.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_FsmResize(
+    FreeSpaceMap *fsm,		/* INOUT free space map */
+    PageNo    pageNo)		/* IN page to be covered */
+{
+    Four e;			/* error */
+    Four i;			/* index variable */
+    Four t;			/* index of the tree */
+    PageNo base;		/* new page number of the leaf 0 */
+    PageNo end;			/* new page number after the last leaf */
+    Four nLeaves;		/* new # of leaves */
+    Four nOld;			/* # of old leaves kept */
+    Four n;			/* # of old leaves kept for a tree */
+    UOne *tree;			/* the max tree */
+    UOne *pageClass;		/* size class of each page */
+
+
+    /* the leaves after the last page having free space or a class are not kept */
+    nOld = 0;
+    for (t = 0; t < fsm->nTrees; t++) {
+        tree = (UOne*)fsm->tree[t].ptr;
+        for (n = fsm->nLeaves; n > nOld && tree[fsm->nLeaves + n - 1] == 0; n--);
+        nOld = n;
+    }
+    if (fsm->nTrees > 1) {
+        pageClass = (UOne*)fsm->pageClass.ptr;
+        for (n = fsm->nLeaves; n > nOld && pageClass[n - 1] == 0; n--);
+        nOld = n;
+    }
+
+    if (nOld == 0) {
+        base = pageNo;
+        end = pageNo + 1;
+    } else {
+        base = (pageNo < fsm->basePage) ? pageNo : fsm->basePage;
+        end = (pageNo >= fsm->basePage + nOld) ? pageNo + 1 : fsm->basePage + nOld;
+    }
+
+    for (nLeaves = FSM_MINLEAVES; nLeaves < end - base; nLeaves *= 2);
+
+    for (t = 0; t < fsm->nTrees; t++) {
+        if (fsm->tree[t].nEntries < 2*nLeaves) {
+            e = Util_reallocVarArray(&fsm->tree[t], sizeof(UOne), 2*nLeaves);
+            if (e < 0) ERR(e);
+        }
+        tree = (UOne*)fsm->tree[t].ptr;
+
+        /* move the old leaves to their new positions and clear the others */
+        if (nOld > 0) {
+            memmove(&tree[nLeaves + (fsm->basePage - base)], &tree[fsm->nLeaves], nOld);
+            memset(&tree[nLeaves], 0, fsm->basePage - base);
+        }
+        i = (nOld > 0) ? nLeaves + (fsm->basePage - base) + nOld : nLeaves;
+        memset(&tree[i], 0, 2*nLeaves - i);
+
+        /* rebuild the internal nodes */
+        for (i = nLeaves - 1; i >= 1; i--)
+            tree[i] = MAX(tree[2*i], tree[2*i+1]);
+    }
+
+    if (fsm->nTrees > 1) {
+        if (fsm->pageClass.nEntries < nLeaves) {
+            e = Util_reallocVarArray(&fsm->pageClass, sizeof(UOne), nLeaves);
+            if (e < 0) ERR(e);
+        }
+        pageClass = (UOne*)fsm->pageClass.ptr;
+
+        if (nOld > 0) {
+            memmove(&pageClass[fsm->basePage - base], &pageClass[0], nOld);
+            memset(&pageClass[0], 0, fsm->basePage - base);
+        }
+        i = (nOld > 0) ? (fsm->basePage - base) + nOld : 0;
+        memset(&pageClass[i], 0, nLeaves - i);
+    }
+
+    fsm->basePage = base;
+    fsm->nLeaves = nLeaves;
+
+    return(eNOERROR);
+
+} /* eduom_FsmResize() */
+
+
+
+/*@================================
+ * eduom_FsmBuild()
+ *================================*/
+/*
+ * Function: Four eduom_FsmBuild(FreeSpaceMap*, ObjectID*, sm_CatOverlayForData*)
+ *
+ * Description:
+ *  Build the free space map of the given data file by reading all the
+ *  pages of the file along 'nextPage'. Under PLACEMENT_SIZECLASS, a page
+ *  gets the size class of its first object which is not a stub. The format
+ *  of the first page is kept as the format of the new pages, with its cell
+ *  length if the objects have a fixed length.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_FsmBuild(
+    FreeSpaceMap *fsm,		/* OUT free space map */
+    ObjectID  *catObjForFile,	/* IN catalog object of the data file */
+    sm_CatOverlayForData *catEntry) /* IN catalog entry of the data file */
+{
+    Four e;			/* error */
+    Four i;			/* index variable */
+    Four t;			/* index of the tree */
+    Four sizeClass;		/* size class of a page */
+    PageID pid;			/* a page of the file */
+    ShortPageID nextPage;	/* next page of the file */
+    SlottedPage *apage;		/* a pointer to the data page */
+    ObjectHdr objHdr;		/* header of the first object of a page */
+
+
+    /*@ the file has a tree per size class if it uses PLACEMENT_SIZECLASS */
+    fsm->nTrees = 1;
+    for (i = 0; i < PLACEMENT_MAXFILES; i++) {
+        if (eduom_placementTable[i].policy == PLACEMENT_SIZECLASS &&
+            EQUAL_OBJECTID(eduom_placementTable[i].catObjForFile, *catObjForFile) &&
+            EQUAL_FILEID(eduom_placementTable[i].fid, catEntry->fid)) {
+            fsm->nTrees = SIZECLASS_NCLASSES + 1;
+            break;
+        }
+    }
+
+    for (t = 0; t < fsm->nTrees; t++) {
+        if (fsm->tree[t].ptr == NULL) {
+            e = Util_initVarArray(&fsm->tree[t], sizeof(UOne), 2*FSM_MINLEAVES);
+            if (e < 0) ERR(e);
+        }
+        memset(fsm->tree[t].ptr, 0, 2*FSM_MINLEAVES);
+        fsm->insertPage[t] = NIL;
+    }
+    fsm->appendPage = NIL;
+    fsm->appendFree = 0;
+    fsm->format = PAGE_FORMAT_V1;
+    fsm->cellSize = 0;
+
+    if (fsm->nTrees > 1) {
+        if (fsm->pageClass.ptr == NULL) {
+            e = Util_initVarArray(&fsm->pageClass, sizeof(UOne), FSM_MINLEAVES);
+            if (e < 0) ERR(e);
+        }
+        memset(fsm->pageClass.ptr, 0, FSM_MINLEAVES);
+    }
+
+    fsm->catObjForFile = *catObjForFile;
+    fsm->fid = catEntry->fid;
+    fsm->firstPage = catEntry->firstPage;
+    fsm->basePage = catEntry->firstPage;
+    fsm->nLeaves = FSM_MINLEAVES;
+
+    MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+    while (pid.pageNo != NIL) {
+        e = EDUOM_GETTRAIN(&pid, (char**)&apage, PAGE_BUF);
+        if (e < 0) {
+            fsm->valid = FALSE;
+            ERR(e);
+        }
+        STAT_PIN();
+
+        /* a page reused by the storage library may keep the bits of another format */
+        if (eduom_ClearStaleFormat(apage)) (Four) BfM_SetDirty(&pid, PAGE_BUF);
+
+        sizeClass = 0;
+        for (i = 0; fsm->nTrees > 1 && i < apage->header.nSlots; i++) {
+            if (SP_OFFSET(apage, i) == EMPTYSLOT) continue;
+
+            /* a stub left by an update does not tell the size class */
+            (Four) eduom_GetObject(apage, SP_OFFSET(apage, i), &objHdr, NULL);
+            if (objHdr.properties & P_MOVED) continue;
+
+            sizeClass = SIZECLASS(ALIGNED_LENGTH(objHdr.length));
+            break;
+        }
+
+        /* the new pages get the format of the first page */
+        if (pid.pageNo == catEntry->firstPage) {
+            fsm->format = SP_FORMAT(apage);
+            if (SP_IS_FIXED(apage)) fsm->cellSize = SP_CELLSIZE(apage);
+        }
+
+        e = eduom_FsmSetClass(fsm, pid.pageNo, sizeClass);
+        if (e >= 0) e = eduom_FsmSetPage(fsm, pid.pageNo, SP_FREE(apage));
+        nextPage = apage->header.nextPage;
+
+        (Four) BfM_FreeTrain(&pid, PAGE_BUF);
+        if (e < 0) {
+            fsm->valid = FALSE;
+            ERR(e);
+        }
+
+        pid.pageNo = nextPage;
+    }
+
+    return(eNOERROR);
+
+} /* eduom_FsmBuild() */
@@ -0,0 +1,448 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_Latency.c
+ *
+ * Description:
+ *  Latency histograms of the EduOM functions and of BfM_GetTrain() called
+ *  by them, which are recorded only if EDUOM_LATENCY is defined at the
+ *  compile time.
+ *  A histogram is log-linear: the latencies below 2^LAT_SUBBITS clock ticks
+ *  have a bucket each, and every power of 2 above is split into
+ *  2^LAT_SUBBITS buckets, so a bucket is within 1/2^LAT_SUBBITS of the
+ *  latencies it counts. The latencies are measured with the time stamp
+ *  counter of the processor, and are converted to nanoseconds when the
+ *  histograms are dumped. A call of BfM_GetTrain() is a miss if the page is
+ *  not in the buffer before the call.
+ *  The histograms are dumped to stderr by LRDS_Dismount() if the program is
+ *  linked with '-Wl,--wrap=LRDS_Dismount', as the Makefile does.
+ *
+ * Exports:
+ *  Four EduOM_DumpLatency(FILE*)
+ *  Four EduOM_ResetLatency(void)
+ *
+ * Internal Functions:
+ *  void eduom_LatencyEnd(LatencyTimer*)
+ *  unsigned long eduom_LatencyClock(void)
+ *  Four eduom_GetTrainTimed(TrainID*, char**, Four)
+ */
+
+
+#include <string.h>
+#include <time.h>
+#include "EduOM_common.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+#ifdef EDUOM_LATENCY
+
+/*@
+ * Constant Definitions
+ */
+#define LAT_SUBBITS     4                       /* log2 of # of buckets per power of 2 */
+#define LAT_NSUBS       (1 << LAT_SUBBITS)
+#define LAT_NBUCKETS    (64 * LAT_NSUBS)
+
+
+/*
+ * Typedef for a latency histogram
+ */
+typedef struct {
+    unsigned long count;		/* # of latencies recorded */
+    unsigned long sum;			/* sum of the latencies */
+    unsigned long max;			/* max of the latencies */
+    unsigned long buckets[LAT_NBUCKETS]; /* # of latencies of each bucket */
+} LatencyHistogram;
+
+
+/*@
+ * Macro Function Definitions
+ */
+/* bucket of the latency 'v' */
+#define LAT_BUCKET(v) \
+	(((v) < LAT_NSUBS) ? (Four)(v) : \
+	 (Four)(((63 - __builtin_clzl(v)) - LAT_SUBBITS + 1) * LAT_NSUBS + \
+	        (((v) >> ((63 - __builtin_clzl(v)) - LAT_SUBBITS)) & (LAT_NSUBS - 1))))
+
+/* smallest latency counted in the bucket 'b' */
+#define LAT_BUCKET_LOW(b) \
+	(((b) < LAT_NSUBS) ? (unsigned long)(b) : \
+	 ((unsigned long)(LAT_NSUBS + (b) % LAT_NSUBS) << ((b) / LAT_NSUBS - 1)))
+
+/* largest latency counted in the bucket 'b' */
+#define LAT_BUCKET_HIGH(b)  (LAT_BUCKET_LOW((b) + 1) - 1)
+
+
+/*@
+ * Global variables
+ */
+static LatencyHistogram eduom_latHists[LAT_NOPS];
+
+static char *eduom_latNames[LAT_NOPS] = {
+    "EduOM_CreateObject", "EduOM_CreateObjects", "EduOM_DestroyObject",
+    "EduOM_DestroyObjects", "EduOM_ReadObject", "EduOM_ReadObjects",
+    "EduOM_PinObject", "EduOM_NextObject", "EduOM_PrevObject",
+    "EduOM_CompactPage", "EduOM_OpenScan", "EduOM_FetchBatch",
+    "EduOM_ParallelScan", "EduOM_UpdateObject", "EduOM_WriteObject",
+    "BfM_GetTrain(hit)", "BfM_GetTrain(miss)" };
+
+/* clock and time at the start of the program to convert the clock into time */
+static unsigned long eduom_latClockBase;
+static double eduom_latTimeBase;
+
+
+/*@
+ * Function Prototypes
+ */
+Four bfm_LookUp(TrainID*, Four);
+Four __real_LRDS_Dismount(Four);
+
+static void eduom_LatencyRecord(Four, unsigned long);
+static double eduom_LatencyTime(void);
+static void eduom_LatencyInit(void) __attribute__((constructor));
+
+
+
+/*@================================
+ * EduOM_DumpLatency()
+ *================================*/
+/*
+ * Function: Four EduOM_DumpLatency(FILE*)
+ *
+ * Description:
+ *  Print the latency histograms in nanoseconds; a line of the count, the
+ *  mean, the percentiles, and the max for each histogram, followed by the
+ *  nonempty buckets.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ */
+Four EduOM_DumpLatency(
+    FILE        *fp)		/* IN file to print to */
+{
+    Four        op;		/* index of the histogram */
+    Four        b;		/* index of the bucket */
+    Four        p;		/* index of the percentile */
+    double      nsPerTick;	/* nanoseconds per clock tick */
+    unsigned long count;	/* # of latencies recorded */
+    unsigned long cum;		/* # of latencies up to the bucket */
+    unsigned long pValue[4];	/* the percentiles */
+    LatencyHistogram *h;	/* the histogram */
+    static double percentiles[4] = { 0.50, 0.90, 0.99, 0.999 };
+
+
+    /*@ parameter checking */
+    if (fp == NULL) ERR(eBADPARAMETER_OM);
+
+    nsPerTick = (eduom_LatencyTime() - eduom_latTimeBase) / (double)(LAT_NOW() - eduom_latClockBase);
+
+    for (op = 0; op < LAT_NOPS; op++) {
+        h = &eduom_latHists[op];
+        count = __atomic_load_n(&h->count, __ATOMIC_RELAXED);
+        if (count == 0) continue;
+
+        for (b = 0, p = 0, cum = 0; b < LAT_NBUCKETS && p < 4; b++) {
+            cum += h->buckets[b];
+            while (p < 4 && cum >= percentiles[p] * count)
+                pValue[p++] = MIN(LAT_BUCKET_HIGH(b), h->max);
+        }
+        for (; p < 4; p++) pValue[p] = h->max;
+
+        fprintf(fp, "latency %-22s count %lu mean %.0f p50 %.0f p90 %.0f p99 %.0f p99.9 %.0f max %.0f (ns)\n",
+                eduom_latNames[op], count, h->sum * nsPerTick / count,
+                pValue[0] * nsPerTick, pValue[1] * nsPerTick, pValue[2] * nsPerTick,
+                pValue[3] * nsPerTick, h->max * nsPerTick);
+
+        for (b = 0; b < LAT_NBUCKETS; b++)
+            if (h->buckets[b] > 0)
+                fprintf(fp, "    [%.0f, %.0f] %lu\n", LAT_BUCKET_LOW(b) * nsPerTick,
+                        (LAT_BUCKET_HIGH(b) + 1) * nsPerTick, h->buckets[b]);
+    }
+
+    return(eNOERROR);
+
+} /* EduOM_DumpLatency() */
+
+
+
+/*@================================
+ * EduOM_ResetLatency()
+ *================================*/
+/*
+ * Function: Four EduOM_ResetLatency(void)
+ *
+ * Description:
+ *  Clear the latency histograms. The latencies recorded by the other
+ *  threads meanwhile may be lost.
+ *
+ * Returns:
+ *  error code
+ */
+Four EduOM_ResetLatency(void)
+{
+    memset(eduom_latHists, 0, sizeof(eduom_latHists));
+
+    return(eNOERROR);
+
+} /* EduOM_ResetLatency() */
+
+
+
+/*@================================
+ * eduom_LatencyEnd()
+ *================================*/
+/*
+ * Function: void eduom_LatencyEnd(LatencyTimer*)
+ *
+ * Description:
+ *  Record the latency of the function whose timer goes out of scope. It is
+ *  called by the compiler for the timer declared by LAT_BEGIN().
+ *
+ * Returns:
+ *  None
+ */
+void eduom_LatencyEnd(
+    LatencyTimer *timer)	/* IN timer of the function */
+{
+    eduom_LatencyRecord(timer->op, LAT_NOW() - timer->start);
+
+} /* eduom_LatencyEnd() */
+
+
+
+/*@================================
+ * eduom_GetTrainTimed()
+ *================================*/
+/*
+ * Function: Four eduom_GetTrainTimed(TrainID*, char**, Four)
+ *
+ * Description:
+ *  Call BfM_GetTrain() and record its latency as a hit or a miss.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_GetTrainTimed(
+    TrainID     *trainId,	/* IN train to fix */
+    char        **retBuf,	/* OUT buffer holding the train */
+    Four        type)		/* IN buffer type */
+{
+    Four        e;		/* error */
+    Boolean     miss;		/* TRUE if the train is not in the buffer */
+    unsigned long start;	/* clock at the start */
+
+
+    miss = (bfm_LookUp(trainId, type) < 0) ? TRUE : FALSE;
+
+    start = LAT_NOW();
+    e = BfM_GetTrain(trainId, retBuf, type);
+    eduom_LatencyRecord(miss ? LAT_GETTRAIN_MISS : LAT_GETTRAIN_HIT, LAT_NOW() - start);
+
+    return(e);
+
+} /* eduom_GetTrainTimed() */
+
+
+
+/*@================================
+ * eduom_LatencyClock()
+ *================================*/
+/*
+ * Function: unsigned long eduom_LatencyClock(void)
+ *
+ * Description:
+ *  Return the clock in nanoseconds, used if the processor has no time
+ *  stamp counter.
+ *
+ * Returns:
+ *  the clock
+ */
+unsigned long eduom_LatencyClock(void)
+{
+    struct timespec ts;		/* current time */
+
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return((unsigned long)ts.tv_sec * 1000000000UL + ts.tv_nsec);
+
+} /* eduom_LatencyClock() */
+
+
+
+/*@================================
+ * __wrap_LRDS_Dismount()
+ *================================*/
+/*
+ * Function: Four __wrap_LRDS_Dismount(Four)
+ *
+ * Description:
+ *  Dump the latency histograms to stderr and dismount the volume. The
+ *  calls of LRDS_Dismount() come here if the program is linked with
+ *  '-Wl,--wrap=LRDS_Dismount'.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four __wrap_LRDS_Dismount(
+    Four        volId)		/* IN volume to dismount */
+{
+    (Four) EduOM_DumpLatency(stderr);
+
+    return(__real_LRDS_Dismount(volId));
+
+} /* __wrap_LRDS_Dismount() */
+
+
+
+/*@================================
+ * eduom_LatencyRecord()
+ *================================*/
+/*
+ * Function: void eduom_LatencyRecord(Four, unsigned long)
+ *
+ * Description:
+ *  Add a latency to the histogram of the operation. The histograms may be
+ *  updated by several threads, so the counters are updated atomically.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_LatencyRecord(
+    Four        op,		/* IN operation */
+    unsigned long ticks)	/* IN latency in clock ticks */
+{
+    LatencyHistogram *h = &eduom_latHists[op];
+    unsigned long max;		/* max of the latencies */
+
+
+    (void) __atomic_fetch_add(&h->buckets[LAT_BUCKET(ticks)], 1, __ATOMIC_RELAXED);
+    (void) __atomic_fetch_add(&h->sum, ticks, __ATOMIC_RELAXED);
+    (void) __atomic_fetch_add(&h->count, 1, __ATOMIC_RELAXED);
+
+    max = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+    while (ticks > max &&
+           !__atomic_compare_exchange_n(&h->max, &max, ticks, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+} /* eduom_LatencyRecord() */
+
+
+
+/*@================================
+ * eduom_LatencyTime()
+ *================================*/
+/*
+ * Function: double eduom_LatencyTime(void)
+ *
+ * Description:
+ *  Return the current time in nanoseconds.
+ *
+ * Returns:
+ *  the time
+ */
+static double eduom_LatencyTime(void)
+{
+    struct timespec ts;		/* current time */
+
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return(ts.tv_sec * 1e9 + ts.tv_nsec);
+
+} /* eduom_LatencyTime() */
+
+
+
+/*@================================
+ * eduom_LatencyInit()
+ *================================*/
+/*
+ * Function: void eduom_LatencyInit(void)
+ *
+ * Description:
+ *  Take the clock and the time at the start of the program; the clock is
+ *  converted into time by the rate measured from here to the dump.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_LatencyInit(void)
+{
+    eduom_latClockBase = LAT_NOW();
+    eduom_latTimeBase = eduom_LatencyTime();
+
+} /* eduom_LatencyInit() */
+
+
+#else /* EDUOM_LATENCY */
+
+
+/*@================================
+ * EduOM_DumpLatency()
+ *================================*/
+/*
+ * Function: Four EduOM_DumpLatency(FILE*)
+ *
+ * Description:
+ *  The latency is not recorded unless EDUOM_LATENCY is defined.
+ *
+ * Returns:
+ *  error code
+ *    eNOTSUPPORTED_EDUOM
+ */
+Four EduOM_DumpLatency(
+    FILE        *fp)		/* IN file to print to */
+{
+    ERR(eNOTSUPPORTED_EDUOM);
+
+} /* EduOM_DumpLatency() */
+
+
+
+/*@================================
+ * EduOM_ResetLatency()
+ *================================*/
+/*
+ * Function: Four EduOM_ResetLatency(void)
+ *
+ * Description:
+ *  The latency is not recorded unless EDUOM_LATENCY is defined.
+ *
+ * Returns:
+ *  error code
+ *    eNOTSUPPORTED_EDUOM
+ */
+Four EduOM_ResetLatency(void)
+{
+    ERR(eNOTSUPPORTED_EDUOM);
+
+} /* EduOM_ResetLatency() */
+
+
+#endif /* EDUOM_LATENCY */
@@ -0,0 +1,366 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_MappedVolume.c
+ *
+ * Description:
+ *  Read-only access to the volumes whose device files are mapped into
+ *  memory. While a volume is mapped, the functions reading objects,
+ *  EduOM_ReadObject(), EduOM_ReadObjects(), EduOM_PinObject(), the scans,
+ *  EduOM_NextObject(), and EduOM_PrevObject(), find a page of the volume at
+ *  its address in the mapping; the page is neither copied into a buffer nor
+ *  fixed, so the readers may run in several threads without any latch.
+ *  The mapping shows the device file only, so the volume must not be
+ *  updated while it is mapped; if the volume is also mounted, the buffer
+ *  should be flushed before the volume is mapped. The functions updating
+ *  objects or files, EduOM_CreateObject(s), EduOM_DestroyObject(s),
+ *  EduOM_UpdateObject(), EduOM_WriteObject(), EduOM_SetPageFormat(), and
+ *  EduOM_SetFixedLength(), return eVOLUMEMAPPED_EDUOM for a mapped volume,
+ *  and EduOM_RunDeferredCompaction() skips its pages.
+ *
+ * Exports:
+ *  Four EduOM_MapVolume(Four, char**, Four, Four*)
+ *  Four EduOM_UnmapVolume(Four)
+ *
+ * Internal Functions:
+ *  Boolean eduom_IsMappedVolume(VolNo)
+ *  Four eduom_GetPageForRead(PageID*, SlottedPage**)
+ *  Four eduom_FreePageForRead(PageID*)
+ *  Four eduom_AdviseMappedPages(PageID*, Four)
+ */
+
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "EduOM_common.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+/*
+ * Typedef for a mapped volume
+ */
+typedef struct {
+    VolNo       volNo;		/* volume number */
+    char        *base;		/* address of the mapped device file; NULL if the entry is empty */
+    Four        nPages;		/* # of pages of the device file */
+} MappedVolume;
+
+
+/*@
+ * Global variables
+ */
+static MappedVolume eduom_mappedVolumes[MAPPED_MAXVOLUMES];
+static Four eduom_nMappedVolumes = 0;	/* # of volumes mapped */
+
+
+/*@
+ * Internal function prototypes
+ */
+static MappedVolume *eduom_LookUpMappedVolume(VolNo);
+
+
+
+/*@================================
+ * EduOM_MapVolume()
+ *================================*/
+/*
+ * Function: Four EduOM_MapVolume(Four, char**, Four, Four*)
+ *
+ * Description:
+ *  Map the device file of a volume into memory read-only. The volume
+ *  number is read from the first page of the device. 'advice' tells the
+ *  kernel how the pages are to be read: MAPPED_SEQUENTIAL for the scans, and
+ *  MAPPED_RANDOM for the reads of the objects by their IDs. Only a volume of
+ *  one device can be mapped. This function must not be called concurrently
+ *  with the other EduOM functions.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    eNOTSUPPORTED_EDUOM
+ *    eMAPFAILED_EDUOM
+ *
+ * Side effect:
+ *  1) parameter volId
+ *     volId is set to the volume number of the mapped volume
+ */
+Four EduOM_MapVolume(
+    Four        numDevices,	/* IN # of devices of the volume */
+    char        **devNames,	/* IN names of the devices */
+    Four        advice,		/* IN MAPPED_SEQUENTIAL or MAPPED_RANDOM */
+    Four        *volId)		/* OUT volume number */
+{
+    Four        fd;		/* file descriptor of the device */
+    Four        i;		/* index variable */
+    struct stat st;		/* status of the device */
+    MappedVolume *mv;		/* entry of the volume */
+    char        *base;		/* address of the mapped device */
+    Four        nPages;		/* # of pages of the device */
+
+
+    /*@ parameter checking */
+    if (devNames == NULL || volId == NULL) ERR(eBADPARAMETER_OM);
+
+    if (advice != MAPPED_SEQUENTIAL && advice != MAPPED_RANDOM) ERR(eBADPARAMETER_OM);
+
+    /* the layout of the pages over several devices is kept by RDsM */
+    if (numDevices != 1) ERR(eNOTSUPPORTED_EDUOM);
+
+    for (i = 0; i < MAPPED_MAXVOLUMES && eduom_mappedVolumes[i].base != NULL; i++);
+    if (i == MAPPED_MAXVOLUMES) ERR(eMAPFAILED_EDUOM);
+    mv = &eduom_mappedVolumes[i];
+
+    /*@ map the device */
+    fd = open(devNames[0], O_RDONLY);
+    if (fd < 0) ERR(eMAPFAILED_EDUOM);
+
+    if (fstat(fd, &st) < 0 || st.st_size < PAGESIZE) {
+        (void) close(fd);
+        ERR(eMAPFAILED_EDUOM);
+    }
+    nPages = st.st_size / PAGESIZE;
+
+    base = mmap(NULL, (size_t)nPages * PAGESIZE, PROT_READ, MAP_SHARED, fd, 0);
+    (void) close(fd);
+    if (base == MAP_FAILED) ERR(eMAPFAILED_EDUOM);
+
+    (void) madvise(base, (size_t)nPages * PAGESIZE, (advice == MAPPED_SEQUENTIAL) ? MADV_SEQUENTIAL : MADV_RANDOM);
+
+    /*@ every page, the first one as well, keeps the volume number in its page ID */
+    *volId = ((Page *)base)->header.pid.volNo;
+
+    if (eduom_LookUpMappedVolume(*volId) != NULL) {
+        (void) munmap(base, (size_t)nPages * PAGESIZE);
+        ERR(eBADPARAMETER_OM);
+    }
+
+    mv->base = base;
+    mv->nPages = nPages;
+    mv->volNo = *volId;
+    eduom_nMappedVolumes++;
+
+    return(eNOERROR);
+
+} /* EduOM_MapVolume() */
+
+
+
+/*@================================
+ * EduOM_UnmapVolume()
+ *================================*/
+/*
+ * Function: Four EduOM_UnmapVolume(Four)
+ *
+ * Description:
+ *  Unmap the volume mapped by EduOM_MapVolume(). The objects pinned and the
+ *  scans opened on the volume must have been released. This function must
+ *  not be called concurrently with the other EduOM functions.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ */
+Four EduOM_UnmapVolume(
+    Four        volId)		/* IN volume to unmap */
+{
+    MappedVolume *mv;		/* entry of the volume */
+
+
+    mv = eduom_LookUpMappedVolume(volId);
+    if (mv == NULL) ERR(eBADPARAMETER_OM);
+
+    (void) munmap(mv->base, (size_t)mv->nPages * PAGESIZE);
+
+    mv->base = NULL;
+    eduom_nMappedVolumes--;
+
+    return(eNOERROR);
+
+} /* EduOM_UnmapVolume() */
+
+
+
+/*@================================
+ * eduom_IsMappedVolume()
+ *================================*/
+/*
+ * Function: Boolean eduom_IsMappedVolume(VolNo)
+ *
+ * Description:
+ *  Check whether the volume is mapped.
+ *
+ * Returns:
+ *  TRUE if the volume is mapped, otherwise FALSE
+ */
+Boolean eduom_IsMappedVolume(
+    VolNo       volNo)		/* IN volume number */
+{
+    return((eduom_LookUpMappedVolume(volNo) != NULL) ? TRUE : FALSE);
+
+} /* eduom_IsMappedVolume() */
+
+
+
+/*@================================
+ * eduom_GetPageForRead()
+ *================================*/
+/*
+ * Function: Four eduom_GetPageForRead(PageID*, SlottedPage**)
+ *
+ * Description:
+ *  Get the given page for reading. A page of a mapped volume is found in
+ *  the mapping; otherwise the page is fixed in the buffer manager, which is
+ *  counted as a pin. The page must be released by eduom_FreePageForRead().
+ *
+ * Returns:
+ *  error code
+ *    eBADPAGEID_OM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter apage
+ *     apage points to the page
+ */
+Four eduom_GetPageForRead(
+    PageID      *pid,		/* IN page to get */
+    SlottedPage **apage)	/* OUT the page */
+{
+    Four        e;		/* error */
+    MappedVolume *mv;		/* entry of the volume */
+
+
+    mv = eduom_LookUpMappedVolume(pid->volNo);
+    if (mv != NULL) {
+        if (pid->pageNo < 0 || pid->pageNo >= mv->nPages) ERR(eBADPAGEID_OM);
+
+        *apage = (SlottedPage *)(mv->base + (size_t)pid->pageNo * PAGESIZE);
+        return(eNOERROR);
+    }
+
+    e = EDUOM_GETTRAIN(pid, (char**)apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+    STAT_PIN();
+
+    return(eNOERROR);
+
+} /* eduom_GetPageForRead() */
+
+
+
+/*@================================
+ * eduom_FreePageForRead()
+ *================================*/
+/*
+ * Function: Four eduom_FreePageForRead(PageID*)
+ *
+ * Description:
+ *  Release the page got by eduom_GetPageForRead().
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_FreePageForRead(
+    PageID      *pid)		/* IN page to release */
+{
+    Four        e;		/* error */
+
+
+    if (eduom_LookUpMappedVolume(pid->volNo) != NULL) return(eNOERROR);
+
+    e = BfM_FreeTrain(pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_FreePageForRead() */
+
+
+
+/*@================================
+ * eduom_AdviseMappedPages()
+ *================================*/
+/*
+ * Function: Four eduom_AdviseMappedPages(PageID*, Four)
+ *
+ * Description:
+ *  Advise the kernel to read the 'nPages' pages of a mapped volume from
+ *  'firstPid' upward into the mapping in the background. The pages beyond
+ *  the end of the device are not advised.
+ *
+ * Returns:
+ *  # of pages advised; 0 if the volume is not mapped
+ */
+Four eduom_AdviseMappedPages(
+    PageID      *firstPid,	/* IN first page to read ahead */
+    Four        nPages)		/* IN # of pages to read ahead */
+{
+    MappedVolume *mv;		/* entry of the volume */
+
+
+    mv = eduom_LookUpMappedVolume(firstPid->volNo);
+    if (mv == NULL || firstPid->pageNo < 0) return(0);
+
+    nPages = MIN(nPages, mv->nPages - firstPid->pageNo);
+    if (nPages <= 0) return(0);
+
+    (void) madvise(mv->base + (size_t)firstPid->pageNo * PAGESIZE, (size_t)nPages * PAGESIZE, MADV_WILLNEED);
+
+    return(nPages);
+
+} /* eduom_AdviseMappedPages() */
+
+
+
+/*@================================
+ * eduom_LookUpMappedVolume()
+ *================================*/
+/*
+ * Function: MappedVolume *eduom_LookUpMappedVolume(VolNo)
+ *
+ * Description:
+ *  Find the entry of the mapped volume.
+ *
+ * Returns:
+ *  the entry of the volume, or NULL if the volume is not mapped
+ */
+static MappedVolume *eduom_LookUpMappedVolume(
+    VolNo       volNo)		/* IN volume number */
+{
+    Four        i;		/* index variable */
+
+
+    if (eduom_nMappedVolumes == 0) return(NULL);
+
+    for (i = 0; i < MAPPED_MAXVOLUMES; i++)
+        if (eduom_mappedVolumes[i].base != NULL && eduom_mappedVolumes[i].volNo == volNo)
+            return(&eduom_mappedVolumes[i]);
+
+    return(NULL);
+
+} /* eduom_LookUpMappedVolume() */
@@ -52,6 +52,8 @@
  *  same page which has the current Object and  if there  is no next Object in
  *  the same page, find it from the next page. If the Current Object is NULL,
  *  return the first Object of the file.
+ *  An object moved by an update is returned with the ObjectID of its stub
+ *  and its own header; the slot of the moved data is skipped.
  *
  * Returns:
  *  error code
@@ -78,11 +80,13 @@ Four EduOM_NextObject(
     PageNo pageNo;		/* a temporary var for next page's PageNo */
     SlottedPage *apage;		/* a pointer to the data page */
     Object *obj;		/* a pointer to the Object */
+    ObjectHdr hdr;		/* header of an object of the page */
     PhysicalFileID pFid;	/* file in which the objects are located */
     SlottedPage *catPage;	/* buffer page containing the catalog object */
     sm_CatOverlayForData *catEntry; /* data structure for catalog object access */
 
 
+    LAT_BEGIN(LAT_NEXTOBJECT);
 
     /*@
      * parameter checking
@@ -91,9 +95,11 @@ Four EduOM_NextObject(
     
     if (nextOID == NULL) ERR(eBADOBJECTID_OM);
 
-    e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF);
+    STAT_BEGIN(STAT_OP_NEXT);
+
+    e = eduom_GetPageForRead((PageID*)catObjForFile, &catPage);
     if (e < 0) ERR(e);
-    catEntry = (sm_CatOverlayForData*)(catPage->data + catPage->slot[-catObjForFile->slotNo].offset);
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
 
     // Case 1: curOID is NULL → find first object in file
     if (!curOID) {
@@ -105,30 +111,45 @@ Four EduOM_NextObject(
     }
 
     while(1){
-        if (e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF) < 0) ERR(e);
+        e = eduom_GetPageForRead(&pid, &apage);
+        if (e < 0) {
+            (Four) eduom_FreePageForRead((PageID*)catObjForFile);
+            ERR(e);
+        }
         Two startSlot = (curOID)? (curOID->slotNo + 1) : 0; //go to next page also
         for(i = startSlot; i < apage->header.nSlots; i++){
-            if (apage->slot[-i].offset == EMPTYSLOT) continue;
+            if (SP_OFFSET(apage, i) == EMPTYSLOT) continue;
+
+            /* the data moved by an update is returned at its stub */
+            (Four) eduom_GetObject(apage, SP_OFFSET(apage, i), &hdr, NULL);
+            if (hdr.properties & P_FORWARDED) continue;
+            if ((hdr.properties & P_MOVED) && objHdr) {
+                e = eduom_GetForwardedHeader(apage, SP_OFFSET(apage, i), &hdr);
+                if (e < 0) {
+                    (Four) eduom_FreePageForRead(&pid);
+                    (Four) eduom_FreePageForRead((PageID*)catObjForFile);
+                    ERR(e);
+                }
+            }
+
             nextOID->pageNo = pid.pageNo;
             nextOID->volNo = pid.volNo;
             nextOID->slotNo = i;
-            nextOID->unique = apage->slot[i].unique;
-            if (objHdr) {
-                ObjectHdr *hdr = (ObjectHdr*)(apage->data + apage->slot[-i].offset);
-                memcpy(objHdr, hdr, sizeof(ObjectHdr));
-            }
-            BfM_FreeTrain(&pid, PAGE_BUF);
-            BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+            nextOID->unique = SP_UNIQUE(apage, i);
+            if (objHdr) *objHdr = hdr;
+            eduom_FreePageForRead(&pid);
+            eduom_FreePageForRead((PageID*)catObjForFile);
             return eNOERROR;
         }
+        PageNo nextPage = apage->header.nextPage;
+        eduom_FreePageForRead(&pid);
         if (pid.pageNo == catEntry->lastPage) {
-            BfM_FreeTrain((TrainID *) catObjForFile, PAGE_BUF);
+            eduom_FreePageForRead((PageID*)catObjForFile);
             return (EOS);
         }
-        PageNo nextPage = apage->header.nextPage;
-        BfM_FreeTrain(&pid, PAGE_BUF);
         pid.pageNo = nextPage;
         curOID = NULL;
+        STAT_ADD(scanPageMoves, 1);
     }
     /* end of scan */
     
@@ -0,0 +1,589 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_PageFormat.c
+ *
+ * Description:
+ *  Handle the objects of the pages of the four page formats. The pages of the
+ *  format v1 have 8-byte slots, and their objects have an ObjectHdr and are
+ *  aligned by ALIGN. The pages of the format v2 have 6-byte slots, and their
+ *  objects have variable-length headers and are not aligned; an object of
+ *  less than 64 bytes with neither properties nor tag has a 1-byte header.
+ *  The pages of the format with a prefix are pages of the format v2 whose
+ *  objects keep only the part of their data not equal to the prefix at the
+ *  beginning of the data area; such an object is not contiguous in the page
+ *  and is read by eduom_ReadData(). The pages of the format for fixed-length
+ *  objects are arrays of cells without slots or object headers; the common
+ *  cell lengths are copied by memcpy() of constant lengths, which the
+ *  compiler turns into a few moves.
+ *  The format of a page is kept in its 'flags', so the formats coexist on
+ *  a volume and in a file. A file gets the pages of the format of its first
+ *  page, which is set by EduOM_SetPageFormat() while the file is empty;
+ *  the first page reserves unique numbers then, so that the bits of the
+ *  format left in a page reused by the storage library are recognized.
+ *  The pages of the formats other than v1 are read and updated only by EduOM.
+ *  The module uses no other module so that EduOM_Verify can use it.
+ *
+ * Internal Functions:
+ *  Four eduom_ObjectSize(Four, ObjectHdr*)
+ *  Four eduom_PageObjectSize(SlottedPage*, ObjectHdr*, char*)
+ *  Four eduom_GetObject(SlottedPage*, Four, ObjectHdr*, char**)
+ *  Four eduom_PutObject(SlottedPage*, Four, ObjectHdr*, char*)
+ *  void eduom_ReadData(SlottedPage*, Four, Four, Four, char*)
+ *  void eduom_InitDataArea(SlottedPage*)
+ *  void eduom_StartPrefix(SlottedPage*, char*, Four)
+ *  Boolean eduom_ClearStaleFormat(SlottedPage*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+
+
+/*@
+ * Macro Definitions
+ */
+/* Macro: FIXED_COPY(dst, src, n)
+ * Description: copy a cell of 'n' bytes; the common lengths are constants
+ */
+#define FIXED_COPY(dst, src, n) \
+    switch (n) { \
+      case 4:   memcpy(dst, src, 4); break; \
+      case 8:   memcpy(dst, src, 8); break; \
+      case 16:  memcpy(dst, src, 16); break; \
+      case 32:  memcpy(dst, src, 32); break; \
+      case 64:  memcpy(dst, src, 64); break; \
+      case 128: memcpy(dst, src, 128); break; \
+      default:  memcpy(dst, src, n); break; \
+    }
+
+
+/*@
+ * Internal function prototypes
+ */
+static Four eduom_VarintSize(UFour);
+static Four eduom_PutVarint(UOne*, UFour);
+static Four eduom_GetVarint(UOne*, UFour*);
+static Four eduom_SharedLength(SlottedPage*, char*, Four);
+
+
+
+/*@================================
+ * eduom_ObjectSize()
+ *================================*/
+/*
+ * Function: Four eduom_ObjectSize(Four, ObjectHdr*)
+ *
+ * Description:
+ *  Return the bytes of the data area taken by an object with the given
+ *  header in a page of the given format, not counting its slot. In the
+ *  format with a prefix, the object is assumed to share no byte with the
+ *  prefix, so the size is an upper bound.
+ *
+ * Returns:
+ *  size of the object in the data area
+ */
+Four eduom_ObjectSize(
+    Four      format,		/* IN one of PAGE_FORMAT_* */
+    ObjectHdr *objHdr)		/* IN header of the object */
+{
+    Four size;			/* size of the header */
+
+
+    if (format == PAGE_FORMAT_V1) return(sizeof(ObjectHdr) + ALIGNED_LENGTH(objHdr->length));
+
+    if (format == PAGE_FORMAT_FIXED) return(objHdr->length);
+
+    if (objHdr->properties == 0 && objHdr->tag == 0)
+        size = eduom_VarintSize((UFour)objHdr->length << 1);
+    else
+        size = eduom_VarintSize(((UFour)objHdr->length << 1) | 1) +
+               eduom_VarintSize((UTwo)objHdr->properties) + eduom_VarintSize((UTwo)objHdr->tag);
+
+    /* the # of bytes shared with the prefix */
+    if (format == PAGE_FORMAT_PREFIX) size++;
+
+    return(size + objHdr->length);
+
+} /* eduom_ObjectSize() */
+
+
+
+/*@================================
+ * eduom_PageObjectSize()
+ *================================*/
+/*
+ * Function: Four eduom_PageObjectSize(SlottedPage*, ObjectHdr*, char*)
+ *
+ * Description:
+ *  Return the bytes of the data area taken by the object with the given
+ *  header and data if it is put into the page now, not counting its slot.
+ *
+ * Returns:
+ *  size of the object in the data area
+ */
+Four eduom_PageObjectSize(
+    SlottedPage *apage,		/* IN page of the object */
+    ObjectHdr *objHdr,		/* IN header of the object */
+    char      *data)		/* IN data of the object */
+{
+    Four size;			/* size of the object sharing no byte */
+
+
+    size = eduom_ObjectSize(SP_FORMAT(apage), objHdr);
+
+    if (SP_HAS_PREFIX(apage)) size -= eduom_SharedLength(apage, data, objHdr->length);
+
+    return(size);
+
+} /* eduom_PageObjectSize() */
+
+
+
+/*@================================
+ * eduom_GetObject()
+ *================================*/
+/*
+ * Function: Four eduom_GetObject(SlottedPage*, Four, ObjectHdr*, char**)
+ *
+ * Description:
+ *  Decode the object at the given offset of the data area of the page.
+ *  'objHdr' and 'data' may be NULL. The data of an object of a page with a
+ *  prefix is not contiguous, so 'data' is set to NULL for such a page; use
+ *  eduom_ReadData() instead.
+ *
+ * Returns:
+ *  size of the object in the data area
+ *
+ * Side effect:
+ *  1) parameter objHdr
+ *     objHdr is set to the header of the object
+ *  2) parameter data
+ *     data is set to the data of the object in the page
+ */
+Four eduom_GetObject(
+    SlottedPage *apage,		/* IN page of the object */
+    Four      offset,		/* IN offset of the object in the data area */
+    ObjectHdr *objHdr,		/* OUT header of the object */
+    char      **data)		/* OUT data of the object */
+{
+    Object *obj;		/* object of a page of the format v1 */
+    UOne *p;			/* object of a page of the format v2 */
+    Four n;			/* size of the header */
+    UFour v;			/* a decoded varint */
+    UFour properties;		/* properties of the object */
+    UFour tag;			/* tag of the object */
+    Four shared;		/* # of bytes of the data in the prefix */
+
+
+    if (SP_IS_FIXED(apage)) {
+        if (objHdr != NULL) {
+            objHdr->properties = 0;
+            objHdr->tag = 0;
+            objHdr->length = SP_CELLSIZE(apage);
+        }
+        if (data != NULL) *data = &(apage->data[offset]);
+
+        return(SP_CELLSIZE(apage));
+    }
+
+    if (!SP_IS_V2(apage)) {
+        obj = (Object*)&(apage->data[offset]);
+        if (objHdr != NULL) *objHdr = obj->header;
+        if (data != NULL) *data = obj->data;
+
+        return(sizeof(ObjectHdr) + ALIGNED_LENGTH(obj->header.length));
+    }
+
+    p = (UOne*)&(apage->data[offset]);
+    n = eduom_GetVarint(p, &v);
+
+    properties = tag = 0;
+    if (v & 1) {
+        n += eduom_GetVarint(p + n, &properties);
+        n += eduom_GetVarint(p + n, &tag);
+    }
+
+    if (objHdr != NULL) {
+        objHdr->properties = (Two)properties;
+        objHdr->tag = (Two)tag;
+        objHdr->length = v >> 1;
+    }
+
+    if (SP_HAS_PREFIX(apage)) {
+        shared = p[n];
+        if (data != NULL) *data = NULL;
+
+        return(n + 1 + (v >> 1) - shared);
+    }
+
+    if (data != NULL) *data = (char*)(p + n);
+
+    return(n + (v >> 1));
+
+} /* eduom_GetObject() */
+
+
+
+/*@================================
+ * eduom_PutObject()
+ *================================*/
+/*
+ * Function: Four eduom_PutObject(SlottedPage*, Four, ObjectHdr*, char*)
+ *
+ * Description:
+ *  Write the object with the given header and data at the given offset of
+ *  the data area of the page. The caller makes room for
+ *  eduom_ObjectSize() bytes.
+ *
+ * Returns:
+ *  size of the object in the data area
+ */
+Four eduom_PutObject(
+    SlottedPage *apage,		/* INOUT page of the object */
+    Four      offset,		/* IN offset of the object in the data area */
+    ObjectHdr *objHdr,		/* IN header of the object */
+    char      *data)		/* IN data of the object */
+{
+    Object *obj;		/* object of a page of the format v1 */
+    UOne *p;			/* object of a page of the format v2 */
+    Four n;			/* size of the header */
+    Four shared;		/* # of bytes of the data in the prefix */
+
+
+    if (SP_IS_FIXED(apage)) {
+        FIXED_COPY(&(apage->data[offset]), data, SP_CELLSIZE(apage));
+
+        return(SP_CELLSIZE(apage));
+    }
+
+    if (!SP_IS_V2(apage)) {
+        obj = (Object*)&(apage->data[offset]);
+        obj->header = *objHdr;
+        if (objHdr->length > 0) memcpy(obj->data, data, objHdr->length);
+
+        return(sizeof(ObjectHdr) + ALIGNED_LENGTH(objHdr->length));
+    }
+
+    p = (UOne*)&(apage->data[offset]);
+
+    if (objHdr->properties == 0 && objHdr->tag == 0)
+        n = eduom_PutVarint(p, (UFour)objHdr->length << 1);
+    else {
+        n = eduom_PutVarint(p, ((UFour)objHdr->length << 1) | 1);
+        n += eduom_PutVarint(p + n, (UTwo)objHdr->properties);
+        n += eduom_PutVarint(p + n, (UTwo)objHdr->tag);
+    }
+
+    shared = 0;
+    if (SP_HAS_PREFIX(apage)) {
+        shared = eduom_SharedLength(apage, data, objHdr->length);
+        p[n++] = (UOne)shared;
+    }
+
+    if (objHdr->length > shared) memcpy(p + n, data + shared, objHdr->length - shared);
+
+    return(n + objHdr->length - shared);
+
+} /* eduom_PutObject() */
+
+
+
+/*@================================
+ * eduom_ReadData()
+ *================================*/
+/*
+ * Function: void eduom_ReadData(SlottedPage*, Four, Four, Four, char*)
+ *
+ * Description:
+ *  Copy 'length' bytes of the data of the object at the given offset of the
+ *  data area, from the byte 'start' of the data, into 'buf'. The bytes of
+ *  the object of a page with a prefix are taken from the prefix and from
+ *  the object. The caller keeps the bytes within the object.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_ReadData(
+    SlottedPage *apage,		/* IN page of the object */
+    Four      offset,		/* IN offset of the object in the data area */
+    Four      start,		/* IN starting offset of the read in the data */
+    Four      length,		/* IN amount of data to read */
+    char      *buf)		/* OUT buffer to return the data */
+{
+    char *data;			/* data of the object in the page */
+    char *suffix;		/* data of the object after the bytes shared */
+    UOne *p;			/* object of a page with a prefix */
+    UFour v;			/* a decoded varint */
+    Four shared;		/* # of bytes of the data in the prefix */
+    Four n;			/* # of bytes */
+
+
+    if (SP_IS_FIXED(apage) && start == 0 && length == SP_CELLSIZE(apage)) {
+        FIXED_COPY(buf, &(apage->data[offset]), length);
+        return;
+    }
+
+    if (!SP_HAS_PREFIX(apage)) {
+        (Four) eduom_GetObject(apage, offset, NULL, &data);
+        memcpy(buf, data + start, length);
+        return;
+    }
+
+    /* skip the header; the suffix follows the # of bytes shared */
+    p = (UOne*)&(apage->data[offset]);
+    n = eduom_GetVarint(p, &v);
+    if (v & 1) {
+        n += eduom_GetVarint(p + n, &v);
+        n += eduom_GetVarint(p + n, &v);
+    }
+    shared = p[n];
+    suffix = (char*)(p + n + 1);
+
+    n = 0;
+    if (start < shared) {
+        n = MIN(length, shared - start);
+        memcpy(buf, SP_PREFIX(apage) + start, n);
+    }
+    if (length > n) memcpy(buf + n, suffix + (start + n - shared), length - n);
+
+} /* eduom_ReadData() */
+
+
+
+/*@================================
+ * eduom_InitDataArea()
+ *================================*/
+/*
+ * Function: void eduom_InitDataArea(SlottedPage*)
+ *
+ * Description:
+ *  Empty the data area of the page. A page with a prefix gets an empty
+ *  prefix, which the next object put into the page replaces. A page of
+ *  fixed-length objects keeps its unique number and cell length, which the
+ *  caller sets for a new page, and gets all its cells empty.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_InitDataArea(
+    SlottedPage *apage)		/* INOUT page to be emptied */
+{
+    if (SP_HAS_PREFIX(apage)) apage->data[0] = 0;
+
+    if (SP_IS_FIXED(apage)) memset(SP_BITMAP(apage), 0, (SP_NCELLS(apage) + 7) / 8);
+
+    apage->header.free = SP_DATASTART(apage);
+    apage->header.unused = 0;
+
+} /* eduom_InitDataArea() */
+
+
+
+/*@================================
+ * eduom_StartPrefix()
+ *================================*/
+/*
+ * Function: void eduom_StartPrefix(SlottedPage*, char*, Four)
+ *
+ * Description:
+ *  If the page has a prefix and no object in its data area, take the first
+ *  bytes of the object about to be put into it as the prefix. The object
+ *  then takes as many bytes less as the prefix takes, so the free space of
+ *  the page does not change.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_StartPrefix(
+    SlottedPage *apage,		/* INOUT page the object is put into */
+    char      *data,		/* IN data of the object */
+    Four      length)		/* IN length of the object */
+{
+    Four n;			/* length of the prefix */
+
+
+    if (!SP_HAS_PREFIX(apage) || apage->header.free != SP_DATASTART(apage)) return;
+
+    n = MIN(length, SP_MAXPREFIX);
+
+    apage->data[0] = (char)n;
+    if (n > 0) memcpy(SP_PREFIX(apage), data, n);
+    apage->header.free = 1 + n;
+
+} /* eduom_StartPrefix() */
+
+
+
+/*@================================
+ * eduom_ClearStaleFormat()
+ *================================*/
+/*
+ * Function: Boolean eduom_ClearStaleFormat(SlottedPage*)
+ *
+ * Description:
+ *  The storage library initializes a page by setting only the page type in
+ *  its 'flags', so a page reused after its file was destroyed may keep the
+ *  bits of a format other than v1 while its contents are of the format v1.
+ *  A page of a format other than v1 always has unique numbers reserved in
+ *  its header, which the library clears; the bits of the format of a page
+ *  without them are cleared.
+ *
+ * Returns:
+ *  TRUE if the bits are cleared
+ */
+Boolean eduom_ClearStaleFormat(
+    SlottedPage *apage)		/* INOUT page initialized by EduOM or the library */
+{
+    if (SP_FORMAT(apage) == PAGE_FORMAT_V1 || apage->header.uniqueLimit != 0) return(FALSE);
+
+    apage->header.flags &= ~(SP_FORMAT_V2 | SP_FORMAT_PREFIX | SP_FORMAT_FIXED);
+
+    return(TRUE);
+
+} /* eduom_ClearStaleFormat() */
+
+
+
+/*@================================
+ * eduom_VarintSize()
+ *================================*/
+/*
+ * Function: Four eduom_VarintSize(UFour)
+ *
+ * Description:
+ *  Return the bytes of the base 128 encoding of the given value.
+ *
+ * Returns:
+ *  # of bytes
+ */
+static Four eduom_VarintSize(
+    UFour     v)		/* IN value to be encoded */
+{
+    Four n;			/* # of bytes */
+
+
+    for (n = 1; v >= 0x80; n++) v >>= 7;
+
+    return(n);
+
+} /* eduom_VarintSize() */
+
+
+
+/*@================================
+ * eduom_PutVarint()
+ *================================*/
+/*
+ * Function: Four eduom_PutVarint(UOne*, UFour)
+ *
+ * Description:
+ *  Encode the value in base 128, the lowest 7 bits first; the highest bit
+ *  of a byte is set if more bytes follow.
+ *
+ * Returns:
+ *  # of bytes written
+ */
+static Four eduom_PutVarint(
+    UOne      *p,		/* OUT encoded value */
+    UFour     v)		/* IN value to be encoded */
+{
+    Four n;			/* # of bytes */
+
+
+    for (n = 0; v >= 0x80; n++) {
+        p[n] = (UOne)(v & 0x7f) | 0x80;
+        v >>= 7;
+    }
+    p[n++] = (UOne)v;
+
+    return(n);
+
+} /* eduom_PutVarint() */
+
+
+
+/*@================================
+ * eduom_GetVarint()
+ *================================*/
+/*
+ * Function: Four eduom_GetVarint(UOne*, UFour*)
+ *
+ * Description:
+ *  Decode a value encoded by eduom_PutVarint(). At most 5 bytes are read,
+ *  so that a broken page is not read beyond the value.
+ *
+ * Returns:
+ *  # of bytes read
+ */
+static Four eduom_GetVarint(
+    UOne      *p,		/* IN encoded value */
+    UFour     *v)		/* OUT decoded value */
+{
+    Four n;			/* # of bytes */
+
+
+    *v = p[0] & 0x7f;
+    for (n = 1; n < 5 && (p[n-1] & 0x80); n++)
+        *v |= (UFour)(p[n] & 0x7f) << (7*n);
+
+    return(n);
+
+} /* eduom_GetVarint() */
+
+
+
+/*@================================
+ * eduom_SharedLength()
+ *================================*/
+/*
+ * Function: Four eduom_SharedLength(SlottedPage*, char*, Four)
+ *
+ * Description:
+ *  Return the # of the first bytes of the data equal to the prefix of the
+ *  page.
+ *
+ * Returns:
+ *  # of bytes
+ */
+static Four eduom_SharedLength(
+    SlottedPage *apage,		/* IN page with a prefix */
+    char      *data,		/* IN data of an object */
+    Four      length)		/* IN length of the object */
+{
+    Four n;			/* # of bytes */
+    Four max;			/* max # of bytes */
+    char *prefix;		/* prefix of the page */
+
+
+    max = MIN(length, SP_PREFIXLEN(apage));
+    prefix = SP_PREFIX(apage);
+
+    for (n = 0; n < max && data[n] == prefix[n]; n++);
+
+    return(n);
+
+} /* eduom_SharedLength() */
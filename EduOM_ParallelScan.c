@@ -0,0 +1,451 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_ParallelScan.c
+ *
+ * Description:
+ *  Scan the objects of a data file with several worker threads. The pages
+ *  of the file are fixed in rounds by the calling thread, since the buffer
+ *  manager is not thread-safe; the fixed pages of a round are partitioned
+ *  into contiguous ranges, and the worker threads scan their ranges
+ *  concurrently, reading the pages in the buffer directly. The worker
+ *  threads are created once per scan and wait on a condition variable for
+ *  the next round, so a round costs no thread creation. The objects
+ *  moved by updates are kept by the workers and delivered by the calling
+ *  thread after the round, since their data may be in any page.
+ *
+ * Exports:
+ *  Four EduOM_ParallelScan(ObjectID*, Four, Four, EduOM_ScanCallback, void**)
+ */
+
+
+#include <pthread.h>
+#include "EduOM_common.h"
+#include "Util.h"		/* to get VarArray */
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+/*
+ * Typedef for the rounds of a parallel scan shared by its threads
+ */
+typedef struct {
+    pthread_mutex_t latch;	/* latch protecting the fields below */
+    pthread_cond_t  start;	/* signaled when a round starts or the scan ends */
+    pthread_cond_t  finish;	/* signaled when the last worker finishes a round */
+    Four        round;		/* # of rounds started */
+    Four        nRunning;	/* # of workers still scanning the round */
+    Boolean     stop;		/* TRUE if the scan ends */
+} ParallelScanRound;
+
+
+/*
+ * Typedef for the work of a worker thread in a round
+ */
+typedef struct {
+    ParallelScanRound *round;	/* rounds of the scan */
+    Four        threadNo;	/* number of the worker thread */
+    PageID      *pids;		/* pages of the range */
+    SlottedPage **apages;	/* buffers of the pages of the range */
+    Four        nPages;		/* # of pages of the range */
+    EduOM_ScanCallback callback; /* function called for each object */
+    void        *arg;		/* argument given to 'callback' */
+    VarArray    moved;		/* stubs of the moved objects met in the range */
+    Four        nMoved;		/* # of entries used in 'moved' */
+    Four        e;		/* error of the worker */
+} ParallelScanWork;
+
+
+/*@
+ * Internal function prototypes
+ */
+static void *eduom_ParallelScanWorker(void*);
+static void eduom_ParallelScanRange(ParallelScanWork*);
+static Four eduom_ParallelScanMoved(ParallelScanWork*);
+
+
+
+/*@================================
+ * EduOM_ParallelScan()
+ *================================*/
+/*
+ * Function: Four EduOM_ParallelScan(ObjectID*, Four, Four, EduOM_ScanCallback, void**)
+ *
+ * Description:
+ *  Scan all the objects of the given data file with 'nThreads' worker
+ *  threads. The pages are taken along 'nextPage' in rounds of at most
+ *  'pagesPerRound' pages; the pages of a round are fixed, split into
+ *  'nThreads' contiguous ranges, scanned concurrently, and then freed.
+ *  The calling thread scans the first range, and the other nThreads-1
+ *  worker threads are created at the start of the scan and joined at its
+ *  end.
+ *  For each object, the worker thread i calls
+ *      callback(i, oid, objHdr, data, args[i])
+ *  where 'data' points to the data of the object in the buffer and is valid
+ *  only during the call. The objects of a page are delivered in the slot
+ *  order by one thread, but there is no order among the threads. A callback
+ *  returning a negative value stops the scan, and the value is returned.
+ *  If the buffer cannot hold 'pagesPerRound' pages, the round is cut at the
+ *  pages already fixed. An object moved by an update is delivered with the
+ *  ObjectID of its stub after the workers of the round finish, by the
+ *  calling thread with the number of the worker which met the stub.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    eTHREADFAILED_EDUOM
+ *    some errors caused by function calls or callbacks
+ */
+Four EduOM_ParallelScan(
+    ObjectID  *catObjForFile,	/* IN catalog object of the data file */
+    Four      nThreads,		/* IN # of worker threads */
+    Four      pagesPerRound,	/* IN max # of pages fixed at once */
+    EduOM_ScanCallback callback, /* IN function called for each object */
+    void      **args)		/* IN args[i] is given to the callback of thread i */
+{
+    Four e;			/* error */
+    Four i;			/* index variable */
+    Four nPages;		/* # of pages fixed in the current round */
+    Four nCreated;		/* # of workers created, including the caller */
+    Four base;			/* first page of the range of a worker */
+    PageID pid;			/* page to be fixed next */
+    sm_CatOverlayForData *catEntry; /* data structure for catalog object access */
+    VarArray pidArray;		/* pages fixed in the current round */
+    VarArray apageArray;	/* buffers of the pages fixed in the round */
+    PageID *pids;		/* entries of 'pidArray' */
+    SlottedPage **apages;	/* entries of 'apageArray' */
+    ParallelScanWork work[PSCAN_MAXTHREADS]; /* work of each worker thread */
+    pthread_t threads[PSCAN_MAXTHREADS]; /* the worker threads */
+    ParallelScanRound round;	/* rounds shared with the worker threads */
+
+
+    LAT_BEGIN(LAT_PARALLELSCAN);
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (nThreads < 1 || nThreads > PSCAN_MAXTHREADS || pagesPerRound < 1 || callback == NULL)
+        ERR(eBADPARAMETER_OM);
+
+    STAT_BEGIN(STAT_OP_SCAN);
+
+    /*@ get the first page of the file */
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+
+    MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+
+    e = Util_initVarArray(&pidArray, sizeof(PageID), pagesPerRound);
+    if (e < 0) ERR(e);
+
+    e = Util_initVarArray(&apageArray, sizeof(SlottedPage*), pagesPerRound);
+    if (e < 0) {
+        (Four) Util_finalVarArray(&pidArray);
+        ERR(e);
+    }
+
+    for (i = 0; i < nThreads; i++) {
+        e = Util_initVarArray(&work[i].moved, sizeof(ObjectID), PSCAN_MINMOVED);
+        if (e < 0) {
+            while (--i >= 0) (Four) Util_finalVarArray(&work[i].moved);
+            (Four) Util_finalVarArray(&pidArray);
+            (Four) Util_finalVarArray(&apageArray);
+            ERR(e);
+        }
+    }
+
+    pids = (PageID*)pidArray.ptr;
+    apages = (SlottedPage**)apageArray.ptr;
+
+    (void) pthread_mutex_init(&round.latch, NULL);
+    (void) pthread_cond_init(&round.start, NULL);
+    (void) pthread_cond_init(&round.finish, NULL);
+    round.round = 0;
+    round.nRunning = 0;
+    round.stop = FALSE;
+
+    /*@ create the worker threads; the calling thread is the worker 0 */
+    e = eNOERROR;
+    for (i = 0; i < nThreads; i++) {
+        work[i].round = &round;
+        work[i].threadNo = i;
+    }
+
+    for (nCreated = 1; nCreated < nThreads; nCreated++) {
+        if (pthread_create(&threads[nCreated], NULL, eduom_ParallelScanWorker, &work[nCreated]) != 0) {
+            e = eTHREADFAILED_EDUOM;
+            break;
+        }
+    }
+
+    while (e >= 0 && pid.pageNo != NIL) {
+
+        /*@ fix the pages of the round */
+        for (nPages = 0; nPages < pagesPerRound && pid.pageNo != NIL; nPages++) {
+            e = eduom_GetPageForRead(&pid, &apages[nPages]);
+            if (e < 0) break;
+            if (pid.pageNo != catEntry->firstPage) STAT_ADD(scanPageMoves, 1);
+
+            pids[nPages] = pid;
+            pid.pageNo = apages[nPages]->header.nextPage;
+        }
+
+        /* the buffer is full; scan the pages fixed so far */
+        if (e < 0 && nPages > 0) e = eNOERROR;
+
+        if (e < 0) break;
+
+        /*@ split the pages of the round into the ranges of the workers */
+        for (i = 0, base = 0; i < nThreads; i++) {
+            work[i].pids = &pids[base];
+            work[i].apages = &apages[base];
+            work[i].nPages = nPages/nThreads + ((i < nPages%nThreads) ? 1 : 0);
+            work[i].callback = callback;
+            work[i].arg = (args == NULL) ? NULL : args[i];
+            work[i].nMoved = 0;
+            work[i].e = eNOERROR;
+            base += work[i].nPages;
+        }
+
+        /*@ scan the ranges concurrently; the calling thread scans the first one */
+        (void) pthread_mutex_lock(&round.latch);
+        round.round++;
+        round.nRunning = nThreads - 1;
+        (void) pthread_cond_broadcast(&round.start);
+        (void) pthread_mutex_unlock(&round.latch);
+
+        eduom_ParallelScanRange(&work[0]);
+
+        (void) pthread_mutex_lock(&round.latch);
+        while (round.nRunning > 0)
+            (void) pthread_cond_wait(&round.finish, &round.latch);
+        (void) pthread_mutex_unlock(&round.latch);
+
+        for (i = 0; e >= 0 && i < nThreads; i++)
+            if (work[i].e < 0) e = work[i].e;
+
+        /*@ deliver the moved objects of the round */
+        for (i = 0; e >= 0 && i < nThreads; i++)
+            e = eduom_ParallelScanMoved(&work[i]);
+
+        /*@ free the pages of the round */
+        for (i = 0; i < nPages; i++)
+            (Four) eduom_FreePageForRead(&pids[i]);
+    }
+
+    /*@ end the worker threads */
+    (void) pthread_mutex_lock(&round.latch);
+    round.stop = TRUE;
+    (void) pthread_cond_broadcast(&round.start);
+    (void) pthread_mutex_unlock(&round.latch);
+
+    for (i = 1; i < nCreated; i++)
+        (void) pthread_join(threads[i], NULL);
+
+    (void) pthread_cond_destroy(&round.finish);
+    (void) pthread_cond_destroy(&round.start);
+    (void) pthread_mutex_destroy(&round.latch);
+
+    (Four) Util_finalVarArray(&pidArray);
+    (Four) Util_finalVarArray(&apageArray);
+    for (i = 0; i < nThreads; i++)
+        (Four) Util_finalVarArray(&work[i].moved);
+
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_ParallelScan() */
+
+
+
+/*@================================
+ * eduom_ParallelScanWorker()
+ *================================*/
+/*
+ * Function: void *eduom_ParallelScanWorker(void*)
+ *
+ * Description:
+ *  Main function of a worker thread of EduOM_ParallelScan(). The worker
+ *  waits for the next round, scans its range of the round, and tells the
+ *  calling thread when it is done, until the scan ends.
+ *
+ * Returns:
+ *  NULL; the error is returned in the work
+ */
+static void *eduom_ParallelScanWorker(
+    void *arg)			/* INOUT work of the worker thread */
+{
+    ParallelScanWork *work = (ParallelScanWork*)arg;
+    ParallelScanRound *round = work->round;
+    Four done;			/* # of rounds done by the worker */
+
+
+    /* the pins of the worker are counted for the scan of the calling thread */
+    STAT_CONTINUE(STAT_OP_SCAN);
+
+    done = 0;
+    for ( ; ; ) {
+        (void) pthread_mutex_lock(&round->latch);
+        while (round->round == done && !round->stop)
+            (void) pthread_cond_wait(&round->start, &round->latch);
+        if (round->round == done) {
+            (void) pthread_mutex_unlock(&round->latch);
+            return(NULL);
+        }
+        done = round->round;
+        (void) pthread_mutex_unlock(&round->latch);
+
+        eduom_ParallelScanRange(work);
+
+        (void) pthread_mutex_lock(&round->latch);
+        if (--round->nRunning == 0) (void) pthread_cond_signal(&round->finish);
+        (void) pthread_mutex_unlock(&round->latch);
+    }
+
+} /* eduom_ParallelScanWorker() */
+
+
+
+/*@================================
+ * eduom_ParallelScanRange()
+ *================================*/
+/*
+ * Function: void eduom_ParallelScanRange(ParallelScanWork*)
+ *
+ * Description:
+ *  Scan the pages of the given range and call the callback for each object.
+ *  The pages are fixed by the calling thread of EduOM_ParallelScan(), so the
+ *  worker does not call the buffer manager; the stubs of the moved objects
+ *  are kept in the work instead, and the moved data is skipped.
+ *
+ * Returns:
+ *  None; the error is returned in the work
+ */
+static void eduom_ParallelScanRange(
+    ParallelScanWork *work)	/* INOUT work of a worker in the round */
+{
+    Four e;			/* error */
+    Four p;			/* index of the page */
+    Two  i;			/* slot index */
+    SlottedPage *apage;		/* a page of the range */
+    ObjectHdr objHdr;		/* header of an object of the page */
+    char *data;			/* data of an object of the page */
+    ObjectID oid;		/* ID of the object */
+    char copy[PAGESIZE];	/* data decoded from a page with a prefix */
+
+
+    for (p = 0; p < work->nPages; p++) {
+        apage = work->apages[p];
+
+        for (i = 0; i < apage->header.nSlots; i++) {
+            if (SP_OFFSET(apage, i) == EMPTYSLOT) continue;
+
+            (Four) eduom_GetObject(apage, SP_OFFSET(apage, i), &objHdr, &data);
+            if (objHdr.properties & P_FORWARDED) continue;
+
+            MAKE_OBJECTID(oid, work->pids[p].volNo, work->pids[p].pageNo, i, SP_UNIQUE(apage, i));
+
+            if (objHdr.properties & P_MOVED) {
+                if (work->nMoved == work->moved.nEntries) {
+                    e = Util_reallocVarArray(&work->moved, sizeof(ObjectID), 2*work->moved.nEntries);
+                    if (e < 0) {
+                        work->e = e;
+                        return;
+                    }
+                }
+                ((ObjectID*)work->moved.ptr)[work->nMoved++] = oid;
+                continue;
+            }
+
+            if (SP_HAS_PREFIX(apage)) {
+                eduom_ReadData(apage, SP_OFFSET(apage, i), 0, objHdr.length, copy);
+                data = copy;
+            }
+
+            e = work->callback(work->threadNo, &oid, &objHdr, data, work->arg);
+            if (e < 0) {
+                work->e = e;
+                return;
+            }
+        }
+    }
+
+} /* eduom_ParallelScanRange() */
+
+
+
+/*@================================
+ * eduom_ParallelScanMoved()
+ *================================*/
+/*
+ * Function: Four eduom_ParallelScanMoved(ParallelScanWork*)
+ *
+ * Description:
+ *  Call the callback of the worker for each moved object kept by the worker
+ *  in the round. It is called by the calling thread of EduOM_ParallelScan()
+ *  after the workers finish, so the pages of the moved data are fixed here.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls or callbacks
+ */
+static Four eduom_ParallelScanMoved(
+    ParallelScanWork *work)	/* IN work of a worker thread in the round */
+{
+    Four e;			/* error */
+    Four j;			/* index variable */
+    ObjectID *oid;		/* stub of a moved object */
+    PageID pid;			/* page of the moved data */
+    SlottedPage *apage;		/* buffer holding the page */
+    BufferFrontEntry *entry;	/* entry of the front end for the page */
+    Four offset;		/* offset of the data in the page */
+    ObjectHdr objHdr;		/* header of the object */
+    char *data;			/* data of the object */
+    char copy[PAGESIZE];	/* data decoded from a page with a prefix */
+
+
+    for (j = 0; j < work->nMoved; j++) {
+        oid = &((ObjectID*)work->moved.ptr)[j];
+
+        e = eduom_FixObjectForRead(oid, &pid, &apage, &entry, &offset, &objHdr);
+        if (e < 0) ERR(e);
+
+        (Four) eduom_GetObject(apage, offset, NULL, &data);
+        if (SP_HAS_PREFIX(apage)) {
+            eduom_ReadData(apage, offset, 0, objHdr.length, copy);
+            data = copy;
+        }
+
+        e = work->callback(work->threadNo, oid, &objHdr, data, work->arg);
+
+        (Four) eduom_UnfixPageForRead(&pid, entry);
+        if (e < 0) return(e);
+    }
+
+    return(eNOERROR);
+
+} /* eduom_ParallelScanMoved() */
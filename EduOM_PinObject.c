@@ -0,0 +1,156 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_PinObject.c
+ *
+ * Description:
+ *  Give a direct access to the data of an object in the buffer. The page
+ *  holding the object is pinned instead of copying the data into a user
+ *  buffer, so a caller which inspects only a part of an object does not pay
+ *  for copying the whole object. The data of an object of a page with a
+ *  prefix is not contiguous in the page, so it is decoded into a copy held
+ *  by the handle.
+ *
+ * Exports:
+ *  Four EduOM_PinObject(ObjectID*, const char**, Four*, EduOM_PinHandle*)
+ *  Four EduOM_UnpinObject(EduOM_PinHandle*)
+ */
+
+
+#include <stdlib.h>
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+
+
+
+/*@================================
+ * EduOM_PinObject()
+ *================================*/
+/*
+ * Function: Four EduOM_PinObject(ObjectID*, const char**, Four*, EduOM_PinHandle*)
+ *
+ * Description:
+ *  Pin the page holding the object 'oid' and return a pointer to the data
+ *  of the object in the buffer; for an object moved by an update, the page
+ *  of the moved data is pinned. The data must not be modified, and it is
+ *  valid only until EduOM_UnpinObject() is called with 'handle'.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter data
+ *     data points to the data of the object in the buffer
+ *  2) parameter length
+ *     length is set to the length of the object
+ *  3) parameter handle
+ *     handle holds the page pinned
+ */
+Four EduOM_PinObject(
+    ObjectID    *oid,		/* IN object to pin */
+    const char  **data,		/* OUT pointer to the data of the object */
+    Four        *length,	/* OUT length of the object */
+    EduOM_PinHandle *handle)	/* OUT handle to unpin the object */
+{
+    Four        e;		/* error code */
+    SlottedPage	*apage;		/* pointer to the buffer of the page */
+    Four	offset;		/* offset of the data of the object in the page */
+    ObjectHdr	objHdr;		/* header of the object */
+
+
+    LAT_BEGIN(LAT_PINOBJECT);
+
+    /*@ check parameters */
+
+    if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+    if (data == NULL || length == NULL || handle == NULL) ERR(eBADPARAMETER_OM);
+
+    handle->copy = NULL;
+
+    STAT_BEGIN(STAT_OP_READ);
+
+    e = eduom_FixObjectForRead(oid, &handle->pid, &apage, &handle->entry, &offset, &objHdr);
+    if (e < 0) ERR(e);
+
+    (Four) eduom_GetObject(apage, offset, NULL, (char**)data);
+
+    if (SP_HAS_PREFIX(apage)) {
+        handle->copy = (char*)malloc(MAX(objHdr.length, 1));
+        if (handle->copy == NULL) {
+            (Four) eduom_UnfixPageForRead(&handle->pid, handle->entry);
+            ERR(eMEMORYALLOCERR_EDUOM);
+        }
+
+        eduom_ReadData(apage, offset, 0, objHdr.length, handle->copy);
+        *data = handle->copy;
+    }
+
+    handle->apage = apage;
+    *length = objHdr.length;
+
+    return(eNOERROR);
+
+} /* EduOM_PinObject() */
+
+
+
+/*@================================
+ * EduOM_UnpinObject()
+ *================================*/
+/*
+ * Function: Four EduOM_UnpinObject(EduOM_PinHandle*)
+ *
+ * Description:
+ *  Unpin the page pinned by EduOM_PinObject(). The pointer returned with
+ *  the handle must not be used any more.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_UnpinObject(
+    EduOM_PinHandle *handle)	/* INOUT handle of the pinned object */
+{
+    Four        e;		/* error code */
+
+
+    if (handle == NULL || handle->apage == NULL) ERR(eBADPARAMETER_OM);
+
+    free(handle->copy);
+    handle->copy = NULL;
+
+    e = eduom_UnfixPageForRead(&handle->pid, handle->entry);
+    if (e < 0) ERR(e);
+
+    handle->apage = NULL;
+
+    return(eNOERROR);
+
+} /* EduOM_UnpinObject() */
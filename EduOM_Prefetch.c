@@ -0,0 +1,263 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_Prefetch.c
+ *
+ * Description:
+ *  Read-ahead of the pages of a volume. The buffer manager reads a page from
+ *  the device file only when the page is fixed, one page at a time, so a
+ *  scan moving onto a page not in the buffer waits for a single read of the
+ *  page. For a volume whose device file is opened by EduOM_EnablePrefetch(),
+ *  eduom_PrefetchPages() asks the kernel to read the given pages into its
+ *  page cache in the background by posix_fadvise(POSIX_FADV_WILLNEED); the
+ *  later read of a page by the buffer manager then finds the page in memory.
+ *  The pages of a mapped volume are advised in the mapping by
+ *  madvise(MADV_WILLNEED) instead. The advice never waits for the reads and
+ *  its failures are ignored, since it is only a hint.
+ *
+ * Exports:
+ *  Four EduOM_EnablePrefetch(Four, char**, Four*)
+ *  Four EduOM_DisablePrefetch(Four)
+ *
+ * Internal Functions:
+ *  Four eduom_PrefetchPages(PageID*, Four)
+ */
+
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+
+
+/*
+ * Typedef for a volume read ahead
+ */
+typedef struct {
+    VolNo       volNo;		/* volume number */
+    Four        fd;		/* file descriptor of the device */
+    Four        nPages;		/* # of pages of the device file; 0 if the entry is empty */
+} PrefetchVolume;
+
+
+/*@
+ * Global variables
+ */
+static PrefetchVolume eduom_prefetchVolumes[PREFETCH_MAXVOLUMES];
+static Four eduom_nPrefetchVolumes = 0;	/* # of volumes read ahead */
+
+
+/*@
+ * Internal function prototypes
+ */
+static PrefetchVolume *eduom_LookUpPrefetchVolume(VolNo);
+
+
+
+/*@================================
+ * EduOM_EnablePrefetch()
+ *================================*/
+/*
+ * Function: Four EduOM_EnablePrefetch(Four, char**, Four*)
+ *
+ * Description:
+ *  Open the device file of a volume read-only so that the scans may have
+ *  its pages read ahead; see EduOM_SetScanReadAhead(). The volume number
+ *  is read from the first page of the device. Only a volume of one device
+ *  is supported, whose page 'pageNo' is at the offset 'pageNo'*PAGESIZE of
+ *  the device file. This function must not be called concurrently with the
+ *  other EduOM functions.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    eNOTSUPPORTED_EDUOM
+ *    ePREFETCHFAILED_EDUOM
+ *
+ * Side effect:
+ *  1) parameter volId
+ *     volId is set to the volume number of the volume
+ */
+Four EduOM_EnablePrefetch(
+    Four        numDevices,	/* IN # of devices of the volume */
+    char        **devNames,	/* IN names of the devices */
+    Four        *volId)		/* OUT volume number */
+{
+    Four        fd;		/* file descriptor of the device */
+    Four        i;		/* index variable */
+    struct stat st;		/* status of the device */
+    Page        firstPage;	/* first page of the device */
+    PrefetchVolume *pv;		/* entry of the volume */
+
+
+    /*@ parameter checking */
+    if (devNames == NULL || volId == NULL) ERR(eBADPARAMETER_OM);
+
+    /* the layout of the pages over several devices is kept by RDsM */
+    if (numDevices != 1) ERR(eNOTSUPPORTED_EDUOM);
+
+    for (i = 0; i < PREFETCH_MAXVOLUMES && eduom_prefetchVolumes[i].nPages != 0; i++);
+    if (i == PREFETCH_MAXVOLUMES) ERR(ePREFETCHFAILED_EDUOM);
+    pv = &eduom_prefetchVolumes[i];
+
+    /*@ open the device */
+    fd = open(devNames[0], O_RDONLY);
+    if (fd < 0) ERR(ePREFETCHFAILED_EDUOM);
+
+    if (fstat(fd, &st) < 0 || st.st_size < PAGESIZE ||
+        pread(fd, &firstPage, PAGESIZE, 0) != PAGESIZE) {
+        (void) close(fd);
+        ERR(ePREFETCHFAILED_EDUOM);
+    }
+
+    /*@ every page, the first one as well, keeps the volume number in its page ID */
+    *volId = firstPage.header.pid.volNo;
+
+    if (eduom_LookUpPrefetchVolume(*volId) != NULL) {
+        (void) close(fd);
+        ERR(eBADPARAMETER_OM);
+    }
+
+    pv->fd = fd;
+    pv->nPages = st.st_size / PAGESIZE;
+    pv->volNo = *volId;
+    eduom_nPrefetchVolumes++;
+
+    return(eNOERROR);
+
+} /* EduOM_EnablePrefetch() */
+
+
+
+/*@================================
+ * EduOM_DisablePrefetch()
+ *================================*/
+/*
+ * Function: Four EduOM_DisablePrefetch(Four)
+ *
+ * Description:
+ *  Close the device file opened by EduOM_EnablePrefetch(); the scans no
+ *  longer read ahead the pages of the volume. This function must not be
+ *  called concurrently with the other EduOM functions.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ */
+Four EduOM_DisablePrefetch(
+    Four        volId)		/* IN volume read ahead */
+{
+    PrefetchVolume *pv;		/* entry of the volume */
+
+
+    pv = eduom_LookUpPrefetchVolume(volId);
+    if (pv == NULL) ERR(eBADPARAMETER_OM);
+
+    (void) close(pv->fd);
+
+    pv->nPages = 0;
+    eduom_nPrefetchVolumes--;
+
+    return(eNOERROR);
+
+} /* EduOM_DisablePrefetch() */
+
+
+
+/*@================================
+ * eduom_PrefetchPages()
+ *================================*/
+/*
+ * Function: Four eduom_PrefetchPages(PageID*, Four)
+ *
+ * Description:
+ *  Advise the kernel to read the 'nPages' pages from 'firstPid' upward in
+ *  the background. Nothing is done for a volume neither mapped nor opened
+ *  by EduOM_EnablePrefetch(). The pages beyond the end of the device are
+ *  not advised.
+ *
+ * Returns:
+ *  # of pages advised
+ */
+Four eduom_PrefetchPages(
+    PageID      *firstPid,	/* IN first page to read ahead */
+    Four        nPages)		/* IN # of pages to read ahead */
+{
+    PrefetchVolume *pv;		/* entry of the volume */
+
+
+    if (firstPid->pageNo < 0 || nPages <= 0) return(0);
+
+    /*@ a page of a mapped volume is advised in the mapping */
+    if (eduom_IsMappedVolume(firstPid->volNo)) {
+        nPages = eduom_AdviseMappedPages(firstPid, nPages);
+        STAT_ADD(prefetchPages, nPages);
+        return(nPages);
+    }
+
+    pv = eduom_LookUpPrefetchVolume(firstPid->volNo);
+    if (pv == NULL) return(0);
+
+    nPages = MIN(nPages, pv->nPages - firstPid->pageNo);
+    if (nPages <= 0) return(0);
+
+    (void) posix_fadvise(pv->fd, (off_t)firstPid->pageNo * PAGESIZE, (off_t)nPages * PAGESIZE,
+                         POSIX_FADV_WILLNEED);
+    STAT_ADD(prefetchPages, nPages);
+
+    return(nPages);
+
+} /* eduom_PrefetchPages() */
+
+
+
+/*@================================
+ * eduom_LookUpPrefetchVolume()
+ *================================*/
+/*
+ * Function: PrefetchVolume *eduom_LookUpPrefetchVolume(VolNo)
+ *
+ * Description:
+ *  Find the entry of the volume read ahead.
+ *
+ * Returns:
+ *  the entry of the volume, or NULL if the volume is not read ahead
+ */
+static PrefetchVolume *eduom_LookUpPrefetchVolume(
+    VolNo       volNo)		/* IN volume number */
+{
+    Four        i;		/* index variable */
+
+
+    if (eduom_nPrefetchVolumes == 0) return(NULL);
+
+    for (i = 0; i < PREFETCH_MAXVOLUMES; i++)
+        if (eduom_prefetchVolumes[i].nPages != 0 && eduom_prefetchVolumes[i].volNo == volNo)
+            return(&eduom_prefetchVolumes[i]);
+
+    return(NULL);
+
+} /* eduom_LookUpPrefetchVolume() */
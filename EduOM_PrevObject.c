@@ -52,6 +52,8 @@
  *  the same page which has the current object and  if there  is no previous
  *  object in the same page, find it from the previous page.
  *  If the current object is NULL, return the last object of the file.
+ *  An object moved by an update is returned with the ObjectID of its stub
+ *  and its own header; the slot of the moved data is skipped.
  *
  * Returns:
  *  error code
@@ -78,18 +80,23 @@ Four EduOM_PrevObject(
     PageNo pageNo;		/* a temporary var for previous page's PageNo */
     SlottedPage *apage;		/* a pointer to the data page */
     Object *obj;		/* a pointer to the Object */
+    ObjectHdr hdr;		/* header of an object of the page */
     SlottedPage *catPage;	/* buffer page containing the catalog object */
     sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
 
 
+    LAT_BEGIN(LAT_PREVOBJECT);
 
     /*@ parameter checking */
     if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
     
     if (prevOID == NULL) ERR(eBADOBJECTID_OM);
 
-    if (e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF) < 0) ERR(e);
-    catEntry = (sm_CatOverlayForData*)(catPage->data + catPage->slot[-catObjForFile->slotNo].offset);
+    STAT_BEGIN(STAT_OP_PREV);
+
+    e = eduom_GetPageForRead((PageID*)catObjForFile, &catPage);
+    if (e < 0) ERR(e);
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
     if (!curOID){
         pid.volNo = catEntry->fid.volNo;
         pid.pageNo = catEntry->lastPage;
@@ -100,31 +107,50 @@ Four EduOM_PrevObject(
     }
 
     while(1){
-        if (e = BfM_GetTrain(&pid, (char**)&apage, PAGE_BUF < 0)) ERRB1(e, &pid, PAGE_BUF);
+        e = eduom_GetPageForRead(&pid, &apage);
+        if (e < 0) {
+            (Four) eduom_FreePageForRead((PageID*)catObjForFile);
+            ERR(e);
+        }
         Two startSlot = (curOID) ? (curOID->slotNo - 1) : (apage->header.nSlots - 1);
         for (i = startSlot; i >= 0; i--){
-            if(apage->slot[-i].offset == EMPTYSLOT) continue;
+            if(SP_OFFSET(apage, i) == EMPTYSLOT) continue;
+
+            /* the data moved by an update is returned at its stub */
+            (Four) eduom_GetObject(apage, SP_OFFSET(apage, i), &hdr, NULL);
+            if (hdr.properties & P_FORWARDED) continue;
+            if ((hdr.properties & P_MOVED) && objHdr) {
+                e = eduom_GetForwardedHeader(apage, SP_OFFSET(apage, i), &hdr);
+                if (e < 0) {
+                    (Four) eduom_FreePageForRead(&pid);
+                    (Four) eduom_FreePageForRead((PageID*)catObjForFile);
+                    ERR(e);
+                }
+            }
 
             prevOID->pageNo = pid.pageNo;
             prevOID->volNo = pid.volNo;
             prevOID->slotNo = i;
-            prevOID->unique = apage->slot[-i].unique;
+            prevOID->unique = SP_UNIQUE(apage, i);
 
-            if (objHdr) {
-                ObjectHdr *hdr = (ObjectHdr*)(apage->data + apage->slot[-i].offset);
-                memcpy(objHdr, hdr, sizeof(ObjectHdr));
-            }
+            if (objHdr) *objHdr = hdr;
 
-            if (pid.pageNo == catEntry->firstPage) {
-                BfM_FreeTrain((TrainID *) catObjForFile, PAGE_BUF);
-                return (EOS);
-            }
+            eduom_FreePageForRead(&pid);
+            eduom_FreePageForRead((PageID*)catObjForFile);
+            return eNOERROR;
+        }
 
-            PageNo prevPage = apage->header.prevPage;
-            BfM_FreeTrain(&pid, PAGE_BUF);
-            pid.pageNo = prevPage;
-            curOID = NULL;
+        PageNo prevPage = apage->header.prevPage;
+        eduom_FreePageForRead(&pid);
+
+        if (pid.pageNo == catEntry->firstPage) {
+            eduom_FreePageForRead((PageID*)catObjForFile);
+            return (EOS);
         }
+
+        pid.pageNo = prevPage;
+        curOID = NULL;
+        STAT_ADD(scanPageMoves, 1);
     }
     
 } /* EduOM_PrevObject() */
@@ -30,7 +30,12 @@
  *  into the user specified buffer 'buf'.
  *
  * Exports:
- *  Four EduOM_ReadObject(ObjectID*, Four, Four, char*)
+ *  Four EduOM_ReadObject(ObjectID*, Four, Four, void*)
+ *
+ * Internal Functions:
+ *  Four eduom_FixObjectForRead(ObjectID*, PageID*, SlottedPage**, BufferFrontEntry**, Four*, ObjectHdr*)
+ *  Four eduom_FixForwardedObject(SlottedPage*, Four, PageID*, SlottedPage**, BufferFrontEntry**, Four*, ObjectHdr*)
+ *  Four eduom_GetForwardedHeader(SlottedPage*, Four, ObjectHdr*)
  */
 
 
@@ -39,6 +44,7 @@
 #include "BfM.h"		/* for the buffer manager call */
 #include "LOT.h"		/* for the large object manager call */
 #include "EduOM_Internal.h"
+#include "EduOM.h"
 
 
 
@@ -46,7 +52,7 @@
  * EduOM_ReadObject()
  *================================*/
 /*
- * Function: Four EduOM_ReadObject(ObjectID*, Four, Four, char*)
+ * Function: Four EduOM_ReadObject(ObjectID*, Four, Four, void*)
  * 
  * Description : 
  * (Following description is for original ODYSSEUS/COSMOS OM.
@@ -74,6 +80,10 @@
  *	       copy the data into the user buffer 'buf'
  *	   ENDIF
  *     ENDIF
+ *  (EduOM fixes the slotted page through the buffer front end and copies
+ *   the data with eduom_ReadData(), which also decodes the objects of the
+ *   pages with a prefix into 'buf'. A stub left by an update refers to the
+ *   moved data directly, so the forwarding is followed only once.)
  *  d. Free the buffer page
  *  e. Return
  *
@@ -90,17 +100,17 @@ Four EduOM_ReadObject(
     ObjectID 	*oid,		/* IN object to read */
     Four     	start,		/* IN starting offset of read */
     Four     	length,		/* IN amount of data to read */
-    char     	*buf)		/* OUT user buffer to return the read data */
+    void     	*buf)		/* OUT user buffer to return the read data */
 {
     Four     	e;              /* error code */
-    PageID 	pid;		/* page containing object specified by 'oid' */
-    SlottedPage	*apage;		/* pointer to the buffer of the page  */
-    Object	*obj;		/* pointer to the object in the slotted page */
-    Four	offset;		/* offset of the object in the page */
+    PageID	pid;		/* page holding the data of the object */
+    SlottedPage	*apage;		/* pointer to the buffer of the page */
+    BufferFrontEntry *entry;	/* entry of the buffer front end for the page */
+    Four	offset;		/* offset of the data of the object in the page */
+    ObjectHdr	objHdr;		/* header of the object */
 
-    if (!oid) ERR(eBADOBJECTID_OM);
-    if (length < 0 && length != REMAINDER) ERR(eBADLENGTH_OM);
-    if (!buf) ERR(eBADUSERBUF_OM);
+
+    LAT_BEGIN(LAT_READOBJECT);
 
     /*@ check parameters */
 
@@ -110,34 +120,211 @@ Four EduOM_ReadObject(
     
     if (buf == NULL) ERR(eBADUSERBUF_OM);
 
-    e = BfM_GetTrain((TrainID*)oid, (char**)&apage, PAGE_BUF);
+    STAT_BEGIN(STAT_OP_READ);
+
+    e = eduom_FixObjectForRead(oid, &pid, &apage, &entry, &offset, &objHdr);
+    if (e < 0) ERR(e);
+
+    if (start < 0 || start >= objHdr.length) {
+        (Four) eduom_UnfixPageForRead(&pid, entry);
+        ERR(eBADSTART_OM);
+    }
+
+    /* the read is cut at the end of the object */
+    if (length == REMAINDER || start + length > objHdr.length)
+        length = objHdr.length - start;
+
+    eduom_ReadData(apage, offset, start, length, buf);
+
+    e = eduom_UnfixPageForRead(&pid, entry);
     if (e < 0) ERR(e);
 
-    pid.pageNo = oid->pageNo;
-    pid.volNo = oid->volNo;
+    return(length);
+    
+} /* EduOM_ReadObject() */
+
+
+
+/*@================================
+ * eduom_FixObjectForRead()
+ *================================*/
+/*
+ * Function: Four eduom_FixObjectForRead(ObjectID*, PageID*, SlottedPage**, BufferFrontEntry**, Four*, ObjectHdr*)
+ *
+ * Description:
+ *  Fix the page holding the data of the object 'oid' by
+ *  eduom_FixPageForRead(). If the object is a stub left by an update, the
+ *  page of the moved data is fixed instead. The ObjectID of moved data is
+ *  not an ObjectID given to the users, so it is refused.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameters pid, apage, and entry
+ *     the page of the data is fixed; it is unfixed by eduom_UnfixPageForRead()
+ *  2) parameter offset
+ *     offset is set to the offset of the data of the object in the page
+ *  3) parameter objHdr
+ *     objHdr is set to the header of the object
+ */
+Four eduom_FixObjectForRead(
+    ObjectID    *oid,		/* IN object to read */
+    PageID      *pid,		/* OUT page holding the data of the object */
+    SlottedPage **apage,	/* OUT buffer holding the page */
+    BufferFrontEntry **entry,	/* OUT entry of the front end for the page */
+    Four        *offset,	/* OUT offset of the data in the page */
+    ObjectHdr   *objHdr)	/* OUT header of the object */
+{
+    Four        e;		/* error code */
+    PageID      homePid;	/* page of the slot of the object */
+    SlottedPage *homePage;	/* buffer holding the page of the slot */
+    BufferFrontEntry *homeEntry; /* entry of the front end for the page of the slot */
+
 
-    if ((oid->slotNo >= apage->header.nSlots) ||
-        apage->slot[-oid->slotNo].offset == EMPTYSLOT){
-        BfM_FreeTrain(&pid, PAGE_BUF);
+    MAKE_PAGEID(homePid, oid->volNo, oid->pageNo);
+
+    e = eduom_FixPageForRead(&homePid, &homePage, &homeEntry);
+    if (e < 0) ERR(e);
+
+    if (oid->slotNo < 0 || oid->slotNo >= homePage->header.nSlots || !IS_VALID_OBJECTID(oid, homePage)) {
+        (Four) eduom_UnfixPageForRead(&homePid, homeEntry);
         ERR(eBADOBJECTID_OM);
     }
-    obj = apage->data + apage->slot[-oid->slotNo].offset;
 
-    if (start > obj->header.length){
-        BfM_FreeTrain(&pid, PAGE_BUF);
-        ERR(eBADSTART_OM);
+    (Four) eduom_GetObject(homePage, SP_OFFSET(homePage, oid->slotNo), objHdr, NULL);
+
+    if (objHdr->properties & P_FORWARDED) {
+        (Four) eduom_UnfixPageForRead(&homePid, homeEntry);
+        ERR(eBADOBJECTID_OM);
     }
 
-    if (length == REMAINDER){
-        length = obj->header.length - start;
-    }else if(length < 0 || start + length > obj->header.length){
-        BfM_FreeTrain(&pid, PAGE_BUF);
-        ERR(eBADLENGTH_OM);
+    if (!(objHdr->properties & P_MOVED)) {
+        *pid = homePid;
+        *apage = homePage;
+        *entry = homeEntry;
+        *offset = SP_OFFSET(homePage, oid->slotNo);
+
+        return(eNOERROR);
     }
 
-    memcpy(buf, obj + sizeof(ObjectHdr) + start, length);
-    BfM_FreeTrain(&pid, PAGE_BUF);
+    /*@ follow the stub to the moved data */
+    e = eduom_FixForwardedObject(homePage, SP_OFFSET(homePage, oid->slotNo), pid, apage, entry, offset, objHdr);
 
-    return(length);
-    
-} /* EduOM_ReadObject() */
+    (Four) eduom_UnfixPageForRead(&homePid, homeEntry);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_FixObjectForRead() */
+
+
+
+/*@================================
+ * eduom_FixForwardedObject()
+ *================================*/
+/*
+ * Function: Four eduom_FixForwardedObject(SlottedPage*, Four, PageID*, SlottedPage**, BufferFrontEntry**, Four*, ObjectHdr*)
+ *
+ * Description:
+ *  Fix the page of the data moved from the stub at the given offset of the
+ *  given page, which is fixed by the caller. The header returned is the
+ *  header of the object, without P_FORWARDED.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameters pid, apage, and entry
+ *     the page of the data is fixed; it is unfixed by eduom_UnfixPageForRead()
+ *  2) parameter offset
+ *     offset is set to the offset of the data in the page
+ *  3) parameter objHdr
+ *     objHdr is set to the header of the object
+ */
+Four eduom_FixForwardedObject(
+    SlottedPage *stubPage,	/* IN page holding the stub */
+    Four        stubOffset,	/* IN offset of the stub in the page */
+    PageID      *pid,		/* OUT page holding the moved data */
+    SlottedPage **apage,	/* OUT buffer holding the page */
+    BufferFrontEntry **entry,	/* OUT entry of the front end for the page */
+    Four        *offset,	/* OUT offset of the data in the page */
+    ObjectHdr   *objHdr)	/* OUT header of the object */
+{
+    Four        e;		/* error code */
+    ObjectID    forward;	/* ObjectID of the moved data */
+
+
+    eduom_ReadData(stubPage, stubOffset, 0, FORWARD_STUBLEN, (char*)&forward);
+    STAT_ADD(forwardReads, 1);
+
+    MAKE_PAGEID(*pid, forward.volNo, forward.pageNo);
+
+    e = eduom_FixPageForRead(pid, apage, entry);
+    if (e < 0) ERR(e);
+
+    if (forward.slotNo < 0 || forward.slotNo >= (*apage)->header.nSlots || !IS_VALID_OBJECTID(&forward, *apage)) {
+        (Four) eduom_UnfixPageForRead(pid, *entry);
+        ERR(eBADOBJECTID_OM);
+    }
+
+    *offset = SP_OFFSET(*apage, forward.slotNo);
+    (Four) eduom_GetObject(*apage, *offset, objHdr, NULL);
+
+    if (!(objHdr->properties & P_FORWARDED)) {
+        (Four) eduom_UnfixPageForRead(pid, *entry);
+        ERR(eBADOBJECTID_OM);
+    }
+    objHdr->properties &= ~P_FORWARDED;
+
+    return(eNOERROR);
+
+} /* eduom_FixForwardedObject() */
+
+
+
+/*@================================
+ * eduom_GetForwardedHeader()
+ *================================*/
+/*
+ * Function: Four eduom_GetForwardedHeader(SlottedPage*, Four, ObjectHdr*)
+ *
+ * Description:
+ *  Get the header of the object whose stub is at the given offset of the
+ *  given page, which is fixed by the caller. The scans return a moved
+ *  object with the ObjectID of its stub and this header.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter objHdr
+ *     objHdr is set to the header of the object
+ */
+Four eduom_GetForwardedHeader(
+    SlottedPage *stubPage,	/* IN page holding the stub */
+    Four        stubOffset,	/* IN offset of the stub in the page */
+    ObjectHdr   *objHdr)	/* OUT header of the object */
+{
+    Four        e;		/* error code */
+    PageID      pid;		/* page holding the moved data */
+    SlottedPage *apage;		/* buffer holding the page */
+    BufferFrontEntry *entry;	/* entry of the front end for the page */
+    Four        offset;		/* offset of the data in the page */
+
+
+    e = eduom_FixForwardedObject(stubPage, stubOffset, &pid, &apage, &entry, &offset, objHdr);
+    if (e < 0) ERR(e);
+
+    e = eduom_UnfixPageForRead(&pid, entry);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_GetForwardedHeader() */
@@ -0,0 +1,267 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_ReadObjects.c
+ * 
+ * Description : 
+ *  EduOM_ReadObjects() reads a set of objects. The requests are sorted by
+ *  the page number of the objects and served page by page, so each page is
+ *  fixed once by a single-page fix. No read of several pages is issued; a
+ *  page not in the buffer is read when it is fixed, and the pages are
+ *  fixed in the ascending order of their page numbers.
+ *
+ * Exports:
+ *  Four EduOM_ReadObjects(Four, ObjectID*, Four*, Four*, void**, Four*)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "EduOM_common.h"
+#include "Util.h"		/* to get VarArray */
+#include "EduOM_Internal.h"
+
+
+/*
+ * Typedef for an entry of the sorted requests
+ */
+typedef struct {
+    ObjectID    oid;		/* object to read */
+    Four        index;		/* position of the request given by the caller */
+} ReadRequest;
+
+
+/*@
+ * Internal function prototypes
+ */
+static int eduom_CompareReadRequests(const void*, const void*);
+
+
+
+/*@================================
+ * EduOM_ReadObjects()
+ *================================*/
+/*
+ * Function: Four EduOM_ReadObjects(Four, ObjectID*, Four*, Four*, void**, Four*)
+ * 
+ * Description : 
+ *  EduOM_ReadObjects() serves 'nObjs' read requests; the i-th request reads
+ *  lengths[i] bytes from starts[i] of the object oids[i] into bufs[i], as
+ *  EduOM_ReadObject() does. The requests are sorted by the page holding the
+ *  object internally, and each distinct page is fixed only once.
+ *  The result of the i-th request is returned in results[i]: the number of
+ *  bytes actually read, or an error code if the request fails. A failed
+ *  request does not stop serving the other requests. The data of an object
+ *  moved by an update is read in its page while the page of the stub is
+ *  fixed.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter bufs
+ *     the data read by the i-th request is stored in bufs[i]
+ *  2) parameter results
+ *     results[i] is set to the result of the i-th request
+ */
+Four EduOM_ReadObjects(
+    Four        nObjs,		/* IN # of objects to read */
+    ObjectID    *oids,		/* IN objects to read */
+    Four        *starts,	/* IN starting offset of each read */
+    Four        *lengths,	/* IN amount of data to read by each read */
+    void        **bufs,		/* OUT user buffers to return the read data */
+    Four        *results)	/* OUT bytes read or error code of each read */
+{
+    Four        e;		/* error code */
+    Four        j;		/* index variable */
+    Four        k;		/* index of the request given by the caller */
+    VarArray    sorted;		/* requests sorted by the page */
+    ReadRequest *reqs;		/* entries of 'sorted' */
+    PageID      pid;		/* page fixed currently */
+    SlottedPage *apage;		/* pointer to the buffer of the page */
+    BufferFrontEntry *entry;	/* entry of the buffer front end for the page */
+    PageID      dataPid;	/* page of the data moved by an update */
+    SlottedPage *dataPage;	/* pointer to the buffer holding the data */
+    BufferFrontEntry *dataEntry; /* entry of the buffer front end for 'dataPid' */
+    Four        offset;		/* offset of the data in the page */
+    Boolean     moved;		/* TRUE if 'dataPid' is fixed */
+    ObjectHdr	objHdr;		/* header of the object */
+    Four        start;		/* starting offset of the current read */
+    Four        length;		/* amount of data of the current read */
+
+
+    LAT_BEGIN(LAT_READOBJECTS);
+
+    /*@ check parameters */
+
+    if (nObjs < 0) ERR(eBADPARAMETER_OM);
+
+    if (nObjs == 0) return(eNOERROR);
+
+    if (oids == NULL || starts == NULL || lengths == NULL || bufs == NULL || results == NULL)
+        ERR(eBADPARAMETER_OM);
+
+    STAT_BEGIN(STAT_OP_READ);
+
+    /*@ sort the requests by the page */
+    e = Util_initVarArray(&sorted, sizeof(ReadRequest), nObjs);
+    if (e < 0) ERR(e);
+
+    reqs = (ReadRequest*)sorted.ptr;
+    for (j = 0; j < nObjs; j++) {
+        reqs[j].oid = oids[j];
+        reqs[j].index = j;
+    }
+
+    qsort(reqs, nObjs, sizeof(ReadRequest), eduom_CompareReadRequests);
+
+    /*@ serve the requests page by page */
+    apage = NULL;
+    for (j = 0; j < nObjs; j++) {
+        k = reqs[j].index;
+
+        if (apage == NULL || reqs[j].oid.volNo != pid.volNo || reqs[j].oid.pageNo != pid.pageNo) {
+            if (apage != NULL) {
+                e = eduom_UnfixPageForRead(&pid, entry);
+                apage = NULL;
+                if (e < 0) {
+                    (Four) Util_finalVarArray(&sorted);
+                    ERR(e);
+                }
+            }
+
+            MAKE_PAGEID(pid, reqs[j].oid.volNo, reqs[j].oid.pageNo);
+
+            e = eduom_FixPageForRead(&pid, &apage, &entry);
+            if (e < 0) {
+                /* all the requests for this page fail */
+                apage = NULL;
+                results[k] = e;
+                continue;
+            }
+        }
+
+        /*@ check the request */
+        start = starts[k];
+        length = lengths[k];
+
+        if (length < 0 && length != REMAINDER) {
+            results[k] = eBADLENGTH_OM;
+            continue;
+        }
+
+        if (bufs[k] == NULL) {
+            results[k] = eBADUSERBUF_OM;
+            continue;
+        }
+
+        if (reqs[j].oid.slotNo < 0 || reqs[j].oid.slotNo >= apage->header.nSlots ||
+            !IS_VALID_OBJECTID(&reqs[j].oid, apage)) {
+            results[k] = eBADOBJECTID_OM;
+            continue;
+        }
+
+        /*@ the data moved by an update is read in its own page */
+        moved = FALSE;
+        dataPage = apage;
+        offset = SP_OFFSET(apage, reqs[j].oid.slotNo);
+        (Four) eduom_GetObject(apage, offset, &objHdr, NULL);
+
+        if (objHdr.properties & P_FORWARDED) {
+            results[k] = eBADOBJECTID_OM;
+            continue;
+        }
+
+        if (objHdr.properties & P_MOVED) {
+            e = eduom_FixForwardedObject(apage, offset, &dataPid, &dataPage, &dataEntry, &offset, &objHdr);
+            if (e < 0) {
+                results[k] = e;
+                continue;
+            }
+            moved = TRUE;
+        }
+
+        if (start < 0 || start >= objHdr.length)
+            results[k] = eBADSTART_OM;
+        else {
+            /* the read is cut at the end of the object */
+            if (length == REMAINDER || start + length > objHdr.length)
+                length = objHdr.length - start;
+
+            eduom_ReadData(dataPage, offset, start, length, bufs[k]);
+            results[k] = length;
+        }
+
+        if (moved) (Four) eduom_UnfixPageForRead(&dataPid, dataEntry);
+    }
+
+    if (apage != NULL) {
+        e = eduom_UnfixPageForRead(&pid, entry);
+        if (e < 0) {
+            (Four) Util_finalVarArray(&sorted);
+            ERR(e);
+        }
+    }
+
+    e = Util_finalVarArray(&sorted);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+    
+} /* EduOM_ReadObjects() */
+
+
+
+/*@================================
+ * eduom_CompareReadRequests()
+ *================================*/
+/*
+ * Function: int eduom_CompareReadRequests(const void*, const void*)
+ *
+ * Description :
+ *  Compare two read requests by (volNo, pageNo) of the objects and then by
+ *  the position given by the caller; used by qsort().
+ *
+ * Returns:
+ *  negative, 0, or positive as the first one is less than, equal to, or
+ *  greater than the second one
+ */
+static int eduom_CompareReadRequests(
+    const void *a,		/* IN a read request */
+    const void *b)		/* IN another read request */
+{
+    const ReadRequest *x = (const ReadRequest*)a;
+    const ReadRequest *y = (const ReadRequest*)b;
+
+
+    if (x->oid.volNo != y->oid.volNo) return((x->oid.volNo < y->oid.volNo) ? -1 : 1);
+    if (x->oid.pageNo != y->oid.pageNo) return((x->oid.pageNo < y->oid.pageNo) ? -1 : 1);
+    if (x->index != y->index) return((x->index < y->index) ? -1 : 1);
+
+    return(0);
+
+} /* eduom_CompareReadRequests() */
@@ -0,0 +1,413 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_Scan.c
+ *
+ * Description:
+ *  Scan the objects of a data file through a cursor. The cursor keeps the
+ *  current page pinned and returns the objects in batches, so that a full
+ *  scan costs one pin/unpin pair per page instead of one per object.
+ *  Optionally, the cursor has the pages it will move onto read ahead in the
+ *  background; see EduOM_SetScanReadAhead().
+ *
+ * Exports:
+ *  Four EduOM_OpenScan(ObjectID*, ObjectID*, Four, EduOM_ScanCursor*)
+ *  Four EduOM_FetchBatch(EduOM_ScanCursor*, Four, ObjectID*, ObjectHdr*)
+ *  Four EduOM_CloseScan(EduOM_ScanCursor*)
+ *  Four EduOM_SetScanReadAhead(EduOM_ScanCursor*, Four)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"
+#include "RDsM.h"
+#include "EduOM_Internal.h"
+
+
+/*@
+ * Internal function prototypes
+ */
+static void eduom_ScanReadAhead(EduOM_ScanCursor*, ShortPageID);
+
+
+/*@================================
+ * EduOM_OpenScan()
+ *================================*/
+/*
+ * Function: Four EduOM_OpenScan(ObjectID*, ObjectID*, Four, EduOM_ScanCursor*)
+ *
+ * Description:
+ *  Open a scan cursor on the given data file. The cursor is positioned just
+ *  after (FORWARD) or just before (BACKWARD) the object 'startOID'. If
+ *  'startOID' is NULL, the cursor is positioned before the first object
+ *  (FORWARD) or after the last object (BACKWARD) of the file.
+ *  The page the cursor is positioned on stays pinned until the cursor moves
+ *  off the page or EduOM_CloseScan() is called.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter cursor
+ *     cursor is initialized and holds the starting page pinned
+ */
+Four EduOM_OpenScan(
+    ObjectID  *catObjForFile,	/* IN informations about a data file */
+    ObjectID  *startOID,	/* IN the scan starts next to this object */
+    Four      direction,	/* IN FORWARD or BACKWARD */
+    EduOM_ScanCursor *cursor)	/* OUT the opened scan cursor */
+{
+    Four e;			/* error */
+    sm_CatOverlayForData *catEntry; /* data structure for catalog object access */
+
+
+    LAT_BEGIN(LAT_OPENSCAN);
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (cursor == NULL) ERR(eBADPARAMETER_OM);
+
+    if (direction != FORWARD && direction != BACKWARD) ERR(eBADPARAMETER_OM);
+
+    STAT_BEGIN(STAT_OP_SCAN);
+
+    cursor->catObjForFile = *catObjForFile;
+    cursor->direction = direction;
+    cursor->apage = NULL;
+    cursor->eos = FALSE;
+    cursor->raMaxWindow = 0;
+    cursor->raWindow = 0;
+    cursor->raMoves = 0;
+    cursor->raHits = 0;
+    cursor->raFirst = NIL;
+
+    if (startOID != NULL) {
+        MAKE_PAGEID(cursor->pid, startOID->volNo, startOID->pageNo);
+    } else {
+        e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+        if (e < 0) ERR(e);
+
+        MAKE_PAGEID(cursor->pid, catEntry->fid.volNo,
+                    (direction == FORWARD) ? catEntry->firstPage : catEntry->lastPage);
+    }
+
+    /*@ pin the starting page */
+    e = eduom_GetPageForRead(&cursor->pid, &cursor->apage);
+    if (e < 0) {
+        cursor->apage = NULL;
+        ERR(e);
+    }
+
+    if (startOID != NULL)
+        cursor->slotNo = startOID->slotNo;
+    else
+        cursor->slotNo = (direction == FORWARD) ? -1 : cursor->apage->header.nSlots;
+
+    return(eNOERROR);
+
+} /* EduOM_OpenScan() */
+
+
+
+/*@================================
+ * EduOM_FetchBatch()
+ *================================*/
+/*
+ * Function: Four EduOM_FetchBatch(EduOM_ScanCursor*, Four, ObjectID*, ObjectHdr*)
+ *
+ * Description:
+ *  Return up to 'maxObjs' objects following the cursor position in the scan
+ *  direction; 'maxObjs' must be positive, since a return of 0 means the end
+ *  of the scan. The cursor follows 'nextPage' (FORWARD) or 'prevPage'
+ *  (BACKWARD) of the pinned page by itself; a page is pinned when the cursor
+ *  moves onto it and unpinned when the cursor leaves it.
+ *  An object moved by an update is returned with the ObjectID of its stub
+ *  and its own header; the slot of the moved data is skipped.
+ *
+ * Returns:
+ *  1) number of objects returned (0 means the end of the scan)
+ *  2) error code (negative values)
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter oids
+ *     oids[0..n-1] are filled with the identifiers of the returned objects
+ *  2) parameter objHdrs
+ *     if not NULL, objHdrs[0..n-1] are filled with the object headers
+ */
+Four EduOM_FetchBatch(
+    EduOM_ScanCursor *cursor,	/* INOUT the scan cursor */
+    Four      maxObjs,		/* IN size of the output arrays */
+    ObjectID  *oids,		/* OUT identifiers of the returned objects */
+    ObjectHdr *objHdrs)		/* OUT headers of the returned objects */
+{
+    Four e;			/* error */
+    Four n;			/* # of objects returned */
+    Two  i;			/* slot index */
+    Two  step;			/* +1 for FORWARD, -1 for BACKWARD */
+    ShortPageID nextPageNo;	/* page the cursor moves on to */
+    ShortPageID prevPageNo;	/* page the cursor left */
+    SlottedPage *apage;		/* a pointer to the pinned page */
+    ObjectHdr objHdr;		/* header of an object of the page */
+
+
+    LAT_BEGIN(LAT_FETCHBATCH);
+
+    /*@ parameter checking */
+    if (cursor == NULL || maxObjs <= 0 || oids == NULL) ERR(eBADPARAMETER_OM);
+
+    STAT_BEGIN(STAT_OP_SCAN);
+
+    if (cursor->eos) return(0);
+
+    step = (cursor->direction == FORWARD) ? 1 : -1;
+    n = 0;
+
+    while (n < maxObjs) {
+
+        apage = cursor->apage;
+
+        /* collect the remaining objects of the pinned page */
+        for (i = cursor->slotNo + step; n < maxObjs && i >= 0 && i < apage->header.nSlots; i += step) {
+            if (SP_OFFSET(apage, i) == EMPTYSLOT) continue;
+
+            /* the data moved by an update is returned at its stub */
+            (Four) eduom_GetObject(apage, SP_OFFSET(apage, i), &objHdr, NULL);
+            if (objHdr.properties & P_FORWARDED) continue;
+            if ((objHdr.properties & P_MOVED) && objHdrs != NULL) {
+                e = eduom_GetForwardedHeader(apage, SP_OFFSET(apage, i), &objHdr);
+                if (e < 0) ERR(e);
+            }
+
+            MAKE_OBJECTID(oids[n], cursor->pid.volNo, cursor->pid.pageNo, i, SP_UNIQUE(apage, i));
+            if (objHdrs != NULL) objHdrs[n] = objHdr;
+            cursor->slotNo = i;
+            n++;
+        }
+        if (n == maxObjs) break;
+
+        /* the page is exhausted; move on to the neighbor page */
+        nextPageNo = (cursor->direction == FORWARD) ? apage->header.nextPage : apage->header.prevPage;
+
+        e = eduom_FreePageForRead(&cursor->pid);
+        cursor->apage = NULL;
+        if (e < 0) ERR(e);
+
+        if (nextPageNo == NIL) {
+            cursor->eos = TRUE;
+            break;
+        }
+
+        prevPageNo = cursor->pid.pageNo;
+        cursor->pid.pageNo = nextPageNo;
+        e = eduom_GetPageForRead(&cursor->pid, &cursor->apage);
+        if (e < 0) {
+            cursor->apage = NULL;
+            cursor->eos = TRUE;
+            ERR(e);
+        }
+        STAT_ADD(scanPageMoves, 1);
+        cursor->slotNo = (cursor->direction == FORWARD) ? -1 : cursor->apage->header.nSlots;
+
+        if (cursor->raMaxWindow > 0) eduom_ScanReadAhead(cursor, prevPageNo);
+    }
+
+    return(n);
+
+} /* EduOM_FetchBatch() */
+
+
+
+/*@================================
+ * EduOM_CloseScan()
+ *================================*/
+/*
+ * Function: Four EduOM_CloseScan(EduOM_ScanCursor*)
+ *
+ * Description:
+ *  Close the scan cursor; the page held by the cursor is unpinned.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_CloseScan(
+    EduOM_ScanCursor *cursor)	/* IN the scan cursor to close */
+{
+    Four e;			/* error */
+
+
+    /*@ parameter checking */
+    if (cursor == NULL) ERR(eBADPARAMETER_OM);
+
+    if (cursor->apage != NULL) {
+        cursor->apage = NULL;
+        e = eduom_FreePageForRead(&cursor->pid);
+        if (e < 0) ERR(e);
+    }
+    cursor->eos = TRUE;
+
+    return(eNOERROR);
+
+} /* EduOM_CloseScan() */
+
+
+
+/*@================================
+ * EduOM_SetScanReadAhead()
+ *================================*/
+/*
+ * Function: Four EduOM_SetScanReadAhead(EduOM_ScanCursor*, Four)
+ *
+ * Description:
+ *  Enable the read-ahead of the scan cursor on a volume opened by
+ *  EduOM_EnablePrefetch() or mapped by EduOM_MapVolume(). Once the cursor
+ *  has moved SCAN_RA_TRIGGER times in a row onto the page next to the one
+ *  it left, the pages following the cursor in the scan direction, up to
+ *  the window and the end of the extent of the cursor, are advised to be
+ *  read in the background. The window starts at SCAN_RA_MINWINDOW pages; it
+ *  is doubled, up to 'maxWindow' pages, each time the cursor has moved as
+ *  many times as the window onto the pages read ahead, and it is halved
+ *  when the cursor leaves the pages read ahead before their end. 'maxWindow'
+ *  0 disables the read-ahead.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ */
+Four EduOM_SetScanReadAhead(
+    EduOM_ScanCursor *cursor,	/* INOUT the scan cursor */
+    Four      maxWindow)	/* IN max # of pages read ahead */
+{
+    /*@ parameter checking */
+    if (cursor == NULL || maxWindow < 0) ERR(eBADPARAMETER_OM);
+
+    cursor->raMaxWindow = MIN(maxWindow, SCAN_RA_MAXWINDOW);
+    cursor->raWindow = MIN(SCAN_RA_MINWINDOW, cursor->raMaxWindow);
+    cursor->raMoves = 0;
+    cursor->raHits = 0;
+    cursor->raFirst = NIL;
+
+    return(eNOERROR);
+
+} /* EduOM_SetScanReadAhead() */
+
+
+
+/*@================================
+ * eduom_ScanReadAhead()
+ *================================*/
+/*
+ * Function: void eduom_ScanReadAhead(EduOM_ScanCursor*, ShortPageID)
+ *
+ * Description:
+ *  Adapt the read-ahead window to the move of the cursor onto its page from
+ *  'prevPageNo', and advise the pages following the cursor to be read when
+ *  no more than half the window is left ahead of it. The pages are taken
+ *  from the extent of the cursor only, since the next extent of the file is
+ *  not known before the chain reaches it. The errors are ignored since the
+ *  read-ahead is only a hint.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_ScanReadAhead(
+    EduOM_ScanCursor *cursor,	/* INOUT the scan cursor */
+    ShortPageID prevPageNo)	/* IN page the cursor left */
+{
+    Four step;			/* +1 for FORWARD, -1 for BACKWARD */
+    Four ahead;			/* # of pages read ahead of the cursor */
+    Four extNo;			/* extent of the cursor */
+    Four pageExtNo;		/* extent of a page to read ahead */
+    Four n;			/* # of pages to read ahead */
+    ShortPageID pageNo;		/* page the cursor is on */
+    ShortPageID first;		/* first page to read ahead in the scan direction */
+    PageID pid;			/* a page to read ahead */
+
+
+    step = (cursor->direction == FORWARD) ? 1 : -1;
+    pageNo = cursor->pid.pageNo;
+
+    /*@ a move onto a page read ahead is a hit; leaving them before their end is a miss */
+    if (cursor->raFirst != NIL) {
+        if (pageNo >= cursor->raFirst && pageNo <= cursor->raLast) {
+            STAT_ADD(prefetchHits, 1);
+            if (++cursor->raHits >= cursor->raWindow) {
+                cursor->raWindow = MIN(2*cursor->raWindow, cursor->raMaxWindow);
+                cursor->raHits = 0;
+            }
+        } else {
+            if (prevPageNo != ((step > 0) ? cursor->raLast : cursor->raFirst)) {
+                cursor->raWindow = MAX(cursor->raWindow/2, MIN(SCAN_RA_MINWINDOW, cursor->raMaxWindow));
+                cursor->raHits = 0;
+            }
+            cursor->raFirst = NIL;
+        }
+    }
+
+    /*@ the read-ahead starts on a sequential progress along the chain */
+    cursor->raMoves = (pageNo == prevPageNo + step) ? cursor->raMoves + 1 : 0;
+    if (cursor->raMoves < SCAN_RA_TRIGGER) return;
+
+    if (cursor->raFirst == NIL) {
+        ahead = 0;
+        first = pageNo + step;
+    } else {
+        ahead = (step > 0) ? cursor->raLast - pageNo : pageNo - cursor->raFirst;
+        first = (step > 0) ? cursor->raLast + 1 : cursor->raFirst - 1;
+    }
+    if (ahead > cursor->raWindow/2) return;
+
+    /*@ take the pages up to the window and the end of the extent */
+    if (RDsM_PageIdToExtNo(&cursor->pid, &extNo) < 0) return;
+
+    pid.volNo = cursor->pid.volNo;
+    for (n = 0; n < cursor->raWindow - ahead; n++) {
+        pid.pageNo = first + n*step;
+        if (pid.pageNo < 0) break;
+        if (RDsM_PageIdToExtNo(&pid, &pageExtNo) < 0 || pageExtNo != extNo) break;
+    }
+    if (n == 0) return;
+
+    pid.pageNo = (step > 0) ? first : first - n + 1;
+    n = eduom_PrefetchPages(&pid, n);
+    if (n == 0) return;
+
+    if (step > 0) {
+        if (cursor->raFirst == NIL) cursor->raFirst = first;
+        cursor->raLast = first + n - 1;
+    } else {
+        if (cursor->raFirst == NIL) cursor->raLast = first;
+        cursor->raFirst = pid.pageNo;
+    }
+
+} /* eduom_ScanReadAhead() */
@@ -0,0 +1,299 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_Stats.c
+ *
+ * Description:
+ *  Counters of the hot paths of EduOM: the pins done by each operation, the
+ *  compactions and the bytes they move, the pages allocated and deallocated,
+ *  the moves between the available space lists, the unique numbers assigned,
+ *  and the page moves of the scans.
+ *  Each thread counts into its own copy of the counters, so counting costs
+ *  an increment of a thread local variable. The copy of a thread is
+ *  allocated on the first use and is added to the retired counters when the
+ *  thread exits. The counters of the threads running during
+ *  EduOM_GetStats() or EduOM_ResetStats() may be off by the increments done
+ *  meanwhile.
+ *
+ * Exports:
+ *  Four EduOM_GetStats(EduOM_Stats*)
+ *  Four EduOM_ResetStats(void)
+ *
+ * Internal Functions:
+ *  ThreadStats *eduom_AllocThreadStats(void)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+
+
+/*@
+ * Global variables
+ */
+__thread ThreadStats *eduom_threadStats = NULL;
+
+static ThreadStats *eduom_statsList = NULL;	/* counters of the running threads */
+static EduOM_Stats eduom_retiredStats;		/* counters of the exited threads */
+static ThreadStats eduom_sharedStats;		/* used if the allocation fails */
+
+/* latch of the list of the counters and of the retired counters */
+static pthread_mutex_t eduom_statsLatch = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_once_t eduom_statsOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t eduom_statsKey;		/* key to retire the counters at the thread exit */
+
+
+/*@
+ * Internal Function Prototypes
+ */
+static void eduom_InitStatsKey(void);
+static void eduom_RetireThreadStats(void*);
+static void eduom_AddStats(EduOM_Stats*, EduOM_Stats*);
+
+
+
+/*@================================
+ * EduOM_GetStats()
+ *================================*/
+/*
+ * Function: Four EduOM_GetStats(EduOM_Stats*)
+ *
+ * Description:
+ *  Return the sum of the counters of all the threads, including the
+ *  threads which have exited, since the last EduOM_ResetStats().
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ */
+Four EduOM_GetStats(
+    EduOM_Stats *stats)		/* OUT the counters */
+{
+    ThreadStats *ts;		/* counters of a thread */
+
+
+    /*@ parameter checking */
+    if (stats == NULL) ERR(eBADPARAMETER_OM);
+
+    (void) pthread_mutex_lock(&eduom_statsLatch);
+
+    *stats = eduom_retiredStats;
+    for (ts = eduom_statsList; ts != NULL; ts = ts->next)
+        eduom_AddStats(stats, &ts->stats);
+    eduom_AddStats(stats, &eduom_sharedStats.stats);
+
+    (void) pthread_mutex_unlock(&eduom_statsLatch);
+
+    return(eNOERROR);
+
+} /* EduOM_GetStats() */
+
+
+
+/*@================================
+ * EduOM_ResetStats()
+ *================================*/
+/*
+ * Function: Four EduOM_ResetStats(void)
+ *
+ * Description:
+ *  Clear the counters of all the threads.
+ *
+ * Returns:
+ *  error code
+ */
+Four EduOM_ResetStats(void)
+{
+    ThreadStats *ts;		/* counters of a thread */
+
+
+    (void) pthread_mutex_lock(&eduom_statsLatch);
+
+    memset(&eduom_retiredStats, 0, sizeof(EduOM_Stats));
+    for (ts = eduom_statsList; ts != NULL; ts = ts->next)
+        memset(&ts->stats, 0, sizeof(EduOM_Stats));
+    memset(&eduom_sharedStats.stats, 0, sizeof(EduOM_Stats));
+
+    (void) pthread_mutex_unlock(&eduom_statsLatch);
+
+    return(eNOERROR);
+
+} /* EduOM_ResetStats() */
+
+
+
+/*@================================
+ * eduom_AllocThreadStats()
+ *================================*/
+/*
+ * Function: ThreadStats *eduom_AllocThreadStats(void)
+ *
+ * Description:
+ *  Allocate the counters of the calling thread and link them into the list
+ *  of the running threads. If the allocation fails, the thread counts into
+ *  the counters shared by such threads, which may lose some increments.
+ *
+ * Returns:
+ *  the counters of the thread
+ */
+ThreadStats *eduom_AllocThreadStats(void)
+{
+    ThreadStats *ts;		/* counters of the thread */
+
+
+    (void) pthread_once(&eduom_statsOnce, eduom_InitStatsKey);
+
+    ts = (ThreadStats*)calloc(1, sizeof(ThreadStats));
+    if (ts == NULL) {
+        eduom_threadStats = &eduom_sharedStats;
+        return(eduom_threadStats);
+    }
+
+    (void) pthread_mutex_lock(&eduom_statsLatch);
+
+    ts->prev = NULL;
+    ts->next = eduom_statsList;
+    if (eduom_statsList != NULL) eduom_statsList->prev = ts;
+    eduom_statsList = ts;
+
+    (void) pthread_mutex_unlock(&eduom_statsLatch);
+
+    (void) pthread_setspecific(eduom_statsKey, ts);
+    eduom_threadStats = ts;
+
+    return(ts);
+
+} /* eduom_AllocThreadStats() */
+
+
+
+/*@================================
+ * eduom_InitStatsKey()
+ *================================*/
+/*
+ * Function: void eduom_InitStatsKey(void)
+ *
+ * Description:
+ *  Create the key whose destructor retires the counters of an exiting
+ *  thread. It is called once.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_InitStatsKey(void)
+{
+    (void) pthread_key_create(&eduom_statsKey, eduom_RetireThreadStats);
+
+} /* eduom_InitStatsKey() */
+
+
+
+/*@================================
+ * eduom_RetireThreadStats()
+ *================================*/
+/*
+ * Function: void eduom_RetireThreadStats(void*)
+ *
+ * Description:
+ *  Add the counters of an exiting thread to the retired counters, and free
+ *  them.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_RetireThreadStats(
+    void        *arg)		/* IN counters of the thread */
+{
+    ThreadStats *ts = (ThreadStats*)arg;
+
+
+    (void) pthread_mutex_lock(&eduom_statsLatch);
+
+    eduom_AddStats(&eduom_retiredStats, &ts->stats);
+
+    if (ts->prev != NULL) ts->prev->next = ts->next;
+    else eduom_statsList = ts->next;
+    if (ts->next != NULL) ts->next->prev = ts->prev;
+
+    (void) pthread_mutex_unlock(&eduom_statsLatch);
+
+    eduom_threadStats = NULL;
+    free(ts);
+
+} /* eduom_RetireThreadStats() */
+
+
+
+/*@================================
+ * eduom_AddStats()
+ *================================*/
+/*
+ * Function: void eduom_AddStats(EduOM_Stats*, EduOM_Stats*)
+ *
+ * Description:
+ *  Add the counters of 'from' to those of 'to'. A counter added to
+ *  EduOM_Stats must be added here as well.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_AddStats(
+    EduOM_Stats *to,		/* INOUT the sum */
+    EduOM_Stats *from)		/* IN counters added */
+{
+    Four        i;		/* index variable */
+
+
+    for (i = 0; i < STAT_NOPS; i++) {
+        to->calls[i] += from->calls[i];
+        to->pins[i] += from->pins[i];
+    }
+
+    to->compactions += from->compactions;
+    to->compactBytes += from->compactBytes;
+    to->pageAllocs += from->pageAllocs;
+    to->pageDeallocs += from->pageDeallocs;
+    to->availListPuts += from->availListPuts;
+    to->availListRemoves += from->availListRemoves;
+    to->spaceMisses += from->spaceMisses;
+    to->appendHits += from->appendHits;
+    to->destroyLastSlot += from->destroyLastSlot;
+    to->uniques += from->uniques;
+    to->uniqueRefills += from->uniqueRefills;
+    to->scanPageMoves += from->scanPageMoves;
+    to->compactRefusals += from->compactRefusals;
+    to->compactDeferrals += from->compactDeferrals;
+    to->deferredCompactions += from->deferredCompactions;
+    to->updatesInPlace += from->updatesInPlace;
+    to->forwards += from->forwards;
+    to->forwardReads += from->forwardReads;
+    to->prefetchPages += from->prefetchPages;
+    to->prefetchHits += from->prefetchHits;
+
+} /* eduom_AddStats() */
@@ -0,0 +1,576 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_UpdateObject.c
+ *
+ * Description:
+ *  Update the data of an object keeping its ObjectID. The new data is put
+ *  in place when it takes no more space than the old data; otherwise it is
+ *  put at the end of the data area, and the page is compacted first if the
+ *  contiguous free area is short. If the page has no room for the new data,
+ *  the data is moved to a page chosen by the free space map, and a stub
+ *  referring to the moved data is left in the slot of the object(see
+ *  FORWARD_STUBLEN). An update of a moved object puts the data back into
+ *  the page of the stub if the page has room again, or else into the page
+ *  of the moved data, or else moves the data again; the stub always refers
+ *  to the data directly.
+ *
+ * Exports:
+ *  Four EduOM_UpdateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, Pool*, DeallocListElem*)
+ *  Four EduOM_WriteObject(ObjectID*, ObjectID*, Four, Four, char*, Pool*, DeallocListElem*)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+/*@
+ * Internal function prototypes
+ */
+static Four eduom_UpdateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, Pool*, DeallocListElem*);
+static Four eduom_ReplaceObject(ObjectID*, FreeSpaceMap*, PageID*, SlottedPage*, Two, ObjectHdr*, char*, Boolean, Boolean*);
+
+
+
+/*@================================
+ * EduOM_UpdateObject()
+ *================================*/
+/*
+ * Function: Four EduOM_UpdateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, Pool*, DeallocListElem*)
+ *
+ * Description:
+ *  Replace the data of the object 'oid' with 'length' bytes of 'data'. The
+ *  tag of the object is set from 'objHdr', or kept if 'objHdr' is NULL.
+ *  The ObjectID of the object does not change; if the data is moved to
+ *  another page, EduOM_ReadObject() and the scans follow the stub left in
+ *  the slot of the object. A page emptied by the update is put into the
+ *  dealloc list. An object of a file of fixed-length objects keeps its
+ *  length.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    eBADFILEID_OM
+ *    eNOTSUPPORTED_EDUOM
+ *    eNOSPACEFORSTUB_EDUOM
+ *    eVOLUMEMAPPED_EDUOM
+ *    some errors caused by function calls
+ */
+Four EduOM_UpdateObject(
+    ObjectID  *catObjForFile,	/* IN file containing the object */
+    ObjectID  *oid,		/* IN object to update */
+    ObjectHdr *objHdr,		/* IN from which tag is to be set; NULL keeps the tag */
+    Four      length,		/* IN amount of the new data */
+    char      *data,		/* IN the new data of the object */
+    Pool      *dlPool,		/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four e;			/* error */
+
+
+    LAT_BEGIN(LAT_UPDATEOBJECT);
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (eduom_IsMappedVolume(catObjForFile->volNo)) ERR(eVOLUMEMAPPED_EDUOM);
+
+    if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+    if (length < 0) ERR(eBADLENGTH_OM);
+
+    if (length > 0 && data == NULL) ERR(eBADUSERBUF_OM);
+
+    /* Error check whether using not supported functionality by EduOM */
+    if (ALIGNED_LENGTH(length) > LRGOBJ_THRESHOLD) ERR(eNOTSUPPORTED_EDUOM);
+
+    STAT_BEGIN(STAT_OP_UPDATE);
+
+    e = eduom_UpdateObject(catObjForFile, oid, objHdr, length, data, dlPool, dlHead);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_UpdateObject() */
+
+
+
+/*@================================
+ * EduOM_WriteObject()
+ *================================*/
+/*
+ * Function: Four EduOM_WriteObject(ObjectID*, ObjectID*, Four, Four, char*, Pool*, DeallocListElem*)
+ *
+ * Description:
+ *  Overwrite 'length' bytes of the data of the object 'oid' from the byte
+ *  'start' with 'data'. The object grows if the bytes go beyond its end;
+ *  'start' may be the length of the object to append the bytes. The bytes
+ *  within the object are written directly into the page; an object which
+ *  grows, or whose data is not contiguous in a page with a prefix, is
+ *  updated by EduOM_UpdateObject().
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eBADSTART_OM
+ *    eBADUSERBUF_OM
+ *    eBADFILEID_OM
+ *    eMEMORYALLOCERR_EDUOM
+ *    eNOTSUPPORTED_EDUOM
+ *    eNOSPACEFORSTUB_EDUOM
+ *    eVOLUMEMAPPED_EDUOM
+ *    some errors caused by function calls
+ */
+Four EduOM_WriteObject(
+    ObjectID  *catObjForFile,	/* IN file containing the object */
+    ObjectID  *oid,		/* IN object to write */
+    Four      start,		/* IN starting offset of the write */
+    Four      length,		/* IN amount of data to write */
+    char      *data,		/* IN the data to write */
+    Pool      *dlPool,		/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four e;			/* error */
+    PageID pid;			/* page holding the data of the object */
+    SlottedPage *apage;		/* pointer to the buffer holding the page */
+    Four offset;		/* offset of the data in the page */
+    ObjectHdr objHdr;		/* header of the object */
+    ObjectID forward;		/* ObjectID of the data moved by an update */
+    char *objData;		/* data of the object in the page */
+    char *buf;			/* the whole data of the object after the write */
+    Four newLength;		/* length of the object after the write */
+
+
+    LAT_BEGIN(LAT_WRITEOBJECT);
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (eduom_IsMappedVolume(catObjForFile->volNo)) ERR(eVOLUMEMAPPED_EDUOM);
+
+    if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+    if (length < 0) ERR(eBADLENGTH_OM);
+
+    if (length > 0 && data == NULL) ERR(eBADUSERBUF_OM);
+
+    STAT_BEGIN(STAT_OP_UPDATE);
+
+    /*@ fix the page of the data of the object */
+    MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+
+    e = EDUOM_GETTRAIN(&pid, (char**)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+    STAT_PIN();
+
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(oid, apage))
+        ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+
+    offset = SP_OFFSET(apage, oid->slotNo);
+    (Four) eduom_GetObject(apage, offset, &objHdr, NULL);
+
+    if (objHdr.properties & P_FORWARDED) ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+
+    if (objHdr.properties & P_MOVED) {
+        eduom_ReadData(apage, offset, 0, FORWARD_STUBLEN, (char*)&forward);
+
+        e = BfM_FreeTrain(&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        MAKE_PAGEID(pid, forward.volNo, forward.pageNo);
+
+        e = EDUOM_GETTRAIN(&pid, (char**)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+        STAT_PIN();
+
+        if (forward.slotNo < 0 || forward.slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(&forward, apage))
+            ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+
+        offset = SP_OFFSET(apage, forward.slotNo);
+    }
+
+    (Four) eduom_GetObject(apage, offset, &objHdr, &objData);
+
+    if (start < 0 || start > objHdr.length) ERRB1(eBADSTART_OM, &pid, PAGE_BUF);
+
+    /*@ the bytes within the object are written in place */
+    if (start + length <= objHdr.length && objData != NULL) {
+        if (length > 0) memcpy(objData + start, data, length);
+        STAT_ADD(updatesInPlace, 1);
+
+        e = BfM_SetDirty(&pid, PAGE_BUF);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+        e = BfM_FreeTrain(&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        return(eNOERROR);
+    }
+
+    /*@ otherwise, the whole data after the write replaces the data */
+    newLength = MAX(objHdr.length, start + length);
+    if (ALIGNED_LENGTH(newLength) > LRGOBJ_THRESHOLD) ERRB1(eNOTSUPPORTED_EDUOM, &pid, PAGE_BUF);
+
+    buf = (char*)malloc(MAX(newLength, 1));
+    if (buf == NULL) ERRB1(eMEMORYALLOCERR_EDUOM, &pid, PAGE_BUF);
+
+    eduom_ReadData(apage, offset, 0, objHdr.length, buf);
+    if (length > 0) memcpy(buf + start, data, length);
+
+    e = BfM_FreeTrain(&pid, PAGE_BUF);
+    if (e < 0) {
+        free(buf);
+        ERR(e);
+    }
+
+    e = eduom_UpdateObject(catObjForFile, oid, NULL, newLength, buf, dlPool, dlHead);
+    free(buf);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_WriteObject() */
+
+
+
+/*@================================
+ * eduom_UpdateObject()
+ *================================*/
+/*
+ * Function: Four eduom_UpdateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, Pool*, DeallocListElem*)
+ *
+ * Description:
+ *  Replace the data of the object 'oid', as described in
+ *  EduOM_UpdateObject(). The new data is put
+ *   (1) into the page of the slot of the object, replacing the object or
+ *       its stub; the moved data is destroyed then,
+ *   (2) else into the page of the moved data, replacing the moved data,
+ *   (3) else into a new place chosen by the free space map, and the stub
+ *       left in the slot refers to the new place; the old moved data is
+ *       destroyed then.
+ *  A stub must fit into the page of the slot; if the object is smaller
+ *  than a stub and the page has no room for the difference, the object
+ *  cannot be moved.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eBADFILEID_OM
+ *    eNOSPACEFORSTUB_EDUOM
+ *    some errors caused by function calls
+ */
+static Four eduom_UpdateObject(
+    ObjectID  *catObjForFile,	/* IN file containing the object */
+    ObjectID  *oid,		/* IN object to update */
+    ObjectHdr *objHdr,		/* IN from which tag is to be set; NULL keeps the tag */
+    Four      length,		/* IN amount of the new data */
+    char      *data,		/* IN the new data of the object */
+    Pool      *dlPool,		/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four e;			/* error */
+    PageID pid;			/* page of the slot of the object */
+    SlottedPage *apage;		/* pointer to the buffer holding the page */
+    PageID fpid;		/* page of the moved data */
+    SlottedPage *fpage;		/* pointer to the buffer holding the page of the moved data */
+    Boolean moved;		/* TRUE if the object is a stub left by an update */
+    Boolean done;		/* TRUE if the new data is put into the page */
+    ObjectID forward;		/* ObjectID of the moved data */
+    ObjectID newForward;	/* ObjectID of the data moved by this update */
+    ObjectHdr hdr;		/* header of the object */
+    ObjectHdr newHdr;		/* header of the new data */
+    ObjectHdr stubHdr;		/* header of the stub */
+    Four oldSpace;		/* space taken by the object in the page of the slot */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+    FreeSpaceMap *fsm;		/* free space map of the file */
+
+
+    /*@ read the catalog entry of the file */
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+
+    e = eduom_GetFreeSpaceMap(catObjForFile, catEntry, &fsm);
+    if (e < 0) ERR(e);
+
+    if (fsm->format == PAGE_FORMAT_FIXED && length != fsm->cellSize) ERR(eBADLENGTH_OM);
+
+    /*@ fix the page of the slot of the object */
+    MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+
+    e = EDUOM_GETTRAIN(&pid, (char**)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+    STAT_PIN();
+
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(oid, apage))
+        ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+
+    if (!EQUAL_FILEID(catEntry->fid, apage->header.fid))
+        ERRB1(eBADFILEID_OM, &pid, PAGE_BUF);
+
+    oldSpace = eduom_GetObject(apage, SP_OFFSET(apage, oid->slotNo), &hdr, NULL);
+
+    if (hdr.properties & P_FORWARDED) ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+
+    /*@ fix the page of the moved data, which has the header of the object */
+    moved = (hdr.properties & P_MOVED) ? TRUE : FALSE;
+    if (moved) {
+        eduom_ReadData(apage, SP_OFFSET(apage, oid->slotNo), 0, FORWARD_STUBLEN, (char*)&forward);
+        MAKE_PAGEID(fpid, forward.volNo, forward.pageNo);
+
+        e = EDUOM_GETTRAIN(&fpid, (char**)&fpage, PAGE_BUF);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+        STAT_PIN();
+
+        if (forward.slotNo >= 0 && forward.slotNo < fpage->header.nSlots && IS_VALID_OBJECTID(&forward, fpage))
+            (Four) eduom_GetObject(fpage, SP_OFFSET(fpage, forward.slotNo), &hdr, NULL);
+
+        if (!(hdr.properties & P_FORWARDED)) {
+            (Four) BfM_FreeTrain(&fpid, PAGE_BUF);
+            ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+        }
+    }
+
+    newHdr.properties = 0x0;
+    newHdr.tag = (objHdr != NULL) ? objHdr->tag : hdr.tag;
+    newHdr.length = length;
+
+    /*@ (1) put the new data into the page of the slot */
+    e = eduom_ReplaceObject(catObjForFile, fsm, &pid, apage, oid->slotNo, &newHdr, data, FALSE, &done);
+    if (e < 0) {
+        if (moved) (Four) BfM_FreeTrain(&fpid, PAGE_BUF);
+        ERRB1(e, &pid, PAGE_BUF);
+    }
+
+    if (done) {
+        STAT_ADD(updatesInPlace, 1);
+
+        e = BfM_FreeTrain(&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        if (moved) {
+            e = BfM_FreeTrain(&fpid, PAGE_BUF);
+            if (e < 0) ERR(e);
+
+            /* the object is back in the page of its slot */
+            e = eduom_DestroyObject(catObjForFile, &forward, TRUE, dlPool, dlHead);
+            if (e < 0) ERR(e);
+        }
+
+        return(eNOERROR);
+    }
+
+    /*@ (2) put the new data into the page of the moved data */
+    newHdr.properties = P_FORWARDED;
+
+    if (moved) {
+        e = eduom_ReplaceObject(catObjForFile, fsm, &fpid, fpage, forward.slotNo, &newHdr, data, FALSE, &done);
+
+        (Four) BfM_FreeTrain(&fpid, PAGE_BUF);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+        if (done) {
+            STAT_ADD(updatesInPlace, 1);
+
+            e = BfM_FreeTrain(&pid, PAGE_BUF);
+            if (e < 0) ERR(e);
+
+            return(eNOERROR);
+        }
+    }
+
+    /*@ (3) move the new data to another page and leave a stub referring to it */
+    stubHdr.properties = P_MOVED;
+    stubHdr.tag = 0;
+    stubHdr.length = FORWARD_STUBLEN;
+
+    if (!moved && SP_FREE(apage) + oldSpace < eduom_ObjectSize(SP_FORMAT(apage), &stubHdr))
+        ERRB1(eNOSPACEFORSTUB_EDUOM, &pid, PAGE_BUF);
+
+    e = eduom_CreateObject(catObjForFile, NULL, &newHdr, length, data, &newForward);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    /* the stub takes no more space than the room checked above, so the compaction is forced */
+    e = eduom_ReplaceObject(catObjForFile, fsm, &pid, apage, oid->slotNo, &stubHdr, (char*)&newForward, TRUE, &done);
+    if (e >= 0 && !done) e = eNOSPACEFORSTUB_EDUOM;
+    if (e < 0) {
+        (Four) BfM_FreeTrain(&pid, PAGE_BUF);
+        (Four) eduom_DestroyObject(catObjForFile, &newForward, TRUE, dlPool, dlHead);
+        ERR(e);
+    }
+    STAT_ADD(forwards, 1);
+
+    e = BfM_FreeTrain(&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    /*@ the old moved data is replaced by the new one */
+    if (moved) {
+        e = eduom_DestroyObject(catObjForFile, &forward, TRUE, dlPool, dlHead);
+        if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* eduom_UpdateObject() */
+
+
+
+/*@================================
+ * eduom_ReplaceObject()
+ *================================*/
+/*
+ * Function: Four eduom_ReplaceObject(ObjectID*, FreeSpaceMap*, PageID*, SlottedPage*, Two, ObjectHdr*, char*, Boolean, Boolean*)
+ *
+ * Description:
+ *  Replace the object in the given slot of the page, which is fixed by the
+ *  caller, with the object of the given header and data if the page has
+ *  room for it. The object is written in place if it takes no more space
+ *  than the old one or the old one ends at 'free'; otherwise it is written
+ *  into the contiguous free area, and the page is compacted first if the
+ *  area is short, with the old object moved to the end of the data area.
+ *  A compaction refused by the compaction policy leaves the page without
+ *  room unless 'force' is TRUE. The available space list and the free
+ *  space map follow the free space of the page, and the page is set dirty.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter done
+ *     done is set to TRUE if the object is replaced
+ */
+static Four eduom_ReplaceObject(
+    ObjectID  *catObjForFile,	/* IN file containing the page */
+    FreeSpaceMap *fsm,		/* INOUT free space map of the file */
+    PageID    *pid,		/* IN page of the object */
+    SlottedPage *apage,		/* INOUT buffer holding the page */
+    Two       slotNo,		/* IN slot of the object */
+    ObjectHdr *objHdr,		/* IN header of the new object */
+    char      *data,		/* IN data of the new object */
+    Boolean   force,		/* IN TRUE if the compaction is not refused */
+    Boolean   *done)		/* OUT TRUE if the object is replaced */
+{
+    Four e;			/* error */
+    Four offset;		/* offset of the object in the data area */
+    Four oldSpace;		/* space taken by the old object */
+    Four newSpace;		/* space taken by the new object */
+    Boolean atEnd;		/* TRUE if the old object ends at 'free' */
+    Four oldCategory;		/* available space list of the page before the update */
+    Four newCategory;		/* available space list of the page after the update */
+
+
+    *done = FALSE;
+
+    offset = SP_OFFSET(apage, slotNo);
+    oldSpace = eduom_GetObject(apage, offset, NULL, NULL);
+    newSpace = eduom_PageObjectSize(apage, objHdr, data);
+    atEnd = (offset + oldSpace == apage->header.free) ? TRUE : FALSE;
+
+    if (newSpace > oldSpace) {
+        /* the page has no room even if it is compacted */
+        if (SP_FREE(apage) + oldSpace < eduom_ObjectSize(SP_FORMAT(apage), objHdr)) return(eNOERROR);
+
+        if (!(atEnd && SP_CFREE(apage) >= newSpace - oldSpace) && SP_CFREE(apage) < newSpace) {
+            if (!force && !eduom_MayCompact(apage, 0)) {
+                eduom_DeferCompaction(catObjForFile, pid, apage, TRUE);
+                return(eNOERROR);
+            }
+
+            /*@ compact the page; the old object goes to the end of the data area */
+            EduOM_CompactPage(apage, slotNo);
+
+            e = BfM_SetDirty(pid, PAGE_BUF);
+            if (e < 0) ERR(e);
+
+            /* the compaction may choose another prefix */
+            offset = SP_OFFSET(apage, slotNo);
+            oldSpace = eduom_GetObject(apage, offset, NULL, NULL);
+            newSpace = eduom_PageObjectSize(apage, objHdr, data);
+            atEnd = TRUE;
+
+            if (SP_CFREE(apage) < newSpace - oldSpace) return(eNOERROR);
+        }
+    }
+
+    /*@ the page moves to another available space list only if its category changes */
+    oldCategory = SP_LIST_CATEGORY(apage, SP_FREE(apage));
+    newCategory = SP_LIST_CATEGORY(apage, SP_FREE(apage) + oldSpace - newSpace);
+
+    if (oldCategory != newCategory && oldCategory != 0) {
+        e = om_RemoveFromAvailSpaceList(catObjForFile, pid, apage);
+        eduom_CatalogEntryChanged(catObjForFile);
+        if (e < 0) ERR(e);
+        STAT_ADD(availListRemoves, 1);
+    }
+
+    /*@ write the new object */
+    if (newSpace <= oldSpace || atEnd) {
+        (Four) eduom_PutObject(apage, offset, objHdr, data);
+
+        if (atEnd)
+            apage->header.free = offset + newSpace;
+        else
+            apage->header.unused += oldSpace - newSpace;
+    } else {
+        (Four) eduom_PutObject(apage, apage->header.free, objHdr, data);
+
+        SET_SP_OFFSET(apage, slotNo, apage->header.free);
+        apage->header.free += newSpace;
+        apage->header.unused += oldSpace;
+    }
+
+    /*@ put the page into the proper available space list */
+    if (oldCategory != newCategory && newCategory != 0) {
+        e = om_PutInAvailSpaceList(catObjForFile, pid, apage);
+        eduom_CatalogEntryChanged(catObjForFile);
+        if (e < 0) ERR(e);
+        STAT_ADD(availListPuts, 1);
+    }
+
+    /* a page with many unused bytes is compacted later */
+    eduom_DeferCompaction(catObjForFile, pid, apage, FALSE);
+
+    e = eduom_FsmSetPage(fsm, pid->pageNo, SP_FREE(apage));
+    if (e < 0) ERR(e);
+
+    e = BfM_SetDirty(pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    *done = TRUE;
+
+    return(eNOERROR);
+
+} /* eduom_ReplaceObject() */
@@ -0,0 +1,835 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_Verify.c
+ *
+ * Description :
+ *  Offline verifier of the slotted pages of a volume. The device file of an
+ *  unmounted volume is mapped into memory read-only and the pages are
+ *  checked by several threads without the buffer manager.
+ *
+ *  The verification has three passes, each of which is run in parallel.
+ *   (1) The slotted pages are searched for the catalog entries of the data
+ *       files(sm_CatOverlayForData). An object is taken as a catalog entry
+ *       if its first and last pages are slotted pages of its file.
+ *   (2) For each data file, the page chain is walked from the first page;
+ *       the nextPage/prevPage links must be symmetric, the chain must end
+ *       at the last page, and no page may be reached twice. Then each
+ *       available space list is walked; the spaceListNext/spaceListPrev
+ *       links must be symmetric, a page in the list must be a page of the
+ *       file whose free space falls into the category of the list, and no
+ *       page may be in two lists.
+ *   (3) Each page of a data file is checked by itself; the live objects
+ *       must lie within the area before 'free' without overlapping, the
+ *       bytes of the area not used by the objects must be 'unused', the
+ *       slot array must not overlap the contiguous free area, and a page
+ *       not in any available space list must have no list links. The pages
+ *       of all the page formats are checked; a page of the format other than
+ *       v1 must not be in an available space list, and the prefix of a page
+ *       with a prefix must lie before the objects. In a page of fixed-length
+ *       objects, no bit of the bitmap may be set beyond the last slot, and
+ *       'free' and 'unused' must be multiples of the cell length. A stub
+ *       left by an update must refer to an object of a page of the same
+ *       file marked as moved by an update.
+ *  A deallocated page keeps its old contents, so the slotted pages which
+ *  are not reached from a catalog entry are not checked.
+ *
+ *  The errors are printed one per line, and the throughput of the
+ *  verification is reported in GB/s. The exit status is 0 if no error is
+ *  found, 1 if an error is found, and 2 if the volume cannot be read.
+ *
+ *  usage: EduOM_Verify [-t #threads] [-m max #errors printed] device-file
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+
+
+/*@
+ * Constant Definitions
+ */
+#define VERIFY_MAXTHREADS   64
+#define VERIFY_MAXERRORS    100     /* max # of errors printed by default */
+#define VERIFY_CHUNKPAGES   256     /* # of pages taken by a thread at a time */
+#define VERIFY_NLISTS       5       /* # of available space lists of a file */
+
+
+/*
+ * Typedef for a catalog entry found in the volume
+ */
+typedef struct {
+    sm_CatOverlayForData entry;	/* copy of the catalog entry */
+    PageNo      pageNo;		/* page of the catalog object */
+    Two         slotNo;		/* slot of the catalog object */
+} VerifyFile;
+
+
+/*
+ * Typedef for a verifying thread
+ */
+typedef struct {
+    pthread_t   thread;		/* the thread */
+    VerifyFile  *files;		/* catalog entries found by the thread */
+    Four        nFiles;		/* # of entries in 'files' */
+    Four        maxFiles;	/* # of entries allocated for 'files' */
+    Four        nPages;		/* # of pages of the data files checked */
+    Four        nObjects;	/* # of live objects checked */
+} VerifyThread;
+
+
+/*@
+ * Macro Function Definitions
+ */
+/* pointer to the mapped page 'p' */
+#define VERIFY_PAGE(p)  ((SlottedPage *)(verifyVolume + (size_t)(p) * PAGESIZE))
+
+/* TRUE if 'p' is a page of the volume */
+#define VERIFY_VALID_PAGENO(p)  ((p) >= 0 && (p) < verifyNumPages)
+
+/* TRUE if the page 'p' is a slotted page */
+#define VERIFY_IS_SLOTTED(p) \
+	(VERIFY_VALID_PAGENO(p) && \
+	 (VERIFY_PAGE(p)->header.flags & PAGE_TYPE_VECTOR_MASK) == SLOTTED_PAGE_TYPE && \
+	 VERIFY_PAGE(p)->header.pid.pageNo == (p) && VERIFY_PAGE(p)->header.pid.volNo == verifyVolNo)
+
+/* TRUE if the page 'p' is a slotted page of the file 'fileId' */
+#define VERIFY_IS_PAGE_OF(p, fileId) \
+	(VERIFY_IS_SLOTTED(p) && EQUAL_FILEID(VERIFY_PAGE(p)->header.fid, fileId))
+
+
+/*@
+ * Global variables
+ */
+static char     *verifyVolume;	/* the mapped device file */
+static Four     verifyNumPages;	/* # of pages of the volume */
+static VolNo    verifyVolNo;	/* volume number kept in the pages */
+static Four     verifyNumThreads; /* # of verifying threads */
+static Four     verifyMaxErrors; /* max # of errors printed */
+static Four     verifyNumErrors; /* # of errors found */
+static Four     verifyNextWork;	/* next chunk of pages or file to verify */
+static VerifyFile *verifyFiles;	/* catalog entries of the data files */
+static Four     verifyNumFiles;	/* # of data files */
+static Four     *verifyOwner;	/* 1 + index of the file of each page; 0 if none */
+static Two      *verifyList;	/* 1 + index of the available space list of each page; 0 if none */
+
+
+/*@
+ * Function Prototypes
+ */
+static double verify_Now(void);
+static void verify_Error(PageNo, char*, ...);
+static void verify_RunThreads(VerifyThread*, void *(*)(void*));
+static void *verify_FindFiles(void*);
+static void verify_AddFile(VerifyThread*, SlottedPage*, Two);
+static Four verify_CompareFiles(const void*, const void*);
+static void *verify_CheckFiles(void*);
+static void verify_CheckChain(Four);
+static void verify_CheckAvailSpaceList(Four, Four);
+static void *verify_CheckPages(void*);
+static Four verify_CheckPage(PageNo, SlottedPage*);
+
+
+
+int main(int argc, char *argv[])
+{
+    Four    opt;		/* command line option */
+    Four    fd;			/* file descriptor of the device file */
+    Four    i, j;		/* index variable */
+    Four    nPages;		/* # of pages of the data files */
+    Four    nObjects;		/* # of live objects */
+    struct stat st;		/* status of the device file */
+    double  start;		/* time at the start of the verification */
+    double  seconds;		/* time spent by the verification */
+    VerifyThread threads[VERIFY_MAXTHREADS]; /* verifying threads */
+
+
+    verifyNumThreads = sysconf(_SC_NPROCESSORS_ONLN);
+    verifyMaxErrors = VERIFY_MAXERRORS;
+
+    while ((opt = getopt(argc, argv, "t:m:")) != -1) {
+        switch (opt) {
+          case 't': verifyNumThreads = atoi(optarg); break;
+          case 'm': verifyMaxErrors = atoi(optarg); break;
+          default: optind = argc + 1; break;
+        }
+    }
+
+    if (optind != argc - 1) {
+        fprintf(stderr, "usage: %s [-t #threads] [-m max #errors printed] device-file\n", argv[0]);
+        exit(2);
+    }
+
+    if (verifyNumThreads < 1) verifyNumThreads = 1;
+    if (verifyNumThreads > VERIFY_MAXTHREADS) verifyNumThreads = VERIFY_MAXTHREADS;
+
+    /*@ map the device file */
+    fd = open(argv[optind], O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        perror(argv[optind]);
+        exit(2);
+    }
+
+    verifyNumPages = st.st_size / PAGESIZE;
+    if (verifyNumPages == 0) {
+        fprintf(stderr, "%s: no page in the volume\n", argv[optind]);
+        exit(2);
+    }
+
+    verifyVolume = mmap(NULL, (size_t)verifyNumPages * PAGESIZE, PROT_READ, MAP_SHARED, fd, 0);
+    if (verifyVolume == MAP_FAILED) {
+        perror(argv[optind]);
+        exit(2);
+    }
+    (void) close(fd);
+
+    verifyOwner = calloc(verifyNumPages, sizeof(Four));
+    verifyList = calloc(verifyNumPages, sizeof(Two));
+    if (verifyOwner == NULL || verifyList == NULL) {
+        fprintf(stderr, "%s: not enough memory\n", argv[0]);
+        exit(2);
+    }
+
+    /* every page keeps the volume number in its page ID, the first page as well */
+    verifyVolNo = VERIFY_PAGE(0)->header.pid.volNo;
+
+    start = verify_Now();
+
+    /*@ (1) find the catalog entries */
+    verifyNextWork = 0;
+    verify_RunThreads(threads, verify_FindFiles);
+
+    for (i = 0, verifyNumFiles = 0; i < verifyNumThreads; i++) verifyNumFiles += threads[i].nFiles;
+
+    verifyFiles = malloc(MAX(verifyNumFiles, 1) * sizeof(VerifyFile));
+    if (verifyFiles == NULL) {
+        fprintf(stderr, "%s: not enough memory\n", argv[0]);
+        exit(2);
+    }
+
+    for (i = 0, verifyNumFiles = 0; i < verifyNumThreads; i++) {
+        if (threads[i].nFiles == 0) continue;
+        memcpy(&verifyFiles[verifyNumFiles], threads[i].files, threads[i].nFiles * sizeof(VerifyFile));
+        verifyNumFiles += threads[i].nFiles;
+        free(threads[i].files);
+    }
+
+    /* a file has one catalog entry */
+    qsort(verifyFiles, verifyNumFiles, sizeof(VerifyFile), verify_CompareFiles);
+    for (i = 0, j = 0; i < verifyNumFiles; i++) {
+        if (j > 0 && EQUAL_FILEID(verifyFiles[j-1].entry.fid, verifyFiles[i].entry.fid)) {
+            verify_Error(verifyFiles[i].pageNo, "slot %ld is a second catalog entry of file %ld",
+                         (long)verifyFiles[i].slotNo, (long)verifyFiles[i].entry.fid.serial);
+            continue;
+        }
+        verifyFiles[j++] = verifyFiles[i];
+    }
+    verifyNumFiles = j;
+
+    /*@ (2) walk the page chain and the available space lists of each file */
+    verifyNextWork = 0;
+    verify_RunThreads(threads, verify_CheckFiles);
+
+    /*@ (3) check each page of the files */
+    verifyNextWork = 0;
+    verify_RunThreads(threads, verify_CheckPages);
+
+    seconds = verify_Now() - start;
+
+    for (i = 0, nPages = 0, nObjects = 0; i < verifyNumThreads; i++) {
+        nPages += threads[i].nPages;
+        nObjects += threads[i].nObjects;
+    }
+
+    printf("%s: %ld pages, %ld data files, %ld pages of the files, %ld objects, %ld errors\n",
+           argv[optind], (long)verifyNumPages, (long)verifyNumFiles, (long)nPages,
+           (long)nObjects, (long)verifyNumErrors);
+    printf("verified %.3f GB in %.3f seconds with %ld threads: %.2f GB/s\n",
+           (double)verifyNumPages * PAGESIZE / 1e9, seconds, (long)verifyNumThreads,
+           (double)verifyNumPages * PAGESIZE / 1e9 / seconds);
+
+    (void) munmap(verifyVolume, (size_t)verifyNumPages * PAGESIZE);
+    free(verifyFiles);
+    free(verifyOwner);
+    free(verifyList);
+
+    return (verifyNumErrors > 0) ? 1 : 0;
+
+} /* main() */
+
+
+
+/*@================================
+ * verify_Now()
+ *================================*/
+/*
+ * Function: double verify_Now(void)
+ *
+ * Description :
+ *  Return the time of the monotonic clock in seconds.
+ */
+static double verify_Now(void)
+{
+    struct timespec ts;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (ts.tv_sec + ts.tv_nsec/1e9);
+
+} /* verify_Now() */
+
+
+
+/*@================================
+ * verify_Error()
+ *================================*/
+/*
+ * Function: void verify_Error(PageNo, char*, ...)
+ *
+ * Description :
+ *  Count an error found in the page 'pageNo' and print it unless
+ *  'verifyMaxErrors' errors have been printed.
+ */
+static void verify_Error(
+    PageNo      pageNo,		/* IN page where the error is found */
+    char        *format,	/* IN printf() format of the message */
+    ...)			/* IN arguments of the format */
+{
+    va_list     ap;		/* arguments of the format */
+
+
+    if (__atomic_fetch_add(&verifyNumErrors, 1, __ATOMIC_RELAXED) >= verifyMaxErrors) return;
+
+    flockfile(stdout);
+    printf("page %ld: ", (long)pageNo);
+    va_start(ap, format);
+    vprintf(format, ap);
+    va_end(ap);
+    printf("\n");
+    funlockfile(stdout);
+
+} /* verify_Error() */
+
+
+
+/*@================================
+ * verify_RunThreads()
+ *================================*/
+/*
+ * Function: void verify_RunThreads(VerifyThread*, void *(*)(void*))
+ *
+ * Description :
+ *  Run 'verifyNumThreads' threads of the function 'fn' and wait for them.
+ *  The threads take their work from 'verifyNextWork'. If a thread cannot
+ *  be created, the calling thread does its work.
+ */
+static void verify_RunThreads(
+    VerifyThread *threads,	/* INOUT states of the threads */
+    void        *(*fn)(void*))	/* IN function of the threads */
+{
+    Four        i;		/* index variable */
+    Boolean     created[VERIFY_MAXTHREADS]; /* TRUE if the thread is created */
+
+
+    for (i = 0; i < verifyNumThreads; i++)
+        created[i] = (pthread_create(&threads[i].thread, NULL, fn, &threads[i]) == 0) ? TRUE : FALSE;
+
+    for (i = 0; i < verifyNumThreads; i++) {
+        if (created[i])
+            (void) pthread_join(threads[i].thread, NULL);
+        else
+            (void) (*fn)(&threads[i]);
+    }
+
+} /* verify_RunThreads() */
+
+
+
+/*@================================
+ * verify_FindFiles()
+ *================================*/
+/*
+ * Function: void *verify_FindFiles(void*)
+ *
+ * Description :
+ *  Pass (1); collect the catalog entries found in the slotted pages.
+ */
+static void *verify_FindFiles(
+    void        *arg)		/* INOUT state of the thread */
+{
+    VerifyThread *t = (VerifyThread *)arg;
+    SlottedPage *apage;		/* the page */
+    Object      *obj;		/* object in the page */
+    PageNo      p, end;		/* pages of the chunk */
+    Two         i;		/* index variable */
+
+
+    t->files = NULL;
+    t->nFiles = t->maxFiles = 0;
+    t->nPages = t->nObjects = 0;
+
+    while ((p = __atomic_fetch_add(&verifyNextWork, VERIFY_CHUNKPAGES, __ATOMIC_RELAXED)) < verifyNumPages) {
+        end = MIN(p + VERIFY_CHUNKPAGES, verifyNumPages);
+
+        for (; p < end; p++) {
+            if (!VERIFY_IS_SLOTTED(p)) continue;
+
+            apage = VERIFY_PAGE(p);
+
+            /* the catalog pages have the format v1 */
+            if (SP_IS_V2(apage) || SP_IS_FIXED(apage)) continue;
+
+            if (apage->header.nSlots < 0 || apage->header.nSlots > SP_MAXSLOTS ||
+                apage->header.free < 0 || apage->header.free > (Four)(PAGESIZE - SP_FIXED)) continue;
+
+            for (i = 0; i < apage->header.nSlots; i++) {
+                if (apage->slot[-i].offset < 0 ||
+                    apage->slot[-i].offset > apage->header.free - (Four)(sizeof(ObjectHdr) + sizeof(sm_CatOverlayForData)))
+                    continue;
+
+                obj = (Object *)&(apage->data[apage->slot[-i].offset]);
+                if (obj->header.length >= (Four)sizeof(sm_CatOverlayForData)) verify_AddFile(t, apage, i);
+            }
+        }
+    }
+
+    return(NULL);
+
+} /* verify_FindFiles() */
+
+
+
+/*@================================
+ * verify_AddFile()
+ *================================*/
+/*
+ * Function: void verify_AddFile(VerifyThread*, SlottedPage*, Two)
+ *
+ * Description :
+ *  Add the object in the slot 'slotNo' to the catalog entries found by the
+ *  thread if it is a catalog entry.
+ */
+static void verify_AddFile(
+    VerifyThread *t,		/* INOUT state of the thread */
+    SlottedPage *apage,		/* IN page of the object */
+    Two         slotNo)		/* IN slot of the object */
+{
+    sm_CatOverlayForData entry;	/* the object taken as a catalog entry */
+    VerifyFile  *files;		/* reallocated 'files' */
+
+
+    memcpy(&entry, ((Object *)&(apage->data[apage->slot[-slotNo].offset]))->data, sizeof(entry));
+
+    if (entry.fid.volNo != verifyVolNo) return;
+    if (!VERIFY_IS_PAGE_OF(entry.firstPage, entry.fid) || !VERIFY_IS_PAGE_OF(entry.lastPage, entry.fid)) return;
+
+    if (t->nFiles == t->maxFiles) {
+        files = realloc(t->files, MAX(2*t->maxFiles, 16) * sizeof(VerifyFile));
+        if (files == NULL) {
+            verify_Error(apage->header.pid.pageNo, "not enough memory for the catalog entry in slot %ld", (long)slotNo);
+            return;
+        }
+        t->files = files;
+        t->maxFiles = MAX(2*t->maxFiles, 16);
+    }
+
+    t->files[t->nFiles].entry = entry;
+    t->files[t->nFiles].pageNo = apage->header.pid.pageNo;
+    t->files[t->nFiles].slotNo = slotNo;
+    t->nFiles++;
+
+} /* verify_AddFile() */
+
+
+
+/*@================================
+ * verify_CompareFiles()
+ *================================*/
+/*
+ * Function: Four verify_CompareFiles(const void*, const void*)
+ *
+ * Description :
+ *  qsort() comparison of the catalog entries by the file ID and then by
+ *  the location of the catalog object.
+ */
+static Four verify_CompareFiles(
+    const void  *a,		/* IN catalog entry */
+    const void  *b)		/* IN catalog entry */
+{
+    const VerifyFile *x = (const VerifyFile *)a;
+    const VerifyFile *y = (const VerifyFile *)b;
+
+
+    if (x->entry.fid.serial != y->entry.fid.serial) return (x->entry.fid.serial < y->entry.fid.serial) ? -1 : 1;
+    if (x->pageNo != y->pageNo) return (x->pageNo < y->pageNo) ? -1 : 1;
+
+    return (x->slotNo - y->slotNo);
+
+} /* verify_CompareFiles() */
+
+
+
+/*@================================
+ * verify_CheckFiles()
+ *================================*/
+/*
+ * Function: void *verify_CheckFiles(void*)
+ *
+ * Description :
+ *  Pass (2); walk the page chain and then the available space lists of
+ *  each file taken by the thread.
+ */
+static void *verify_CheckFiles(
+    void        *arg)		/* INOUT state of the thread */
+{
+    Four        k;		/* index of the file */
+    Four        l;		/* index of the available space list */
+
+
+    while ((k = __atomic_fetch_add(&verifyNextWork, 1, __ATOMIC_RELAXED)) < verifyNumFiles) {
+        verify_CheckChain(k);
+
+        for (l = 0; l < VERIFY_NLISTS; l++) verify_CheckAvailSpaceList(k, l);
+    }
+
+    return(NULL);
+
+} /* verify_CheckFiles() */
+
+
+
+/*@================================
+ * verify_CheckChain()
+ *================================*/
+/*
+ * Function: void verify_CheckChain(Four)
+ *
+ * Description :
+ *  Walk the page chain of the k-th file from its first page and mark the
+ *  pages reached as the pages of the file. The walk stops at a page which
+ *  is not a page of the file or is reached twice.
+ */
+static void verify_CheckChain(
+    Four        k)		/* IN index of the file */
+{
+    VerifyFile  *f = &verifyFiles[k];
+    SlottedPage *apage;		/* page of the file */
+    PageNo      p;		/* page of the file */
+    PageNo      prev;		/* page before 'p' in the chain */
+    Four        owner;		/* file of 'p' marked already */
+
+
+    for (prev = NIL, p = f->entry.firstPage; p != NIL; prev = p, p = apage->header.nextPage) {
+        if (!VERIFY_IS_PAGE_OF(p, f->entry.fid)) {
+            verify_Error(prev, "nextPage %ld is not a page of file %ld", (long)p, (long)f->entry.fid.serial);
+            break;
+        }
+
+        apage = VERIFY_PAGE(p);
+        if (apage->header.prevPage != prev && prev == NIL)
+            verify_Error(p, "prevPage is %ld but the page is the first page of file %ld",
+                         (long)apage->header.prevPage, (long)f->entry.fid.serial);
+        else if (apage->header.prevPage != prev)
+            verify_Error(p, "prevPage is %ld but the page follows page %ld in file %ld",
+                         (long)apage->header.prevPage, (long)prev, (long)f->entry.fid.serial);
+
+        owner = 0;
+        if (!__atomic_compare_exchange_n(&verifyOwner[p], &owner, k+1, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            verify_Error(p, "page is reached twice by the page chain of file %ld",
+                         (long)f->entry.fid.serial);
+            return;
+        }
+    }
+
+    if (p == NIL && prev != f->entry.lastPage)
+        verify_Error(prev, "page chain of file %ld ends here but lastPage is %ld",
+                     (long)f->entry.fid.serial, (long)f->entry.lastPage);
+
+} /* verify_CheckChain() */
+
+
+
+/*@================================
+ * verify_CheckAvailSpaceList()
+ *================================*/
+/*
+ * Function: void verify_CheckAvailSpaceList(Four, Four)
+ *
+ * Description :
+ *  Walk the l-th available space list of the k-th file and mark the pages
+ *  reached as the pages of the list. The page chain of the file must have
+ *  been walked.
+ */
+static void verify_CheckAvailSpaceList(
+    Four        k,		/* IN index of the file */
+    Four        l)		/* IN index of the list; 0 for the 10% list */
+{
+    VerifyFile  *f = &verifyFiles[k];
+    SlottedPage *apage;		/* page in the list */
+    PageNo      p;		/* page in the list */
+    PageNo      prev;		/* page before 'p' in the list */
+    Two         list;		/* list of 'p' marked already */
+
+
+    for (prev = NIL, p = (&f->entry.availSpaceList10)[l]; p != NIL; prev = p, p = apage->header.spaceListNext) {
+        if (!VERIFY_VALID_PAGENO(p) || verifyOwner[p] != k+1) {
+            verify_Error((prev == NIL) ? f->pageNo : prev,
+                         "page %ld in the %ld%% list of file %ld is not in the page chain of the file",
+                         (long)p, (long)(l+1)*10, (long)f->entry.fid.serial);
+            break;
+        }
+
+        apage = VERIFY_PAGE(p);
+        if (apage->header.spaceListPrev != prev && prev == NIL)
+            verify_Error(p, "spaceListPrev is %ld but the page is the head of the %ld%% list",
+                         (long)apage->header.spaceListPrev, (long)(l+1)*10);
+        else if (apage->header.spaceListPrev != prev)
+            verify_Error(p, "spaceListPrev is %ld but the page follows page %ld in the %ld%% list",
+                         (long)apage->header.spaceListPrev, (long)prev, (long)(l+1)*10);
+
+        if (SP_IS_V2(apage) || SP_IS_FIXED(apage))
+            verify_Error(p, "page of the format %s is in the %ld%% list",
+                         SP_IS_FIXED(apage) ? "for fixed-length objects" : "v2", (long)(l+1)*10);
+        else if (SP_AVAILSPACE_CATEGORY(SP_FREE(apage)) != l+1)
+            verify_Error(p, "page with %ld free bytes is in the %ld%% list",
+                         (long)SP_FREE(apage), (long)(l+1)*10);
+
+        list = 0;
+        if (!__atomic_compare_exchange_n(&verifyList[p], &list, l+1, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            verify_Error(p, "page is reached by the %ld%% list but is in the %ld%% list",
+                         (long)(l+1)*10, (long)list*10);
+            return;
+        }
+    }
+
+} /* verify_CheckAvailSpaceList() */
+
+
+
+/*@================================
+ * verify_CheckPages()
+ *================================*/
+/*
+ * Function: void *verify_CheckPages(void*)
+ *
+ * Description :
+ *  Pass (3); check each page of the data files in the chunks taken by the
+ *  thread.
+ */
+static void *verify_CheckPages(
+    void        *arg)		/* INOUT state of the thread */
+{
+    VerifyThread *t = (VerifyThread *)arg;
+    PageNo      p, end;		/* pages of the chunk */
+
+
+    while ((p = __atomic_fetch_add(&verifyNextWork, VERIFY_CHUNKPAGES, __ATOMIC_RELAXED)) < verifyNumPages) {
+        end = MIN(p + VERIFY_CHUNKPAGES, verifyNumPages);
+
+        for (; p < end; p++) {
+            if (verifyOwner[p] == 0) continue;
+
+            t->nObjects += verify_CheckPage(p, VERIFY_PAGE(p));
+            t->nPages++;
+        }
+    }
+
+    return(NULL);
+
+} /* verify_CheckPages() */
+
+
+
+/*@================================
+ * verify_CheckPage()
+ *================================*/
+/*
+ * Function: Four verify_CheckPage(PageNo, SlottedPage*)
+ *
+ * Description :
+ *  Check the header, the slot array, and the objects of a page of a data
+ *  file.
+ *
+ * Returns:
+ *  # of live objects of the page
+ */
+static Four verify_CheckPage(
+    PageNo      p,		/* IN page number */
+    SlottedPage *apage)		/* IN the page */
+{
+    CompactEntry entries[SP_MAXSLOTS]; /* live objects sorted by offset */
+    CompactEntry tmpEntry;	/* temporary entry used in sorting */
+    ObjectHdr   objHdr;		/* header of an object in the page */
+    ObjectHdr   fwdHdr;		/* header of the object referred to by a stub */
+    ObjectID    forward;	/* object referred to by a stub */
+    Four        minLen;		/* length of the shortest object header */
+    Four        dataStart;	/* offset of the first object of the data area */
+    Four        nEntries;	/* # of entries in 'entries' */
+    Four        used;		/* # of bytes used by the objects */
+    Four        offset;		/* offset of an object */
+    Four        len;		/* length of an object including its header */
+    Four        i, j;		/* index variable */
+
+
+    /*@ check the header */
+    if (apage->header.nSlots < 0 || apage->header.nSlots > SP_MAXSLOTS) {
+        verify_Error(p, "nSlots %ld is out of range", (long)apage->header.nSlots);
+        return(0);
+    }
+
+    if (apage->header.free < 0 || apage->header.unused < 0 || apage->header.unused > apage->header.free) {
+        verify_Error(p, "free %ld or unused %ld is out of range", (long)apage->header.free, (long)apage->header.unused);
+        return(0);
+    }
+
+    if (SP_CFREE(apage) < 0) {
+        verify_Error(p, "slot array of %ld slots overlaps the data area ending at free %ld",
+                     (long)apage->header.nSlots, (long)apage->header.free);
+        return(0);
+    }
+
+    /* the cells of a page of fixed-length objects are counted by the bitmap and 'free' */
+    if (SP_IS_FIXED(apage)) {
+        if (SP_CELLSIZE(apage) < 1 || SP_CELLSIZE(apage) > FIXED_MAXCELLSIZE) {
+            verify_Error(p, "cell length %ld is out of range", (long)SP_CELLSIZE(apage));
+            return(0);
+        }
+
+        if (apage->header.nSlots > SP_NCELLS(apage)) {
+            verify_Error(p, "nSlots %ld is more than the %ld cells", (long)apage->header.nSlots, (long)SP_NCELLS(apage));
+            return(0);
+        }
+
+        for (i = apage->header.nSlots; i < SP_NCELLS(apage); i++)
+            if (SP_CELLUSED(apage, i)) {
+                verify_Error(p, "cell %ld beyond nSlots %ld is in use", (long)i, (long)apage->header.nSlots);
+                break;
+            }
+
+        if (apage->header.free < SP_DATASTART(apage) ||
+            (apage->header.free - SP_DATASTART(apage)) % SP_CELLSIZE(apage) != 0 ||
+            apage->header.unused % SP_CELLSIZE(apage) != 0) {
+            verify_Error(p, "free %ld or unused %ld is not at a boundary of the cells of %ld bytes",
+                         (long)apage->header.free, (long)apage->header.unused, (long)SP_CELLSIZE(apage));
+            return(0);
+        }
+    }
+
+    /* the prefix of a page with a prefix is at the beginning of the data area */
+    dataStart = SP_DATASTART(apage);
+    if (SP_HAS_PREFIX(apage) &&
+        (!SP_IS_V2(apage) || SP_PREFIXLEN(apage) > SP_MAXPREFIX || dataStart > apage->header.free)) {
+        verify_Error(p, "prefix of %ld bytes is broken", (long)SP_PREFIXLEN(apage));
+        return(0);
+    }
+
+    /*@ collect the live objects */
+    minLen = SP_IS_FIXED(apage) ? SP_CELLSIZE(apage) :
+             (SP_HAS_PREFIX(apage) ? 2 : (SP_IS_V2(apage) ? 1 : (Four)sizeof(ObjectHdr)));
+    nEntries = 0;
+    for (i = 0; i < apage->header.nSlots; i++) {
+        offset = SP_OFFSET(apage, i);
+        if (offset == EMPTYSLOT) continue;
+
+        if (offset < dataStart || (SP_FORMAT(apage) == PAGE_FORMAT_V1 && offset % ALIGN != 0) ||
+            offset + minLen > apage->header.free) {
+            verify_Error(p, "offset %ld of slot %ld is out of the data area", (long)offset, (long)i);
+            continue;
+        }
+
+        len = eduom_GetObject(apage, offset, &objHdr, NULL);
+        if (objHdr.properties & P_LRGOBJ) {
+            verify_Error(p, "object in slot %ld is a large object", (long)i);
+            continue;
+        }
+
+        if (objHdr.length < 0 || objHdr.length > PAGESIZE || len < minLen || offset + len > apage->header.free) {
+            verify_Error(p, "object in slot %ld of %ld bytes at offset %ld goes beyond free %ld",
+                         (long)i, (long)objHdr.length, (long)offset, (long)apage->header.free);
+            continue;
+        }
+
+        /* a stub left by an update refers to the moved data in a page of the same file */
+        if (objHdr.properties & P_MOVED) {
+            if (objHdr.length != FORWARD_STUBLEN) {
+                verify_Error(p, "stub in slot %ld has %ld bytes", (long)i, (long)objHdr.length);
+            } else {
+                eduom_ReadData(apage, offset, 0, FORWARD_STUBLEN, (char*)&forward);
+                if (!VERIFY_VALID_PAGENO(forward.pageNo) || verifyOwner[forward.pageNo] != verifyOwner[p] ||
+                    forward.slotNo < 0 || forward.slotNo >= VERIFY_PAGE(forward.pageNo)->header.nSlots ||
+                    !IS_VALID_OBJECTID(&forward, VERIFY_PAGE(forward.pageNo)) ||
+                    SP_OFFSET(VERIFY_PAGE(forward.pageNo), forward.slotNo) == EMPTYSLOT ||
+                    SP_OFFSET(VERIFY_PAGE(forward.pageNo), forward.slotNo) + minLen > VERIFY_PAGE(forward.pageNo)->header.free)
+                    verify_Error(p, "stub in slot %ld refers to no object of the file", (long)i);
+                else {
+                    (Four) eduom_GetObject(VERIFY_PAGE(forward.pageNo), SP_OFFSET(VERIFY_PAGE(forward.pageNo), forward.slotNo), &fwdHdr, NULL);
+                    if (!(fwdHdr.properties & P_FORWARDED))
+                        verify_Error(p, "stub in slot %ld refers to an object not moved by an update", (long)i);
+                }
+            }
+        }
+
+        entries[nEntries].slotNo = i;
+        entries[nEntries].offset = offset;
+        entries[nEntries].len = len;
+
+        /* insertion sort; the objects are usually placed in the order of slots */
+        for (j = nEntries; j > 0 && entries[j-1].offset > entries[j].offset; j--) {
+            tmpEntry = entries[j-1]; entries[j-1] = entries[j]; entries[j] = tmpEntry;
+        }
+        nEntries++;
+    }
+
+    /*@ the objects must not overlap and the remaining bytes are unused */
+    for (i = 0, used = dataStart; i < nEntries; i++) {
+        if (i > 0 && entries[i-1].offset + entries[i-1].len > entries[i].offset)
+            verify_Error(p, "objects in slot %ld and slot %ld overlap",
+                         (long)entries[i-1].slotNo, (long)entries[i].slotNo);
+        used += entries[i].len;
+    }
+
+    if (used <= apage->header.free && apage->header.free - used != apage->header.unused)
+        verify_Error(p, "unused is %ld but %ld bytes before free %ld are not used by the objects",
+                     (long)apage->header.unused, (long)(apage->header.free - used), (long)apage->header.free);
+
+    /*@ a page not in an available space list has no list links */
+    if (verifyList[p] == 0 && (apage->header.spaceListPrev != NIL || apage->header.spaceListNext != NIL))
+        verify_Error(p, "page is in no available space list but spaceListPrev is %ld and spaceListNext is %ld",
+                     (long)apage->header.spaceListPrev, (long)apage->header.spaceListNext);
+
+    return(nEntries);
+
+} /* verify_CheckPage() */
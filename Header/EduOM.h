@@ -37,10 +37,38 @@
 /* Interface Function Prototypes */
 Four EduOM_CompactPage(SlottedPage*, Two);
 Four EduOM_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, ObjectID*);
+Four EduOM_CreateObjects(ObjectID*, ObjectID*, Four, ObjectHdr*, Four*, char**, ObjectID*);
 Four EduOM_DestroyObject(ObjectID*, ObjectID*, Pool*, DeallocListElem*);
+Four EduOM_DestroyObjects(ObjectID*, Four, ObjectID*, Pool*, DeallocListElem*);
 Four EduOM_NextObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
 Four EduOM_PrevObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
 Four EduOM_ReadObject(ObjectID*, Four, Four, void*);
+Four EduOM_ReadObjects(Four, ObjectID*, Four*, Four*, void**, Four*);
+Four EduOM_UpdateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, Pool*, DeallocListElem*);
+Four EduOM_WriteObject(ObjectID*, ObjectID*, Four, Four, char*, Pool*, DeallocListElem*);
+Four EduOM_OpenScan(ObjectID*, ObjectID*, Four, EduOM_ScanCursor*);
+Four EduOM_FetchBatch(EduOM_ScanCursor*, Four, ObjectID*, ObjectHdr*);
+Four EduOM_CloseScan(EduOM_ScanCursor*);
+Four EduOM_SetScanReadAhead(EduOM_ScanCursor*, Four);
+Four EduOM_ParallelScan(ObjectID*, Four, Four, EduOM_ScanCallback, void**);
+Four EduOM_EnableBufferFront(Four);
+Four EduOM_DisableBufferFront(void);
+Four EduOM_MapVolume(Four, char**, Four, Four*);
+Four EduOM_UnmapVolume(Four);
+Four EduOM_EnablePrefetch(Four, char**, Four*);
+Four EduOM_DisablePrefetch(Four);
+Four EduOM_InvalidateCatalogCache(ObjectID*);
+Four EduOM_SetPlacementPolicy(ObjectID*, Four);
+Four EduOM_SetCompactionPolicy(Four, Four, Four);
+Four EduOM_RunDeferredCompaction(Four, Four*);
+Four EduOM_SetPageFormat(ObjectID*, Four);
+Four EduOM_SetFixedLength(ObjectID*, Four);
+Four EduOM_PinObject(ObjectID*, const char**, Four*, EduOM_PinHandle*);
+Four EduOM_UnpinObject(EduOM_PinHandle*);
+Four EduOM_GetStats(EduOM_Stats*);
+Four EduOM_ResetStats(void);
+Four EduOM_DumpLatency(FILE*);
+Four EduOM_ResetLatency(void);
 
 Four OM_DumpObject(ObjectID *);
 
@@ -26,6 +26,10 @@
 #define _EDUOM_INTERNAL_H_
 
 
+#include "Util_varArray.h"
+#include "Util_pool.h"
+
+
 /*@
  * Type Definitions
  */
@@ -42,6 +46,16 @@ typedef struct {
 	Unique  unique;     /* unique number */
 } SlottedPageSlot;
 
+/*
+ * define a type for a slot of a page of the format v2
+ * The unique number is kept in two halves so that a slot takes 6 bytes.
+ */
+typedef struct {
+	Two     offset;     /* points to actual storage area */
+	UTwo    uniqueLow;  /* low 16 bits of the unique number */
+	UTwo    uniqueHigh; /* high 16 bits of the unique number */
+} SlottedPageSlotV2;
+
 
 /*
  * Typedef for the header of slotted page
@@ -75,6 +89,335 @@ typedef struct {
 } SlottedPage;
 
 
+/*
+ * Page formats of the pages of data files
+ * A page of the format v2 has the bit SP_FORMAT_V2 in 'flags' next to the
+ * page type vector. It has the same header as the other pages, but its slot
+ * array is made of SlottedPageSlotV2, and its objects are not aligned and
+ * have variable-length headers:
+ *   varint(length << 1 | x) [varint(properties) varint(tag)]
+ * where x is 1 if properties or tag is not 0, and varint() is the base 128
+ * encoding, 7 bits a byte, the lowest first. The pages of the format v2 are
+ * not kept in the available space lists, so that the other modules never
+ * put objects into them.
+ *
+ * A page of the format with a prefix is a page of the format v2 which has
+ * also the bit SP_FORMAT_PREFIX. Its data area begins with the prefix shared
+ * by the objects of the page, and an object keeps only the rest of its data
+ * after the # of its first bytes equal to the prefix:
+ *   prefix:  length(1 byte) bytes
+ *   object:  varint(length << 1 | x) [varint(properties) varint(tag)] shared(1 byte) suffix
+ * The prefix is taken from the first object put into an empty data area and
+ * is chosen again whenever the page is compacted.
+ *
+ * A page of the format for fixed-length objects has the bit SP_FORMAT_FIXED
+ * and no slot array. Its data area is an array of cells of the same length
+ * with an occupancy bitmap before them:
+ *   unique(4 bytes) cellSize(2 bytes) bitmap cell cell ...
+ * The object of the slot number i is in the i-th cell if the i-th bit is
+ * set, and it has no header. All the objects of the page share the unique
+ * number of the page. 'nSlots' is one more than the highest cell in use, and
+ * 'free' and 'unused' are kept as in the other formats: the cells up to
+ * 'free' are in use or count in 'unused', and the cells after 'free' are the
+ * contiguous free area.
+ */
+#define PAGE_FORMAT_V1      1       /* 8-byte slots and object headers; aligned objects */
+#define PAGE_FORMAT_V2      2       /* 6-byte slots and 1~8-byte object headers */
+#define PAGE_FORMAT_PREFIX  3       /* the format v2 with a prefix shared by the objects */
+#define PAGE_FORMAT_FIXED   4       /* cells of fixed-length objects; no slots and headers */
+
+#define SP_FORMAT_V2        0x10    /* bit of 'flags' set in the pages of the format v2 */
+#define SP_FORMAT_PREFIX    0x20    /* bit of 'flags' set in the pages with a prefix */
+#define SP_FORMAT_FIXED     0x40    /* bit of 'flags' set in the pages of fixed-length objects */
+#define SP_MAXPREFIX        64      /* max length of the prefix of a page */
+#define SP_PREFIXCANDIDATES 4       /* # of objects tried as the prefix in a compaction */
+#define FIXED_HDRSIZE       6       /* unique and cellSize before the bitmap */
+#define FIXED_AREA          ((CONSTANT_CASTING_TYPE)(PAGESIZE - SP_FIXED - FIXED_HDRSIZE)) /* bitmap and cells */
+/* max length of the fixed-length objects; a page holds at least one cell(see FIXED_NCELLS) */
+#define FIXED_MAXCELLSIZE   MIN((Four)(FIXED_AREA - 2), (Four)(LRGOBJ_THRESHOLD - LRGOBJ_THRESHOLD % ALIGN))
+
+
+/*
+ * Typedef for an entry used in compacting a slotted page
+ */
+typedef struct {
+	Two     slotNo;     /* slot of the object */
+	Two     offset;     /* offset of the object in the data area */
+	Two     len;        /* length of the object including its header */
+} CompactEntry;
+
+
+/* size classes of the objects under PLACEMENT_SIZECLASS */
+#define SIZECLASS_NCLASSES  4   /* # of size classes; see SIZECLASS() */
+
+/*
+ * Typedef for the free space map of a data file
+ * Each page of the file is summarized by one byte, the size of its free space
+ * in units of FSM_UNIT bytes. The bytes are the leaves of a max tree stored in
+ * an array: tree[1] is the root, the children of tree[i] are tree[2i] and
+ * tree[2i+1], and the leaf of page p is tree[nLeaves + p - basePage].
+ * Under PLACEMENT_SIZECLASS there is one tree per size class, and a page has
+ * a non-zero leaf only in the tree of its class; tree 0 holds the pages of
+ * no class, i.e., the empty pages.
+ * Under PLACEMENT_DEFAULT the page last allocated by an insertion is kept
+ * with its free bytes as the append page, so that an append is put into it
+ * without searching the tree.
+ */
+typedef struct {
+	ObjectID    catObjForFile;  /* catalog object of the data file */
+	FileID      fid;            /* data file described by the map */
+	ShortPageID firstPage;      /* first page of the data file */
+	PageNo      basePage;       /* page described by the first leaf */
+	Four        nLeaves;        /* # of leaves; a power of 2 */
+	Four        nTrees;         /* 1, or SIZECLASS_NCLASSES+1 under PLACEMENT_SIZECLASS */
+	VarArray    tree[SIZECLASS_NCLASSES+1]; /* UOne arrays of 2*nLeaves entries */
+	VarArray    pageClass;      /* UOne array of nLeaves entries; size class of each page */
+	PageNo      insertPage[SIZECLASS_NCLASSES+1]; /* page last inserted into per class */
+	PageNo      appendPage;     /* page last allocated by an insertion; NIL if none */
+	Four        format;         /* format of the new pages; that of the first page */
+	Four        cellSize;       /* length of the objects if the format is PAGE_FORMAT_FIXED */
+	Four        appendFree;     /* free space of appendPage recorded last */
+	Boolean     valid;          /* TRUE if the map describes the file; FALSE if the entry is empty */
+} FreeSpaceMap;
+
+
+/*
+ * Typedef for the compaction policy set by EduOM_SetCompactionPolicy()
+ * The cost of a compaction is estimated as the bytes of the objects in the
+ * data area, which is an upper bound of the bytes moved, and its benefit as
+ * the unused bytes turned into the contiguous free area.
+ */
+typedef struct {
+	Four        budget;         /* max bytes moved by the compactions of an operation */
+	Four        maxCost;        /* max % of the cost to the benefit of a compaction */
+	Four        deferThreshold; /* % of unused bytes in the free space queueing a page; 0 if off */
+} CompactPolicy;
+
+
+/*
+ * Typedef for a page queued for the deferred compaction
+ */
+typedef struct {
+	ObjectID    catObjForFile;  /* catalog object of the data file of the page */
+	PageID      pid;            /* page to be compacted */
+} DeferredCompaction;
+
+
+/*
+ * Typedef for the placement policy of a data file
+ */
+typedef struct {
+	ObjectID    catObjForFile;  /* catalog object of the data file */
+	FileID      fid;            /* data file using the policy */
+	Four        policy;         /* PLACEMENT_SIZECLASS; an empty entry has PLACEMENT_DEFAULT */
+} PlacementEntry;
+
+
+/*
+ * Typedef for the cached catalog entry of a data file
+ * The entry is copied from the catalog object so that the operations need
+ * not fix the catalog page. 'fid', 'eff', and 'firstPage' do not change
+ * while the file exists; the other fields are read again after EduOM has
+ * changed the catalog object.
+ */
+typedef struct {
+	ObjectID    catObjForFile;  /* catalog object of the data file */
+	sm_CatOverlayForData entry; /* copy of the catalog entry */
+	Boolean     stale;          /* TRUE if 'entry' must be read again */
+	Four        lastUsed;       /* time of last use; 0 if the descriptor is empty */
+} CatalogDescriptor;
+
+
+/*
+ * Typedef for the scan cursor
+ * The cursor keeps the page it is positioned on pinned between the calls of
+ * EduOM_FetchBatch() so that a full-file scan pins each page only once.
+ * If the read-ahead is enabled, the pages following the cursor in the scan
+ * direction within its extent are advised to be read; the pages advised are
+ * 'raFirst' through 'raLast'.
+ */
+typedef struct {
+	ObjectID    catObjForFile;  /* catalog object of the scanned data file */
+	Four        direction;      /* FORWARD or BACKWARD */
+	PageID      pid;            /* page the cursor is positioned on */
+	SlottedPage *apage;         /* buffer holding 'pid'; NULL if not pinned */
+	Two         slotNo;         /* last slot returned from 'pid' */
+	Boolean     eos;            /* TRUE if the scan has reached the end */
+	Four        raMaxWindow;    /* max # of pages read ahead; 0 if disabled */
+	Four        raWindow;       /* # of pages to keep read ahead of the cursor */
+	Four        raMoves;        /* # of sequential page moves in a row */
+	Four        raHits;         /* # of moves onto a page read ahead since the window changed */
+	ShortPageID raFirst;        /* lowest page read ahead; NIL if none */
+	ShortPageID raLast;         /* highest page read ahead */
+} EduOM_ScanCursor;
+
+
+/*
+ * Typedef for an entry of the buffer front end
+ * A page cached in the front end stays fixed in the buffer manager once, and
+ * the fixes of the readers are counted in 'pinCount' with atomic operations.
+ */
+typedef struct {
+	PageID      pid;            /* page cached in the entry; pageNo NIL if empty */
+	SlottedPage *apage;         /* buffer holding 'pid' */
+	Four        pinCount;       /* # of fixes through the front end */
+	Four        refBit;         /* set on a fix; cleared by the eviction clock */
+	Four        next;           /* next entry of the same hash bucket; NIL if the last */
+} BufferFrontEntry;
+
+
+/*
+ * Typedef for the handle of a pinned object
+ * The page holding the object stays pinned until EduOM_UnpinObject() is
+ * called with the handle.
+ */
+typedef struct {
+	PageID      pid;            /* page holding the pinned object */
+	SlottedPage *apage;         /* buffer holding 'pid'; NULL if not pinned */
+	BufferFrontEntry *entry;    /* entry of the front end; NULL if fixed in BfM */
+	char        *copy;          /* data decoded from a page with a prefix; NULL if none */
+} EduOM_PinHandle;
+
+
+/*
+ * Typedef for the function called for each object by EduOM_ParallelScan()
+ */
+typedef Four (*EduOM_ScanCallback)(Four, ObjectID*, ObjectHdr*, const char*, void*);
+
+
+/* operations whose calls and pins are counted */
+#define STAT_OP_CREATE      0   /* EduOM_CreateObject(), EduOM_CreateObjects() */
+#define STAT_OP_DESTROY     1   /* EduOM_DestroyObject(), EduOM_DestroyObjects() */
+#define STAT_OP_READ        2   /* EduOM_ReadObject(), EduOM_ReadObjects(), EduOM_PinObject() */
+#define STAT_OP_NEXT        3   /* EduOM_NextObject() */
+#define STAT_OP_PREV        4   /* EduOM_PrevObject() */
+#define STAT_OP_SCAN        5   /* EduOM_OpenScan(), EduOM_FetchBatch(), EduOM_ParallelScan() */
+#define STAT_OP_UPDATE      6   /* EduOM_UpdateObject(), EduOM_WriteObject() */
+#define STAT_OP_COMPACT     7   /* EduOM_RunDeferredCompaction() */
+#define STAT_OP_FILE        8   /* EduOM_SetPlacementPolicy(), EduOM_SetPageFormat(), EduOM_SetFixedLength() */
+#define STAT_NOPS           9
+
+/*
+ * Typedef for the operation counters returned by EduOM_GetStats()
+ * A pin is a fix of a page in the buffer, including the fixes of the catalog
+ * pages and the fixes through the buffer front end. A new counter must also
+ * be summed by eduom_AddStats() in EduOM_Stats.c.
+ */
+typedef struct {
+	unsigned long calls[STAT_NOPS];     /* # of calls of each operation */
+	unsigned long pins[STAT_NOPS];      /* # of pins done by each operation */
+	unsigned long compactions;          /* # of calls of EduOM_CompactPage() */
+	unsigned long compactBytes;         /* # of bytes moved by the compactions */
+	unsigned long pageAllocs;           /* # of pages allocated to the files */
+	unsigned long pageDeallocs;         /* # of pages put in the dealloc list */
+	unsigned long availListPuts;        /* # of insertions into an available space list */
+	unsigned long availListRemoves;     /* # of removals from an available space list */
+	unsigned long spaceMisses;          /* # of insertions finding no page with enough space */
+	unsigned long appendHits;           /* # of insertions put into the append page of the map */
+	unsigned long destroyLastSlot;      /* # of destroys of the object in the last slot */
+	unsigned long uniques;              /* # of unique numbers assigned */
+	unsigned long uniqueRefills;        /* # of ranges of unique numbers reserved */
+	unsigned long scanPageMoves;        /* # of moves to the next/previous page in scans */
+	unsigned long compactRefusals;      /* # of compactions refused by the compaction policy */
+	unsigned long compactDeferrals;     /* # of pages queued for the deferred compaction */
+	unsigned long deferredCompactions;  /* # of compactions done by EduOM_RunDeferredCompaction() */
+	unsigned long updatesInPlace;       /* # of updates done in the page holding the data */
+	unsigned long forwards;             /* # of updates moving the data to another page */
+	unsigned long forwardReads;         /* # of stubs followed to the moved data */
+	unsigned long prefetchPages;        /* # of pages advised to be read ahead */
+	unsigned long prefetchHits;         /* # of scan moves onto a page read ahead */
+} EduOM_Stats;
+
+
+/*
+ * Typedef for the counters of a thread
+ * Each thread counts into its own copy without any synchronization; the
+ * copies are linked so that EduOM_GetStats() can sum them.
+ */
+typedef struct eduom_ThreadStats {
+	EduOM_Stats stats;          /* counters of the thread */
+	Four        curOp;          /* operation the pins are counted for */
+	struct eduom_ThreadStats *prev; /* previous copy in the list of the threads */
+	struct eduom_ThreadStats *next; /* next copy in the list of the threads */
+} ThreadStats;
+
+
+/* operations whose latency is recorded */
+#define LAT_CREATEOBJECT    0
+#define LAT_CREATEOBJECTS   1
+#define LAT_DESTROYOBJECT   2
+#define LAT_DESTROYOBJECTS  3
+#define LAT_READOBJECT      4
+#define LAT_READOBJECTS     5
+#define LAT_PINOBJECT       6
+#define LAT_NEXTOBJECT      7
+#define LAT_PREVOBJECT      8
+#define LAT_COMPACTPAGE     9
+#define LAT_OPENSCAN        10
+#define LAT_FETCHBATCH      11
+#define LAT_PARALLELSCAN    12
+#define LAT_UPDATEOBJECT    13
+#define LAT_WRITEOBJECT     14
+#define LAT_GETTRAIN_HIT    15  /* BfM_GetTrain() of a page in the buffer */
+#define LAT_GETTRAIN_MISS   16  /* BfM_GetTrain() reading the page from the disk */
+#define LAT_NOPS            17
+
+#ifdef EDUOM_LATENCY
+/*
+ * Typedef for the timer of a function whose latency is recorded
+ * The timer is a local variable of the function, and its latency is recorded
+ * when the variable goes out of scope.
+ */
+typedef struct {
+	Four          op;           /* operation measured */
+	unsigned long start;        /* clock at the start of the operation */
+} LatencyTimer;
+#endif
+
+
+/*@
+ * Constant Definitions
+ */
+/* free space map */
+#define FSM_UNIT        16      /* bytes represented by one unit of the summary */
+#define FSM_MINLEAVES   16      /* minimum # of leaves of a free space map */
+#define FSM_INITFILES   16      /* initial # of entries of the table of the free space maps */
+
+/* placement policies */
+#define PLACEMENT_DEFAULT   0   /* objects of all sizes share the pages */
+#define PLACEMENT_SIZECLASS 1   /* objects are put into the pages of their size class */
+#define PLACEMENT_MAXFILES  64  /* max # of files having a non-default policy */
+
+/* compaction policy */
+#define COMPACT_NOLIMIT     (-1)    /* no limit on the budget or the cost of the compactions */
+#define COMPACT_MAXDEFERRED 256     /* max # of pages queued for the deferred compaction */
+
+/* catalog cache */
+#define CATCACHE_MAXFILES   64  /* # of catalog entries kept in main memory */
+
+/* parallel scan */
+#define PSCAN_MAXTHREADS    64  /* max # of worker threads of a parallel scan */
+#define PSCAN_MINMOVED      16  /* # of stubs a worker keeps before growing its array */
+
+/* buffer front end */
+#define BFRONT_NSHARDS      64  /* # of shards of the front end; a power of 2 */
+
+/* mapped volumes */
+#define MAPPED_MAXVOLUMES   8   /* max # of volumes mapped at the same time */
+#define MAPPED_RANDOM       0   /* the pages of the mapped volume are read randomly */
+#define MAPPED_SEQUENTIAL   1   /* the pages of the mapped volume are read sequentially */
+
+/* read-ahead */
+#define PREFETCH_MAXVOLUMES 8   /* max # of volumes opened for the read-ahead at the same time */
+#define SCAN_RA_MAXWINDOW   64  /* upper bound of the read-ahead window of a scan cursor */
+#define SCAN_RA_MINWINDOW   2   /* initial read-ahead window of a scan cursor */
+#define SCAN_RA_TRIGGER     2   /* # of sequential page moves before the read-ahead */
+
+/* scan directions */
+#define FORWARD     0
+#define BACKWARD    1
+
+
 /*@
  * Macro Function Definitions
  */
@@ -95,7 +438,208 @@ typedef struct {
  * Returns: (Four) size of contiguous free area
  */
 #define SP_CFREE(p) \
-(PAGESIZE - SP_FIXED - (p)->header.free - ((p)->header.nSlots-1)*((CONSTANT_CASTING_TYPE)sizeof(SlottedPageSlot)))
+(SP_IS_FIXED(p) ? SP_DATASTART(p) + SP_NCELLS(p)*SP_CELLSIZE(p) - (p)->header.free : \
+ PAGESIZE - (CONSTANT_CASTING_TYPE)sizeof(SlottedPageHdr) - (p)->header.free - (p)->header.nSlots*SP_SLOTSIZE(p))
+
+/* maximum number of slots in a slotted page of any format */
+#define SP_MAXSLOTS     ((CONSTANT_CASTING_TYPE)((PAGESIZE-sizeof(SlottedPageHdr))/sizeof(SlottedPageSlotV2)))
+
+/* Macro: SP_IS_V2(p)
+ * Description: check whether the page has the format v2
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: TRUE(1) if the page has the format v2, otherwise FALSE(0)
+ */
+#define SP_IS_V2(p)     (((p)->header.flags & SP_FORMAT_V2) ? TRUE : FALSE)
+
+/* Macro: SP_IS_FIXED(p)
+ * Description: check whether the page has the format for fixed-length objects
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: TRUE(1) if the page is made of cells, otherwise FALSE(0)
+ */
+#define SP_IS_FIXED(p)  (((p)->header.flags & SP_FORMAT_FIXED) ? TRUE : FALSE)
+
+/* Macro: SP_HAS_PREFIX(p)
+ * Description: check whether the page has the format with a prefix
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: TRUE(1) if the page has a prefix, otherwise FALSE(0)
+ */
+#define SP_HAS_PREFIX(p) (((p)->header.flags & SP_FORMAT_PREFIX) ? TRUE : FALSE)
+
+/* Macro: SP_FORMAT(p)
+ * Description: return the format of the page
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: (Four) PAGE_FORMAT_V1, PAGE_FORMAT_V2, PAGE_FORMAT_PREFIX, or PAGE_FORMAT_FIXED
+ */
+#define SP_FORMAT(p) \
+	(SP_IS_FIXED(p) ? PAGE_FORMAT_FIXED : \
+	 (SP_HAS_PREFIX(p) ? PAGE_FORMAT_PREFIX : (SP_IS_V2(p) ? PAGE_FORMAT_V2 : PAGE_FORMAT_V1)))
+
+/* Macro: FORMAT_FLAGS(f)
+ * Description: return the bits of 'flags' of the pages of the given format
+ * Parameter:
+ *  Four f              : one of PAGE_FORMAT_*
+ * Returns: (One) bits of the format
+ */
+#define FORMAT_FLAGS(f) \
+	(((f) == PAGE_FORMAT_V1) ? 0 : (((f) == PAGE_FORMAT_V2) ? SP_FORMAT_V2 : \
+	 (((f) == PAGE_FORMAT_FIXED) ? SP_FORMAT_FIXED : (SP_FORMAT_V2 | SP_FORMAT_PREFIX))))
+
+/* Macro: FORMAT_SLOTSIZE(f)
+ * Description: return the size of a slot of the pages of the given format
+ * Parameter:
+ *  Four f              : one of PAGE_FORMAT_*
+ * Returns: (CONSTANT_CASTING_TYPE) size of a slot; 0 for the fixed-length objects
+ */
+#define FORMAT_SLOTSIZE(f) \
+	((CONSTANT_CASTING_TYPE)(((f) == PAGE_FORMAT_V1) ? sizeof(SlottedPageSlot) : \
+	                         (((f) == PAGE_FORMAT_FIXED) ? 0 : sizeof(SlottedPageSlotV2))))
+
+/* Macro: FIXED_NCELLS(c)
+ * Description: return the # of cells of a page of fixed-length objects
+ * Parameter:
+ *  Four c              : length of the objects
+ * Returns: (Four) # of cells; at most SP_MAXSLOTS
+ */
+#define FIXED_NCELLS(c) \
+	MIN((Four)SP_MAXSLOTS, (Four)((8*(FIXED_AREA - 1)) / (8*(c) + 1)))
+
+/* Macro: SP_FIXEDUNIQUE(p)
+ * Description: return the unique number shared by the objects of a page of fixed-length objects
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: (Unique) lvalue of the unique number
+ */
+#define SP_FIXEDUNIQUE(p) (*(Unique*)&(p)->data[0])
+
+/* Macro: SP_CELLSIZE(p)
+ * Description: return the length of the objects of a page of fixed-length objects
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: (Two) lvalue of the length of a cell
+ */
+#define SP_CELLSIZE(p)  (*(Two*)&(p)->data[4])
+
+/* Macro: SP_NCELLS(p)
+ * Description: return the # of cells of a page of fixed-length objects
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: (Four) # of cells
+ */
+#define SP_NCELLS(p)    FIXED_NCELLS(SP_CELLSIZE(p))
+
+/* Macro: SP_BITMAP(p)
+ * Description: return the occupancy bitmap of a page of fixed-length objects
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: (UOne*) pointer to the bitmap
+ */
+#define SP_BITMAP(p)    ((UOne*)&(p)->data[FIXED_HDRSIZE])
+
+/* Macro: SP_CELLUSED(p, i)
+ * Description: check whether the i-th cell of a page of fixed-length objects is in use
+ * Parameters:
+ *  SlottedPage *p      : pointer to the page
+ *  Two i               : slot number, i.e., cell number
+ * Returns: TRUE(1) if the cell holds an object, otherwise FALSE(0)
+ */
+#define SP_CELLUSED(p, i) ((SP_BITMAP(p)[(i) >> 3] >> ((i) & 7)) & 1)
+
+/* Macro: SP_PREFIXLEN(p)
+ * Description: return the length of the prefix of a page with a prefix
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: (Four) length of the prefix
+ */
+#define SP_PREFIXLEN(p) ((Four)(UOne)(p)->data[0])
+
+/* Macro: SP_PREFIX(p)
+ * Description: return the prefix of a page with a prefix
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: (char*) pointer to the prefix
+ */
+#define SP_PREFIX(p)    (&(p)->data[1])
+
+/* Macro: SP_DATASTART(p)
+ * Description: return the offset of the first object of the data area
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: (Four) offset of the first cell, 1 + length of the prefix, or 0
+ */
+#define SP_DATASTART(p) \
+	(SP_IS_FIXED(p) ? FIXED_HDRSIZE + (SP_NCELLS(p) + 7) / 8 : (SP_HAS_PREFIX(p) ? 1 + SP_PREFIXLEN(p) : 0))
+
+/* Macro: SP_SLOTSIZE(p)
+ * Description: return the size of a slot of the page
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: (CONSTANT_CASTING_TYPE) size of a slot
+ */
+#define SP_SLOTSIZE(p)  FORMAT_SLOTSIZE(SP_FORMAT(p))
+
+/* Macro: SP_SLOTV2(p, i)
+ * Description: return the i-th slot of a page of the format v2
+ * Parameters:
+ *  SlottedPage *p      : pointer to the page
+ *  Two i               : slot number
+ * Returns: (SlottedPageSlotV2*) pointer to the slot
+ */
+#define SP_SLOTV2(p, i) (((SlottedPageSlotV2*)((char*)(p) + PAGESIZE)) - 1 - (i))
+
+/* Macro: SP_OFFSET(p, i)
+ * Description: return the offset in the i-th slot of the page of any format
+ * Parameters:
+ *  SlottedPage *p      : pointer to the page
+ *  Two i               : slot number
+ * Returns: (Two) offset of the object in the data area, or EMPTYSLOT
+ */
+#define SP_OFFSET(p, i) \
+	(SP_IS_FIXED(p) ? (SP_CELLUSED(p, i) ? SP_DATASTART(p) + (i)*SP_CELLSIZE(p) : EMPTYSLOT) : \
+	 (SP_IS_V2(p) ? SP_SLOTV2(p, i)->offset : (p)->slot[-(i)].offset))
+
+/* Macro: SP_UNIQUE(p, i)
+ * Description: return the unique number in the i-th slot of the page of any format
+ * Parameters:
+ *  SlottedPage *p      : pointer to the page
+ *  Two i               : slot number
+ * Returns: (Unique) unique number of the object
+ */
+#define SP_UNIQUE(p, i) \
+	(SP_IS_FIXED(p) ? SP_FIXEDUNIQUE(p) : \
+	 (SP_IS_V2(p) ? ((Unique)SP_SLOTV2(p, i)->uniqueLow | ((Unique)SP_SLOTV2(p, i)->uniqueHigh << 16)) : \
+	  (p)->slot[-(i)].unique))
+
+/* Macro: SET_SP_OFFSET(p, i, o)
+ * Description: set the offset in the i-th slot of the page of any format
+ * Parameters:
+ *  SlottedPage *p      : (OUT) pointer to the page
+ *  Two i               : slot number
+ *  Two o               : offset of the object in the data area, or EMPTYSLOT
+ * In a page of fixed-length objects, only the bit of the cell is set or cleared.
+ */
+#define SET_SP_OFFSET(p, i, o) \
+	(SP_IS_FIXED(p) ? \
+	 (SP_BITMAP(p)[(i) >> 3] = ((o) == EMPTYSLOT) ? (SP_BITMAP(p)[(i) >> 3] & ~(1 << ((i) & 7))) : \
+	                                                (SP_BITMAP(p)[(i) >> 3] | (1 << ((i) & 7)))) : \
+	 (SP_IS_V2(p) ? (SP_SLOTV2(p, i)->offset = (o)) : ((p)->slot[-(i)].offset = (o))))
+
+/* Macro: SET_SP_UNIQUE(p, i, u)
+ * Description: set the unique number in the i-th slot of the page of any format
+ * Parameters:
+ *  SlottedPage *p      : (OUT) pointer to the page
+ *  Two i               : slot number
+ *  Unique u            : unique number of the object
+ * In a page of fixed-length objects, the objects share the unique number of
+ * the page, so nothing is set.
+ */
+#define SET_SP_UNIQUE(p, i, u) \
+	(SP_IS_FIXED(p) ? 0 : \
+	 (SP_IS_V2(p) ? (SP_SLOTV2(p, i)->uniqueLow = (UTwo)(u), SP_SLOTV2(p, i)->uniqueHigh = (UTwo)((Unique)(u) >> 16)) : \
+	  ((p)->slot[-(i)].unique = (u))))
 
 #define SP_10SIZE       ((CONSTANT_CASTING_TYPE)((PAGESIZE-SP_FIXED)/10))
 #define SP_20SIZE       ((CONSTANT_CASTING_TYPE)(((PAGESIZE-SP_FIXED)/10L)*2))
@@ -104,10 +648,154 @@ typedef struct {
 #define SP_50SIZE       ((CONSTANT_CASTING_TYPE)((PAGESIZE-SP_FIXED)/2))
 
 
+/* Macro: SP_AVAILSPACE_CATEGORY(f)
+ * Description: return the available space list a page belongs to
+ * Parameter:
+ *  Four f              : size of total free area of the page
+ * Returns: (Four) 0 if the page is in no list, 1 ~ 5 for availSpaceList10 ~ 50
+ */
+#define SP_AVAILSPACE_CATEGORY(f) \
+	((((f)*10)/(CONSTANT_CASTING_TYPE)(PAGESIZE-SP_FIXED) >= 5) ? 5 : \
+	 (((f)*10)/(CONSTANT_CASTING_TYPE)(PAGESIZE-SP_FIXED)))
+
+/* Macro: SP_LIST_CATEGORY(p, f)
+ * Description: return the available space list the page should belong to
+ * Parameters:
+ *  SlottedPage *p      : pointer to the page
+ *  Four f              : size of total free area of the page
+ * Returns: (Four) SP_AVAILSPACE_CATEGORY(f), or 0 for a page of the format other than v1
+ */
+#define SP_LIST_CATEGORY(p, f) \
+	(((p)->header.flags & (SP_FORMAT_V2 | SP_FORMAT_FIXED)) ? 0 : SP_AVAILSPACE_CATEGORY(f))
+
+/* Macro: FSM_SUMMARY(f)
+ * Description: return the one byte summary of the free space in the free space map
+ * Parameter:
+ *  Four f              : size of free space
+ * Returns: (UOne) free space in units of FSM_UNIT
+ */
+#define FSM_SUMMARY(f)  ((UOne)(((f) <= 0) ? 0 : (f)/FSM_UNIT))
+
+/* Macro: SIZECLASS(l)
+ * Description: return the size class of an object under PLACEMENT_SIZECLASS
+ * Parameter:
+ *  Four l              : aligned length of the object
+ * Returns: (Four) 1 ~ SIZECLASS_NCLASSES
+ */
+#define SIZECLASS(l) \
+	(((l) <= 64) ? 1 : ((l) <= 256) ? 2 : ((l) <= 1024) ? 3 : 4)
+
+
+/* Macro: THREAD_STATS()
+ * Description: return the counters of the calling thread; they are allocated on the first use
+ * Returns: (ThreadStats*) counters of the thread
+ */
+#define THREAD_STATS() \
+	((eduom_threadStats != NULL) ? eduom_threadStats : eduom_AllocThreadStats())
+
+/* Macro: STAT_ADD(field, n)
+ * Description: add 'n' to a counter of the calling thread
+ * Parameters:
+ *  field               : field of EduOM_Stats
+ *  Four n              : value added
+ */
+#define STAT_ADD(field, n)  (THREAD_STATS()->stats.field += (n))
+
+/* Macro: STAT_BEGIN(op)
+ * Description: count a call of the operation; the following pins of the thread are counted for it
+ * Parameter:
+ *  Four op             : STAT_OP_CREATE ~ STAT_OP_FILE
+ */
+#define STAT_BEGIN(op) \
+	(THREAD_STATS()->curOp = (op), eduom_threadStats->stats.calls[op]++)
+
+/* Macro: STAT_CONTINUE(op)
+ * Description: count the following pins of the thread for the operation without counting a call;
+ *              for the threads working for a call counted by another thread
+ * Parameter:
+ *  Four op             : STAT_OP_CREATE ~ STAT_OP_FILE
+ */
+#define STAT_CONTINUE(op)   (THREAD_STATS()->curOp = (op))
+
+/* Macro: STAT_PIN()
+ * Description: count a pin for the current operation of the calling thread
+ */
+#define STAT_PIN() \
+	(THREAD_STATS()->stats.pins[eduom_threadStats->curOp]++)
+
+
+/*
+ * The latency histograms are recorded only if EDUOM_LATENCY is defined at the
+ * compile time; otherwise LAT_BEGIN() is empty and EDUOM_GETTRAIN() is
+ * BfM_GetTrain() itself, so the functions measured run as they are.
+ */
+#ifdef EDUOM_LATENCY
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define LAT_NOW()   ((unsigned long)__rdtsc())
+#else
+#define LAT_NOW()   eduom_LatencyClock()
+#endif
+
+/* Macro: LAT_BEGIN(op)
+ * Description: record the latency from here to the return of the function;
+ *              it must follow the declarations of the function
+ * Parameter:
+ *  Four op             : LAT_CREATEOBJECT ~ LAT_WRITEOBJECT
+ */
+#define LAT_BEGIN(op) \
+	LatencyTimer eduom_latTimer __attribute__((cleanup(eduom_LatencyEnd))) = { (op), LAT_NOW() }
+
+/* Macro: EDUOM_GETTRAIN(pid, buf, type)
+ * Description: BfM_GetTrain() whose latency is recorded as a hit or a miss
+ */
+#define EDUOM_GETTRAIN(pid, buf, type)  eduom_GetTrainTimed(pid, buf, type)
+
+#else
+
+#define LAT_BEGIN(op)
+#define EDUOM_GETTRAIN(pid, buf, type)  BfM_GetTrain(pid, buf, type)
+
+#endif /* EDUOM_LATENCY */
+
+
 /* constant macro for the empty slot */
 /* The empty slots have EMPTYSLOT with the 'offset' */
 #define EMPTYSLOT       -1
 
+/*
+ * The 'reserved' field of the slotted page header keeps the lowest empty slot
+ * of the page so that an empty slot can be reused without scanning the slot
+ * array. The field is encoded so that 0, the value of a page not maintained
+ * by EduOM, means the hint is unknown:
+ *   0      : unknown; the slot array should be scanned
+ *   NIL    : there is no empty slot in the slot array
+ *   n > 0  : slot n-1 is the lowest empty slot
+ */
+#define SP_EMPTYSLOT_UNKNOWN    -2
+#define SP_EMPTYSLOT_NONE       NIL
+
+/* Macro: SP_EMPTYSLOT_HINT(p)
+ * Description: return the lowest empty slot kept in the page header
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: (Two) slot number, SP_EMPTYSLOT_NONE, or SP_EMPTYSLOT_UNKNOWN
+ */
+#define SP_EMPTYSLOT_HINT(p) \
+	(((p)->header.reserved == 0) ? SP_EMPTYSLOT_UNKNOWN : \
+	 (((p)->header.reserved == NIL) ? SP_EMPTYSLOT_NONE : (Two)((p)->header.reserved - 1)))
+
+/* Macro: SET_SP_EMPTYSLOT_HINT(p, s)
+ * Description: keep the lowest empty slot in the page header
+ * Parameters:
+ *  SlottedPage *p      : (OUT) pointer to the page
+ *  Two s               : slot number, SP_EMPTYSLOT_NONE, or SP_EMPTYSLOT_UNKNOWN
+ */
+#define SET_SP_EMPTYSLOT_HINT(p, s) \
+	((p)->header.reserved = (((s) == SP_EMPTYSLOT_UNKNOWN) ? 0 : \
+	                         (((s) == SP_EMPTYSLOT_NONE) ? NIL : (s) + 1)))
+
 /* Macro: IS_VALID_OBJECTID(oid, s_page)
  * Description: check whether the object ID given as a parameter is valid or not
  * Parameters:
@@ -116,11 +804,20 @@ typedef struct {
  * Returns: TRUE(1) if oid is valid, otherwise FALSE(0)
  */
 #define IS_VALID_OBJECTID(oid, s_page) \
-	(((s_page->slot[-(oid)->slotNo].offset == EMPTYSLOT) || \
-	  (s_page->slot[-(oid)->slotNo].unique != (oid)->unique)) ? FALSE : TRUE)
+	(((SP_OFFSET(s_page, (oid)->slotNo) == EMPTYSLOT) || \
+	  (SP_UNIQUE(s_page, (oid)->slotNo) != (oid)->unique)) ? FALSE : TRUE)
 
 #define LRGOBJ_THRESHOLD (PAGESIZE - SP_FIXED - sizeof(ObjectHdr))
 
+/*
+ * An update which finds no room for the object in its page moves the data
+ * to another page and leaves a stub in the slot of the object, so that the
+ * ObjectID does not change. The stub has P_MOVED and keeps the ObjectID of
+ * the moved data, which has P_FORWARDED; a stub always refers to the data
+ * directly, so an object is reached with at most one hop.
+ */
+#define FORWARD_STUBLEN ((CONSTANT_CASTING_TYPE)sizeof(ObjectID))
+
 /* Macro: GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry)
  * Description: get the information about the data file(sm_CatOverlayForData) residing in the catalog object for data file
  * Parameters:
@@ -136,11 +833,59 @@ typedef struct {
 }
 
 
+/*@
+ * Global Variables
+ */
+extern __thread ThreadStats *eduom_threadStats; /* counters of the calling thread */
+extern CompactPolicy eduom_compactPolicy;	/* the compaction policy */
+extern Boolean eduom_useAppendPage;	/* TRUE if the append page of a map is used */
+
+
 /*@
  * Function Prototypes
  */
 /* internal function prototypes */
 Four eduom_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, ObjectID*);
+Four eduom_SelectPage(ObjectID*, FreeSpaceMap*, PageID*, ObjectHdr*, Four, Four, PageID*, SlottedPage**);
+Four eduom_AllocPage(ObjectID*, sm_CatOverlayForData*, FreeSpaceMap*, PageID*, Boolean, PageID*, SlottedPage**);
+Four eduom_DestroyObject(ObjectID*, ObjectID*, Boolean, Pool*, DeallocListElem*);
+Four eduom_FixObjectForRead(ObjectID*, PageID*, SlottedPage**, BufferFrontEntry**, Four*, ObjectHdr*);
+Four eduom_FixForwardedObject(SlottedPage*, Four, PageID*, SlottedPage**, BufferFrontEntry**, Four*, ObjectHdr*);
+Four eduom_GetForwardedHeader(SlottedPage*, Four, ObjectHdr*);
+Two eduom_FindEmptySlot(SlottedPage*);
+void eduom_TakeSlot(SlottedPage*, Two);
+Four eduom_GetUnique(PageID*, SlottedPage*, Unique*);
+Four eduom_GetFreeSpaceMap(ObjectID*, sm_CatOverlayForData*, FreeSpaceMap**);
+Four eduom_FsmSetPage(FreeSpaceMap*, PageNo, Four);
+Four eduom_FsmSetClass(FreeSpaceMap*, PageNo, Four);
+Four eduom_FsmSearch(FreeSpaceMap*, Four, Four, PageNo*);
+void eduom_FsmSetAppendPage(FreeSpaceMap*, PageNo);
+void eduom_FsmInvalidate(ObjectID*);
+Boolean eduom_MayCompact(SlottedPage*, Four);
+void eduom_DeferCompaction(ObjectID*, PageID*, SlottedPage*, Boolean);
+Four eduom_ObjectSize(Four, ObjectHdr*);
+Four eduom_GetObject(SlottedPage*, Four, ObjectHdr*, char**);
+Four eduom_PutObject(SlottedPage*, Four, ObjectHdr*, char*);
+Four eduom_PageObjectSize(SlottedPage*, ObjectHdr*, char*);
+void eduom_ReadData(SlottedPage*, Four, Four, Four, char*);
+void eduom_InitDataArea(SlottedPage*);
+void eduom_StartPrefix(SlottedPage*, char*, Four);
+Boolean eduom_ClearStaleFormat(SlottedPage*);
+Four eduom_GetCatalogEntry(ObjectID*, sm_CatOverlayForData**);
+void eduom_CatalogEntryChanged(ObjectID*);
+Four eduom_FixPageForRead(PageID*, SlottedPage**, BufferFrontEntry**);
+Four eduom_UnfixPageForRead(PageID*, BufferFrontEntry*);
+Boolean eduom_IsMappedVolume(VolNo);
+Four eduom_GetPageForRead(PageID*, SlottedPage**);
+Four eduom_FreePageForRead(PageID*);
+Four eduom_AdviseMappedPages(PageID*, Four);
+Four eduom_PrefetchPages(PageID*, Four);
+ThreadStats *eduom_AllocThreadStats(void);
+#ifdef EDUOM_LATENCY
+void eduom_LatencyEnd(LatencyTimer*);
+unsigned long eduom_LatencyClock(void);
+Four eduom_GetTrainTimed(TrainID*, char**, Four);
+#endif
 
 Four om_FileMapAddPage(ObjectID*, PageID*, PageID*);
 Four om_FileMapDeletePage(ObjectID*, PageID*);
@@ -124,6 +124,17 @@ typedef struct {        /* ObjectID is used accross the volumes */
 #define MAKE_OBJECTID(oid, v, p, s, u) \
 	(oid).volNo = (v), (oid).pageNo = (p), (oid).slotNo = (s), (oid).unique = (u)
 
+/* Macro: EQUAL_OBJECTID(x, y)
+ * Description: check whether the two object IDs are equal
+ * Parameters:
+ *  ObjectID x      : object ID
+ *  ObjectID y      : object ID
+ * Returns: TRUE(1) if x is equal to y, otherwise FALSE(0)
+ */
+#define EQUAL_OBJECTID(x, y) \
+	(((x).volNo == (y).volNo && (x).pageNo == (y).pageNo && \
+	  (x).slotNo == (y).slotNo && (x).unique == (y).unique) ? TRUE:FALSE)
+
 
 /*
  * Definition for Logical ID
@@ -334,6 +345,7 @@ typedef struct _DeallocListElem DeallocListElem;
  */
 #undef MAX
 #define MAX(a,b) (((a) >= (b)) ? (a):(b))
+#define MIN(a,b) (((a) <= (b)) ? (a):(b))
 
 
 /*
@@ -47,3 +47,12 @@
 #define eCANTALLOCEXTENT_BL_OM                   ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,9)
 #define NUM_ERRORS_OM_ERR_BASE                   10
 #define eNOTSUPPORTED_EDUOM			             ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,11)
+#define eTHREADFAILED_EDUOM			             ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,12)
+#define ePAGEFIXED_EDUOM			             ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,13)
+#define eMEMORYALLOCERR_EDUOM			             ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,14)
+#define eMAPFAILED_EDUOM			             ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,15)
+#define eTOOMANYFILES_EDUOM			             ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,16)
+#define eFILENOTEMPTY_EDUOM			             ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,17)
+#define eNOSPACEFORSTUB_EDUOM			             ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,18)
+#define eVOLUMEMAPPED_EDUOM			             ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,19)
+#define ePREFETCHFAILED_EDUOM			             ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,20)
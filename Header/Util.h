@@ -27,9 +27,13 @@
 
 
 #include "Util_pool.h"      /* to get pool */
+#include "Util_varArray.h"  /* to get VarArray */
 
 
 Four Util_getElementFromPool(Pool*, void*);
+Four Util_initVarArray(VarArray*, Four, Four);
+Four Util_reallocVarArray(VarArray*, Four, Four);
+Four Util_finalVarArray(VarArray*);
 
 
 #endif /* _UTIL_H_ */
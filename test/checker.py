@@ -59,18 +59,25 @@ def checkUntilNewTest(sol_file, out_file):
 
 # Settings
 output_file_path = sys.argv[1]
+solution_file_path = sys.argv[2] if len(sys.argv) > 2 else "solution.txt"
 
-solution_file = open("solution.txt", 'r')
+test_list = ["1_1", "1_2", "1_3", "1_4", "1_5", "1_6", "1_7", "2_1", "2_2", "3_1", "3_2", "3_3", "4_1", "4_2", "4_3"]
+score_list = [5, 5, 5, 5, 5, 5, 10, 5, 5, 7, 8, 10, 7, 8, 10] 
+
+## Another solution file is scored one point per test found in it
+if len(sys.argv) > 2:
+    with open(solution_file_path, 'r') as f:
+        test_list = [line.split()[1] for line in f if line.startswith("*Test ")]
+    score_list = [1] * len(test_list)
+
+solution_file = open(solution_file_path, 'r')
 output_file = open(output_file_path, 'r')
 
 score = 0
 
 # Actual run
-readUntilContains(solution_file, "*Test 1_1")
-readUntilContains(output_file, "*Test 1_1")
-
-test_list = ["1_1", "1_2", "1_3", "1_4", "1_5", "1_6", "1_7", "2_1", "2_2", "3_1", "3_2", "3_3", "4_1", "4_2", "4_3"]
-score_list = [5, 5, 5, 5, 5, 5, 10, 5, 5, 7, 8, 10, 7, 8, 10] 
+readUntilContains(solution_file, "*Test " + test_list[0])
+readUntilContains(output_file, "*Test " + test_list[0])
 
 for test_num in range(len(test_list)):
     test = test_list[test_num]